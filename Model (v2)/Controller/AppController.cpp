@@ -1,15 +1,20 @@
 #include "AppController.h"
 
+#include "Model/Service/EditLog.h"
+#include "Model/Service/TranscriptBundle.h"
+
 #include <QDir>
 #include <QFileInfo>
 #include <QUrl>
 #include <QDebug>
+#include <QRegularExpression>
 
 namespace Controller {
 
 using Model::Data::Transcript;
 using Model::Service::TranscriptSearch;
 using Model::Service::TranscriptEditor;
+using Model::Service::EditLog;
 
 
 AppController::AppController(QObject* parent)
@@ -18,6 +23,13 @@ AppController::AppController(QObject* parent)
     m_editor(nullptr),
     m_exporter(),
     m_currentIndex(-1),
+    m_searchThread(new QThread(this)),
+    m_searchWorker(new SearchWorker()),
+    m_saveThread(new QThread(this)),
+    m_saveWorker(new SaveWorker()),
+    m_autosaveTimer(new QTimer(this)),
+    m_rootWatcher(new QFileSystemWatcher(this)),
+    m_rescanTimer(new QTimer(this)),
     m_mediaPlayer(new QMediaPlayer(this)),
     m_audioOutput(new QAudioOutput(this)),
     m_durationMs(0)
@@ -30,11 +42,62 @@ AppController::AppController(QObject* parent)
             this, &AppController::handleMediaDurationChanged);
     connect(m_mediaPlayer, &QMediaPlayer::playbackStateChanged,
             this, &AppController::handleMediaPlaybackStateChanged);
+
+    // Background search: the worker lives on its own thread and is deleted with it
+    m_searchSession.setTrigramIndex(&m_trigramIndex);
+    m_searchSession.setSegmentStore(&m_segmentStore);
+
+    m_searchWorker->moveToThread(m_searchThread);
+    connect(m_searchThread, &QThread::finished,
+            m_searchWorker, &QObject::deleteLater);
+    connect(m_searchWorker, &SearchWorker::resultsPartial,
+            this, &AppController::handleSearchResultsPartial);
+    connect(m_searchWorker, &SearchWorker::finished,
+            this, &AppController::handleSearchFinished);
+    m_searchThread->start();
+
+    // Saves: written one at a time on their own thread so the UI never waits on disk I/O
+    m_saveWorker->moveToThread(m_saveThread);
+    connect(m_saveThread, &QThread::finished,
+            m_saveWorker, &QObject::deleteLater);
+    connect(m_saveWorker, &SaveWorker::finished,
+            this, &AppController::handleSaveFinished);
+    connect(m_saveWorker, &SaveWorker::logFailed,
+            this, &AppController::handleLogFailed);
+    connect(m_saveWorker, &SaveWorker::bundleExported,
+            this, &AppController::handleBundleExported);
+    m_saveThread->start();
+
+    m_autosaveTimer->setSingleShot(true);
+    connect(m_autosaveTimer, &QTimer::timeout,
+            this, &AppController::handleAutosaveTimeout);
+
+    // A save or copy fires several watcher signals; rescan once they stop
+    m_rescanTimer->setSingleShot(true);
+    m_rescanTimer->setInterval(RescanDelayMs);
+    connect(m_rootWatcher, &QFileSystemWatcher::directoryChanged,
+            m_rescanTimer, qOverload<>(&QTimer::start));
+    connect(m_rootWatcher, &QFileSystemWatcher::fileChanged,
+            m_rescanTimer, qOverload<>(&QTimer::start));
+    connect(m_rescanTimer, &QTimer::timeout,
+            this, &AppController::handleRescanTimeout);
 }
 
 
 AppController::~AppController() {
 
+    cancelSearch();
+    m_searchThread->quit();
+    m_searchThread->wait();
+
+    m_autosaveTimer->stop();
+    m_rescanTimer->stop();
+
+    // Jobs run in order: once this no-op has run, every queued save is on disk
+    QMetaObject::invokeMethod(m_saveWorker, [] {}, Qt::BlockingQueuedConnection);
+    m_saveThread->quit();
+    m_saveThread->wait();
+
     delete m_editor;
     m_editor = nullptr;
 }
@@ -52,10 +115,18 @@ QString AppController::rootDirectory() const {
 
 bool AppController::loadTranscripts(QString* errorMessage) {
 
-    const bool ok = m_manager.loadAllFromRoot(errorMessage);
+    const bool ok = m_manager.hasDatabase() ? m_manager.loadAllFromDatabase(errorMessage)
+                                            : m_manager.loadAllFromRoot(errorMessage);
     if (!ok)
         return false;
 
+    // Before any editor exists: the replayed log tail is part of the loaded state
+    m_logTailBytes.clear();
+    m_loggedGeneration.clear();
+    QStringList recovered;
+    if (!m_manager.hasDatabase())
+        replayEditLogs(recovered);
+
     // Select first transcript if available
     if (m_manager.transcriptCount() > 0) {
         m_currentIndex = 0;
@@ -70,11 +141,191 @@ bool AppController::loadTranscripts(QString* errorMessage) {
         emit currentTranscriptChanged(nullptr);
     }
 
+    updateDirtyCount();
+    updateWatchedPaths();
     emit transcriptsReloaded();
+
+    if (!recovered.isEmpty())
+        emit transcriptsRecovered(recovered);
     return true;
 }
 
 
+bool AppController::openDatabase(const QString& path, QString* errorMessage) {
+
+    if (!m_manager.openDatabase(path, errorMessage))
+        return false;
+
+    return loadTranscripts(errorMessage);
+}
+
+bool AppController::hasDatabase() const {
+
+    return m_manager.hasDatabase();
+}
+
+void AppController::setMemoryBudget(qsizetype bytes) {
+
+    m_manager.setMemoryBudget(bytes);
+    m_manager.enforceMemoryBudget(m_currentIndex);
+}
+
+qsizetype AppController::transcriptResidentBytes(int index) const {
+
+    return m_manager.residentBytes(index);
+}
+
+void AppController::setWatchRoot(bool enabled) {
+
+    m_watchRoot = enabled;
+    if (!enabled)
+        m_rescanTimer->stop();
+
+    updateWatchedPaths();
+}
+
+bool AppController::watchRoot() const {
+
+    return m_watchRoot;
+}
+
+bool AppController::rescanRoot(QString* errorMessage) {
+
+    const Transcript* before = currentTranscript();
+    const int previousIndex = m_currentIndex;
+
+    Model::Service::TranscriptManager::RootChanges changes;
+    QString error;
+    const bool ok = m_manager.rescanRoot(changes, &error);
+    if (errorMessage)
+        *errorMessage = error;
+    if (!ok)
+        return false;
+
+    for (const QString& id : changes.removedIDs) {
+        m_logTailBytes.remove(id);
+        m_loggedGeneration.remove(id);
+    }
+
+    // Where the current transcript went (removals come in descending order)
+    int newIndex = previousIndex;
+    bool currentGone = false;
+    for (int removed : changes.removed) {
+        if (removed == newIndex)
+            currentGone = true;
+        else if (removed < newIndex)
+            --newIndex;
+    }
+
+    const int count = m_manager.transcriptCount();
+    const bool selectionChanged = currentGone || (previousIndex < 0 && count > 0);
+
+    if (currentGone)
+        newIndex = count > 0 ? qMin(newIndex, count - 1) : -1;
+    else if (previousIndex < 0)
+        newIndex = count > 0 ? 0 : -1;
+
+    m_currentIndex = newIndex;
+
+    // Before any signal: loaded files may still have edits in their logs
+    QStringList recovered;
+    for (int index : changes.reloaded) {
+        if (Transcript* t = m_manager.transcriptAt(index))
+            replayEditLog(*t, recovered);
+    }
+    for (int index : changes.added) {
+        if (Transcript* t = m_manager.transcriptAt(index))
+            replayEditLog(*t, recovered);
+    }
+
+    bool currentChanged = false;
+    Transcript* t = currentTranscript();
+
+    if (selectionChanged || changes.reloaded.contains(m_currentIndex)) {
+        updateMediaForCurrentTranscript();
+        recreateEditorForCurrentTranscript();
+        currentChanged = true;
+    }
+    else if (t && t != before) {
+        // Same transcript, moved by the list changes: keep its undo history
+        if (m_editor)
+            m_editor->rebind(*t);
+        cancelSearch();
+        m_searchSession.reset();
+        m_segmentStore.clear();
+        currentChanged = true;
+    }
+
+    for (int index : changes.removed)
+        emit transcriptRemoved(index);
+    for (int index : changes.reloaded)
+        emit transcriptReloaded(index);
+    for (int index : changes.added)
+        emit transcriptAdded(index);
+
+    if (currentChanged)
+        emit currentTranscriptChanged(currentTranscript());
+
+    updateDirtyCount();
+    m_manager.enforceMemoryBudget(m_currentIndex);
+    updateWatchedPaths();
+
+    if (!changes.conflicts.isEmpty())
+        emit errorOccurred(tr("Changed on disk, but kept with their unsaved edits "
+                              "(saving them overwrites the files):\n%1").arg(changes.conflicts.join(QLatin1Char('\n'))));
+
+    if (!recovered.isEmpty())
+        emit transcriptsRecovered(recovered);
+    return true;
+}
+
+void AppController::handleRescanTimeout() {
+
+    if (!m_watchRoot)
+        return;
+
+    QString error;
+    rescanRoot(&error);
+    if (!error.isEmpty())
+        emit errorOccurred(error);
+}
+
+void AppController::updateWatchedPaths() {
+
+    const QStringList watched = m_rootWatcher->directories() + m_rootWatcher->files();
+    if (!watched.isEmpty())
+        m_rootWatcher->removePaths(watched);
+
+    if (!m_watchRoot || m_manager.hasDatabase() || m_manager.rootDirectory().isEmpty())
+        return;
+
+    const QString rootPath = QDir(m_manager.rootDirectory()).absolutePath();
+    QStringList paths { rootPath };
+
+    for (int i = 0; i < m_manager.transcriptCount(); ++i) {
+        const QString source = m_manager.sourcePath(i);
+        if (source.isEmpty() || QFileInfo(source).absolutePath() != rootPath)
+            continue;
+
+        paths << source;
+
+        // Files rewritten in place change no directory entry
+        const Transcript* t = m_manager.transcriptAt(i);
+        if (t->isBundle())
+            continue;
+
+        for (const QString& file : { QDir(source).filePath(QStringLiteral("meta.json")),
+                                     t->editablePath, t->referencePath }) {
+            if (!file.isEmpty() && QFileInfo::exists(file))
+                paths << file;
+        }
+    }
+
+    paths.removeDuplicates();
+    m_rootWatcher->addPaths(paths);
+}
+
+
 int AppController::transcriptCount() const {
 
     return m_manager.transcriptCount();
@@ -169,49 +420,147 @@ const TranscriptEditor* AppController::editor() const {
     return m_editor;
 }
 
+Model::Data::TranscriptVersion AppController::currentVersion() const {
+
+    if (m_editor)
+        return m_editor->currentVersion();
+
+    const Transcript* t = currentTranscript();
+    return t ? Model::Data::TranscriptVersion(*t) : Model::Data::TranscriptVersion();
+}
+
+int AppController::segmentIndexForID(quint64 segmentID) const {
+
+    return m_editor ? m_editor->indexOfSegment(segmentID) : -1;
+}
+
+quint64 AppController::segmentIDAt(int index) const {
+
+    return m_editor ? m_editor->segmentIDAt(index) : 0;
+}
+
 
 // ==== Search helpers ====
 
 QVector<int> AppController::searchSegments(const QString& pattern,
                                            const QStringList& speakerFilter,
-                                           Qt::CaseSensitivity cs) const {
+                                           Qt::CaseSensitivity cs,
+                                           bool accentInsensitive) const {
 
     const Transcript* t = currentTranscript();
     if (!t || pattern.trimmed().isEmpty())
         return {};
 
-    TranscriptSearch search(*t);
+    ensureTrigramIndex();
+    ensureSegmentStore();
+    return m_searchSession.search(*t, pattern, speakerFilter, cs, accentInsensitive);
+}
+
+bool AppController::searchAllTranscripts(const QString& text,
+                                         const QString& speakerID,
+                                         QVector<Model::Service::TranscriptDatabase::SegmentHit>& outHits,
+                                         QString* errorMessage) {
+    outHits.clear();
 
-    if (speakerFilter.isEmpty())
-        return search.findSegmentsContaining(pattern, cs);
+    if (!m_manager.hasDatabase()) {
+        if (errorMessage)
+            *errorMessage = tr("Searching all transcripts needs a transcript database.");
+        return false;
+    }
 
-    return search.findBySpeakersAndText(speakerFilter, pattern, cs);
+    return m_manager.database().search(text, speakerID, outHits, 1000, errorMessage);
 }
 
 int AppController::searchNext(const QString& pattern,
                               const QStringList& speakerFilter,
                               int fromIndex,
-                              Qt::CaseSensitivity cs) const {
+                              Qt::CaseSensitivity cs,
+                              bool wrapAround,
+                              bool accentInsensitive) const {
 
     const Transcript* t = currentTranscript();
     if (!t || pattern.trimmed().isEmpty())
         return -1;
 
     TranscriptSearch search(*t);
+    search.setAccentInsensitive(accentInsensitive);
 
-    if (speakerFilter.isEmpty()) {
-        return search.findNext(pattern, fromIndex, cs);
-    }
+    // Stops at the first hit after fromIndex instead of collecting all matches
+    TranscriptSearch::MatchIterator it = search.matches(pattern, speakerFilter, cs, wrapAround);
+    it.seek(fromIndex);
+    return it.next();
+}
+
+int AppController::searchPrevious(const QString& pattern,
+                                  const QStringList& speakerFilter,
+                                  int fromIndex,
+                                  Qt::CaseSensitivity cs,
+                                  bool wrapAround,
+                                  bool accentInsensitive) const {
+
+    const Transcript* t = currentTranscript();
+    if (!t || pattern.trimmed().isEmpty())
+        return -1;
+
+    TranscriptSearch search(*t);
+    search.setAccentInsensitive(accentInsensitive);
+
+    TranscriptSearch::MatchIterator it = search.matches(pattern, speakerFilter, cs, wrapAround);
+    it.seek(fromIndex);
+    return it.previous();
+}
+
+quint64 AppController::requestSearch(const QString& pattern,
+                                     const QStringList& speakerFilter,
+                                     Qt::CaseSensitivity cs,
+                                     bool useRegex,
+                                     bool accentInsensitive) {
 
-    // With speaker filter: search in the filtered list for first index > fromIndex
-    const QVector<int> matches = search.findBySpeakersAndText(speakerFilter, pattern, cs);
+    cancelSearch();
 
-    for (int ind : matches) {
-        if (ind > fromIndex)
-            return ind;
+    const Transcript* t = currentTranscript();
+    if (!t || pattern.trimmed().isEmpty())
+        return 0;
+
+    if (useRegex && !QRegularExpression(pattern).isValid()) {
+        emit errorOccurred(tr("Invalid regular expression: %1").arg(pattern));
+        return 0;
     }
-    return -1;
 
+    SearchQuery query;
+    query.id = ++m_lastSearchID;
+    query.pattern = pattern;
+    query.speakerFilter = speakerFilter;
+    query.cs = cs;
+    query.useRegex = useRegex;
+    query.accentInsensitive = accentInsensitive;
+
+    // Narrow the worker down to segments holding the required trigrams
+    ensureTrigramIndex();
+    query.restrictToCandidates = useRegex
+        ? m_trigramIndex.candidatesForRegex(pattern, query.candidates)
+        : m_trigramIndex.candidatesForLiteral(pattern, query.candidates);
+
+    m_searchCancelToken = SearchCancelToken::create(0);
+
+    // Immutable version: edits on the GUI thread detach, the worker keeps
+    // reading the state as of this call.
+    const Model::Data::TranscriptVersion snapshot = currentVersion();
+    const SearchCancelToken token = m_searchCancelToken;
+    SearchWorker* worker = m_searchWorker;
+
+    QMetaObject::invokeMethod(m_searchWorker, [worker, query, snapshot, token]() {
+        worker->run(query, snapshot.transcript(), token);
+    }, Qt::QueuedConnection);
+
+    return query.id;
+}
+
+void AppController::cancelSearch() {
+
+    if (m_searchCancelToken)
+        m_searchCancelToken->storeRelaxed(1);
+    m_searchCancelToken.reset();
 }
 
 
@@ -240,6 +589,7 @@ void AppController::requestUndo() {
         return;
 
     m_editor->undo();
+    applyLastEditToSearch();
     emit transcriptContentChanged(currentTranscript());
     emitUndoRedoAvailability();
 }
@@ -250,6 +600,7 @@ void AppController::requestRedo() {
         return;
 
     m_editor->redo();
+    applyLastEditToSearch();
     emit transcriptContentChanged(currentTranscript());
     emitUndoRedoAvailability();
 }
@@ -260,6 +611,21 @@ void AppController::requestSetSegmentText(int index, const QString& text) {
         return;
 
     m_editor->setSegmentText(index, text);
+    applyLastEditToSearch();
+    emit transcriptContentChanged(currentTranscript());
+    emitUndoRedoAvailability();
+}
+
+void AppController::requestSpliceSegmentText(int index,
+                                             int position,
+                                             int charsRemoved,
+                                             const QString& insertedText) {
+
+    if (!m_editor)
+        return;
+
+    m_editor->spliceSegmentText(index, position, charsRemoved, insertedText);
+    applyLastEditToSearch();
     emit transcriptContentChanged(currentTranscript());
     emitUndoRedoAvailability();
 }
@@ -270,6 +636,7 @@ void AppController::requestAppendToSegment(int index, const QString& text) {
         return;
 
     m_editor->appendToSegment(index, text);
+    applyLastEditToSearch();
     emit transcriptContentChanged(currentTranscript());
     emitUndoRedoAvailability();
 }
@@ -280,6 +647,7 @@ void AppController::requestSplitSegment(int index, int splitPos) {
         return;
 
     m_editor->splitSegment(index, splitPos);
+    applyLastEditToSearch();
     emit transcriptContentChanged(currentTranscript());
     emitUndoRedoAvailability();
 }
@@ -297,6 +665,7 @@ bool AppController::requestSplitSegmentWithSpeakers(int index,
     if (newIndex < 0)
         return false;
 
+    applyLastEditToSearch();
     emit transcriptContentChanged(currentTranscript());
     emitUndoRedoAvailability();
     return true;
@@ -309,6 +678,7 @@ void AppController::requestMergeWithNext(int index) {
         return;
 
     m_editor->mergeWithNext(index);
+    applyLastEditToSearch();
     emit transcriptContentChanged(currentTranscript());
     emitUndoRedoAvailability();
 }
@@ -321,9 +691,8 @@ void AppController::requestInsertSegment(int index,
         return;
 
     // Allow empty text; the user will type later.
-    Model::Data::Segment seg(speakerID, text);
-
-    m_editor->insertSegment(index, seg);
+    m_editor->insertSegment(index, speakerID, text);
+    applyLastEditToSearch();
     emit transcriptContentChanged(currentTranscript());
     emitUndoRedoAvailability();
 }
@@ -334,6 +703,7 @@ void AppController::requestDeleteSegment(int index) {
         return;
 
     m_editor->deleteSegment(index);
+    applyLastEditToSearch();
     emit transcriptContentChanged(currentTranscript());
     emitUndoRedoAvailability();
 }
@@ -344,6 +714,7 @@ void AppController::requestMoveSegment(int fromIndex, int toIndex) {
         return;
 
     m_editor->moveSegment(fromIndex, toIndex);
+    applyLastEditToSearch();
     emit transcriptContentChanged(currentTranscript());
     emitUndoRedoAvailability();
 }
@@ -354,6 +725,7 @@ void AppController::requestSwapSegments(int indexA, int indexB) {
         return;
 
     m_editor->swapSegments(indexA, indexB);
+    applyLastEditToSearch();
     emit transcriptContentChanged(currentTranscript());
     emitUndoRedoAvailability();
 }
@@ -364,6 +736,7 @@ void AppController::requestChangeSegmentSpeaker(int index, const QString& speake
         return;
 
     m_editor->setSegmentSpeaker(index, speakerID);
+    applyLastEditToSearch();
     emit transcriptContentChanged(currentTranscript());
     emitUndoRedoAvailability();
 }
@@ -374,6 +747,7 @@ void AppController::requestRenameSpeakerGlobal(const QString& oldID, const QStri
         return;
 
     m_editor->renameSpeakerGlobal(oldID, newID);
+    applyLastEditToSearch();
     emit transcriptContentChanged(currentTranscript());
     emitUndoRedoAvailability();
 }
@@ -386,6 +760,7 @@ void AppController::requestReplaceAll(const QString& pattern,
         return;
 
     m_editor->replaceAll(pattern, replacement, cs);
+    applyLastEditToSearch();
     emit transcriptContentChanged(currentTranscript());
     emitUndoRedoAvailability();
 }
@@ -398,6 +773,7 @@ void AppController::requestReplaceInSegment(int index,
         return;
 
     m_editor->replaceInSegment(index, from, to, cs);
+    applyLastEditToSearch();
     emit transcriptContentChanged(currentTranscript());
     emitUndoRedoAvailability();
 }
@@ -408,11 +784,74 @@ void AppController::requestNormalizeWhitespaceAll() {
         return;
 
     m_editor->normalizeWhitespaceAll();
+    applyLastEditToSearch();
     emit transcriptContentChanged(currentTranscript());
     emitUndoRedoAvailability();
 }
 
 
+// ==== Editing by stable segment ID ====
+
+void AppController::requestSetSegmentTextByID(quint64 segmentID, const QString& text) {
+
+    const int index = segmentIndexForID(segmentID);
+    if (index >= 0)
+        requestSetSegmentText(index, text);
+}
+
+void AppController::requestSpliceSegmentTextByID(quint64 segmentID,
+                                                 int position,
+                                                 int charsRemoved,
+                                                 const QString& insertedText) {
+
+    const int index = segmentIndexForID(segmentID);
+    if (index >= 0)
+        requestSpliceSegmentText(index, position, charsRemoved, insertedText);
+}
+
+void AppController::requestChangeSegmentSpeakerByID(quint64 segmentID, const QString& speakerID) {
+
+    const int index = segmentIndexForID(segmentID);
+    if (index >= 0)
+        requestChangeSegmentSpeaker(index, speakerID);
+}
+
+bool AppController::requestSplitSegmentWithSpeakersByID(quint64 segmentID,
+                                                        int splitPos,
+                                                        const QString& speakerFirst,
+                                                        const QString& speakerSecond) {
+
+    const int index = segmentIndexForID(segmentID);
+    if (index < 0)
+        return false;
+
+    return requestSplitSegmentWithSpeakers(index, splitPos, speakerFirst, speakerSecond);
+}
+
+void AppController::requestMergeWithNextByID(quint64 segmentID) {
+
+    const int index = segmentIndexForID(segmentID);
+    if (index >= 0)
+        requestMergeWithNext(index);
+}
+
+void AppController::requestInsertSegmentAfterID(quint64 segmentID,
+                                                const QString& speakerID,
+                                                const QString& text) {
+
+    const int index = segmentIndexForID(segmentID);
+    if (index >= 0)
+        requestInsertSegment(index + 1, speakerID, text);
+}
+
+void AppController::requestDeleteSegmentByID(quint64 segmentID) {
+
+    const int index = segmentIndexForID(segmentID);
+    if (index >= 0)
+        requestDeleteSegment(index);
+}
+
+
 
 // ==== Import / export ====
 
@@ -430,7 +869,19 @@ bool AppController::requestImportTranscript(const QString& folderPath,
         return false;
     }
 
-    // We successfully imported a new transcript
+    updateWatchedPaths();
+
+    // We successfully imported a new transcript; a folder imported before may have a log
+    Transcript* imported = m_manager.hasDatabase() ? nullptr : m_manager.transcriptAt(newIndex);
+    if (imported) {
+        EditLog::ReplayResult result;
+        QString error;
+        if (EditLog::replay(*imported, &result, &error))
+            markLogInSync(*imported, result.tailBytes);
+        else
+            emit errorOccurred(error);
+    }
+
     emit transcriptsReloaded();
 
     m_currentIndex = newIndex;
@@ -447,41 +898,370 @@ bool AppController::requestImportTranscript(const QString& folderPath,
 
 void AppController::requestSaveCurrent(bool exportReference) {
 
-    Transcript* t = currentTranscript();
+    const Transcript* t = currentTranscript();
     if (!t)
         return;
 
     QString error;
-    if (!m_exporter.exportAll(*t, exportReference, &error)) {
+    if (!queueSave(*t, exportReference, &error)) {
         emit errorOccurred(error.isEmpty()
                                ? tr("Failed to save current transcript.")
                                : error);
+    }
+}
+
+void AppController::requestSaveAll(bool exportReference) {
+
+    queueDirtySaves(exportReference);
+}
+
+void AppController::requestExportBundle(const QString& bundlePath, bool includeAudio) {
+
+    const Transcript* t = currentTranscript();
+    if (!t)
+        return;
+
+    QString error;
+    Model::Service::TranscriptBundle::Plan plan;
+    if (!Model::Service::TranscriptBundle::prepare(*t, bundlePath, includeAudio, plan, &error)) {
+        emit errorOccurred(error);
         return;
     }
 
-    emit saveCompleted(t);
+    QMetaObject::invokeMethod(m_saveWorker, [worker = m_saveWorker, plan] {
+        worker->exportBundle(plan);
+    }, Qt::QueuedConnection);
 }
 
-void AppController::requestSaveAll(bool exportReference) {
+bool AppController::requestExportToFolder(const QString& folderPath, QString* errorMessage) {
+
+    QString error;
+    if (!m_manager.exportTranscriptToFolder(m_currentIndex, folderPath, &error)) {
+        emit errorOccurred(error);
+        if (errorMessage)
+            *errorMessage = error;
+        return false;
+    }
+
+    // Writing the copy decoded compact texts the transcript shares with it
+    m_manager.compactInactive(m_currentIndex);
+    return true;
+}
+
+void AppController::handleBundleExported(const QString& bundlePath, bool ok, const QString& errorMessage) {
+
+    if (!ok) {
+        emit errorOccurred(errorMessage.isEmpty()
+                               ? tr("Failed to write bundle \"%1\".").arg(bundlePath)
+                               : errorMessage);
+        return;
+    }
+
+    emit bundleExported(bundlePath);
+}
+
+void AppController::queueDirtySaves(bool exportReference, bool includeBundles) {
 
     QString error;
 
     for (int i = 0; i < m_manager.transcriptCount(); ++i) {
-        Transcript* t = m_manager.transcriptAt(i);
-        if (!t)
+        const Transcript* t = m_manager.transcriptAt(i);
+        if (!t || !t->isDirty() || (t->isBundle() && !includeBundles))
             continue;
 
+        // Not every transcript has a reference file; only write existing ones
+        const bool withReference = exportReference && !t->referencePath.isEmpty();
+
         error.clear();
-        if (!m_exporter.exportAll(*t, false, &error)) {
+        if (!queueSave(*t, withReference, &error)) {
             emit errorOccurred(error.isEmpty()
                                ? tr("Failed to save transcript at index %1").arg(i)
                                : error);
             // you can `continue` or `break` here, depending on what you want
         }
-        else {
-            emit saveCompleted(t);
-        }
+        m_manager.markTextDecoded(i);
+    }
+
+    // Preparing the saves decoded the compact texts; drop those copies again
+    m_manager.compactInactive(m_currentIndex);
+}
+
+bool AppController::queueSave(const Transcript& transcript,
+                              bool exportReference,
+                              QString* errorMessage) {
+
+    // Bundles have no edit log: the file is rewritten as a whole
+    if (transcript.isBundle()) {
+        Model::Service::TranscriptBundle::Plan plan;
+        if (!Model::Service::TranscriptBundle::prepare(transcript, transcript.bundlePath, true,
+                                                       plan, errorMessage))
+            return false;
+
+        QMetaObject::invokeMethod(m_saveWorker, [worker = m_saveWorker, plan] {
+            worker->saveBundle(plan);
+        }, Qt::QueuedConnection);
+
+        return true;
+    }
+
+    if (m_manager.hasDatabase())
+        return saveToDatabase(transcript.id, errorMessage);
+
+    const QString logPath = EditLog::logPath(transcript.folderPath);
+
+    // Usual case: the edits are in the log already, only the save point is new
+    if (!exportReference && !needsCompaction(transcript)) {
+        const QStringList basePaths { EditLog::basePathOf(transcript) };
+        const QDateTime savedAt = QDateTime::currentDateTimeUtc();
+
+        QMetaObject::invokeMethod(m_saveWorker, [worker = m_saveWorker, id = transcript.id,
+                                                 logPath, basePaths, savedAt,
+                                                 generation = transcript.generation()] {
+            worker->commit(id, logPath, basePaths, savedAt, generation);
+        }, Qt::QueuedConnection);
+
+        return true;
+    }
+
+    // Runs here because it fills the segments' export caches; the plan it
+    // returns shares no mutable state with the transcript
+    Model::Service::TranscriptExporter::SavePlan plan;
+    if (!m_exporter.prepareSave(transcript, exportReference, plan, errorMessage))
+        return false;
+
+    // Edits made from now on are logged against this state; the worker
+    // serializes it for the log
+    const Model::Data::TranscriptVersion state(transcript);
+    markLogInSync(transcript, 0);
+
+    QMetaObject::invokeMethod(m_saveWorker, [worker = m_saveWorker, plan, logPath, state] {
+        worker->compact(plan, logPath, state);
+    }, Qt::QueuedConnection);
+
+    return true;
+}
+
+void AppController::handleSaveFinished(const QString& transcriptID,
+                                       const QDateTime& savedAt,
+                                       quint64 generation,
+                                       bool ok,
+                                       const QString& errorMessage) {
+
+    // Looked up again: the transcript list may have changed since the save was queued
+    Transcript* t = m_manager.transcriptAt(m_manager.indexOfTranscriptByID(transcriptID));
+
+    if (!ok) {
+        // The log may now lag behind the files; the next save rewrites everything
+        m_logTailBytes.insert(transcriptID, EditLog::CompactionBytes);
+
+        emit errorOccurred(errorMessage.isEmpty()
+                               ? tr("Failed to save transcript \"%1\".").arg(t ? t->title : transcriptID)
+                               : errorMessage);
+        return;
+    }
+
+    if (!t)
+        return;
+
+    t->lastEdited = savedAt;
+    t->markSaved(generation);
+    updateDirtyCount();
+    emit saveCompleted(t);
+
+    // The files just written are not a change on disk; saving replaced the watched files
+    m_manager.refreshFingerprint(m_manager.indexOfTranscriptByID(transcriptID));
+    updateWatchedPaths();
+
+    // Saved transcripts are no longer pinned in memory
+    m_manager.enforceMemoryBudget(m_currentIndex);
+}
+
+bool AppController::saveToDatabase(const QString& transcriptID, QString* errorMessage) {
+
+    Transcript* t = m_manager.transcriptAt(m_manager.indexOfTranscriptByID(transcriptID));
+    if (!t)
+        return false;
+
+    // Also covers edits that queued no segment change (e.g. speaker colors)
+    const QDateTime previousEdited = t->lastEdited;
+    t->lastEdited = QDateTime::currentDateTimeUtc();
+
+    Model::Service::TranscriptDatabase& db = m_manager.database();
+    db.recordHeader(*t);
+
+    // One transaction for every change queued since the last save, of all transcripts
+    if (!db.flush(errorMessage)) {
+        t->lastEdited = previousEdited;
+        return false;
+    }
+
+    t->markSaved(t->generation());
+    updateDirtyCount();
+    emit saveCompleted(t);
+
+    m_manager.enforceMemoryBudget(m_currentIndex);
+    return true;
+}
+
+int AppController::dirtyTranscriptCount() const {
+
+    return m_dirtyCount;
+}
+
+void AppController::handleLogFailed(const QString& transcriptID, const QString& errorMessage) {
+
+    m_logTailBytes.insert(transcriptID, EditLog::CompactionBytes);
+
+    // Until a compaction resets the log, no further edit reaches the disk
+    if (const Transcript* t = m_manager.transcriptAt(m_manager.indexOfTranscriptByID(transcriptID))) {
+        QString error;
+        if (!queueSave(*t, false, &error))
+            emit errorOccurred(error);
+    }
+
+    // Would otherwise repeat on every keystroke
+    if (m_logErrorReported)
+        return;
+
+    m_logErrorReported = true;
+    emit errorOccurred(tr("Edits could not be written to the edit log:\n%1").arg(errorMessage));
+}
+
+
+// ==== Autosave / recovery ====
+
+void AppController::setAutosaveEnabled(bool enabled) {
+
+    m_autosaveEnabled = enabled;
+    if (!enabled) {
+        m_autosaveTimer->stop();
+        m_autosavePendingSince.invalidate();
+    }
+}
+
+bool AppController::autosaveEnabled() const {
+
+    return m_autosaveEnabled;
+}
+
+void AppController::handleAutosaveTimeout() {
+
+    m_autosaveTimer->stop();
+    m_autosavePendingSince.invalidate();
+
+    if (m_autosaveEnabled)
+        queueDirtySaves(false, false);
+}
+
+void AppController::scheduleAutosave() {
+
+    if (!m_autosaveEnabled)
+        return;
+
+    if (!m_autosavePendingSince.isValid())
+        m_autosavePendingSince.start();
+
+    // Each edit postpones the save, but never past the maximum delay
+    const qint64 remaining = AutosaveMaxDelayMs - m_autosavePendingSince.elapsed();
+    if (remaining <= 0) {
+        handleAutosaveTimeout();
+        return;
+    }
+
+    m_autosaveTimer->start(int(qMin<qint64>(AutosaveIdleMs, remaining)));
+}
+
+bool AppController::needsCompaction(const Transcript& transcript) const {
+
+    // Missing entries: the log was never in sync with this transcript
+    return m_logTailBytes.value(transcript.id, EditLog::CompactionBytes) >= EditLog::CompactionBytes
+        || m_loggedGeneration.value(transcript.id) != transcript.generation();
+}
+
+void AppController::logEdit(const Transcript& transcript,
+                            const TranscriptEditor::SegmentChange& change) {
+
+    if (transcript.folderPath.isEmpty())
+        return;
+
+    // Not in sync with a log (see markLogInSync()): the next save compacts
+    if (!m_logTailBytes.contains(transcript.id))
+        return;
+
+    // No operations: the edit left the text as it was (e.g. the same text set again)
+    if (change.operations.isEmpty()) {
+        m_loggedGeneration.insert(transcript.id, transcript.generation());
+        return;
+    }
+
+    // Serialized on the writer thread; only the size is needed here
+    const qint64 tailBytes = m_logTailBytes.value(transcript.id)
+                           + EditLog::estimatedSize(change.operations);
+    m_logTailBytes.insert(transcript.id, tailBytes);
+    m_loggedGeneration.insert(transcript.id, transcript.generation());
+
+    // A new log is written against the file the importer would load
+    const QStringList basePaths { EditLog::basePathOf(transcript) };
+    const QString logPath = EditLog::logPath(transcript.folderPath);
+
+    QMetaObject::invokeMethod(m_saveWorker, [worker = m_saveWorker, id = transcript.id,
+                                             logPath, basePaths, operations = change.operations] {
+        worker->appendLog(id, logPath, basePaths, operations);
+    }, Qt::QueuedConnection);
+
+    // Replay time grows with the log: fold it into a fresh text file in the background
+    if (tailBytes >= EditLog::CompactionBytes) {
+        QString error;
+        if (!queueSave(transcript, false, &error))
+            emit errorOccurred(error);
+    }
+}
+
+void AppController::markLogInSync(const Transcript& transcript, qint64 tailBytes) {
+
+    m_logTailBytes.insert(transcript.id, tailBytes);
+    m_loggedGeneration.insert(transcript.id, transcript.generation());
+}
+
+void AppController::replayEditLogs(QStringList& outUncommittedTitles) {
+
+    for (int i = 0; i < m_manager.transcriptCount(); ++i) {
+        if (Transcript* t = m_manager.transcriptAt(i))
+            replayEditLog(*t, outUncommittedTitles);
+    }
+}
+
+void AppController::replayEditLog(Transcript& transcript, QStringList& outUncommittedTitles) {
+
+    EditLog::ReplayResult result;
+    QString error;
+    if (!EditLog::replay(transcript, &result, &error)) {
+        emit errorOccurred(error);
+        return;
+    }
+
+    // Edits after the last save point were never saved by the user
+    if (result.uncommitted > 0) {
+        transcript.markModified();
+        outUncommittedTitles << transcript.title;
     }
+
+    markLogInSync(transcript, result.tailBytes);
+}
+
+void AppController::updateDirtyCount() {
+
+    int count = 0;
+    for (const Transcript& t : m_manager.transcripts()) {
+        if (t.isDirty())
+            ++count;
+    }
+
+    if (count == m_dirtyCount)
+        return;
+
+    m_dirtyCount = count;
+    emit dirtyCountChanged(count);
 }
 
 // ==== Audio ====
@@ -545,6 +1325,26 @@ void AppController::handleMediaPlaybackStateChanged(QMediaPlayer::PlaybackState
 }
 
 
+// ==== Search worker slots ====
+
+void AppController::handleSearchResultsPartial(quint64 queryId, const QVector<int>& indices) {
+
+    if (queryId != m_lastSearchID || !m_searchCancelToken)
+        return;
+
+    emit searchResultsPartial(queryId, indices);
+}
+
+void AppController::handleSearchFinished(quint64 queryId, const QVector<int>& indices, bool cancelled) {
+
+    if (cancelled || queryId != m_lastSearchID || !m_searchCancelToken)
+        return;
+
+    m_searchCancelToken.reset();
+    emit searchFinished(queryId, indices);
+}
+
+
 // ==== Private helpers ====
 
 
@@ -577,6 +1377,19 @@ void AppController::recreateEditorForCurrentTranscript() {
 
     delete m_editor;
     m_editor = nullptr;
+    m_searchSession.reset();
+    m_trigramIndex.clear();
+    m_segmentStore.clear();
+    cancelSearch();
+
+    // An evicted transcript is loaded again before it is shown
+    const bool wasResident = m_manager.isResident(m_currentIndex);
+    QString error;
+    const bool resident = m_currentIndex < 0 || m_manager.ensureResident(m_currentIndex, &error);
+
+    // Only the shown transcript is kept as QString text; the rest stay compact
+    m_manager.compactInactive(m_currentIndex);
+    m_manager.enforceMemoryBudget(m_currentIndex);
 
     Transcript* t = currentTranscript();
     if (!t) {
@@ -584,6 +1397,18 @@ void AppController::recreateEditorForCurrentTranscript() {
         return;
     }
 
+    // No editor on an empty stand-in: a save would overwrite the real text
+    if (!resident) {
+        emit errorOccurred(error);
+        emitUndoRedoAvailability();
+        return;
+    }
+
+    // Reloading reset the generation; the log did not change meanwhile
+    if (!wasResident && m_logTailBytes.contains(t->id))
+        markLogInSync(*t, m_logTailBytes.value(t->id));
+
+    t->expandText();
     m_editor = new TranscriptEditor(*t);
     emitUndoRedoAvailability();
 
@@ -602,4 +1427,84 @@ void AppController::emitUndoRedoAvailability() {
     emit undoRedoAvailabilityChanged(canUndo, canRedo);
 }
 
+void AppController::applyLastEditToSearch() {
+
+    const Transcript* t = currentTranscript();
+    if (!m_editor || !t)
+        return;
+
+    updateDirtyCount();
+
+    const TranscriptEditor::SegmentChange change = m_editor->takeLastChange();
+    if (change.isNone())
+        return;
+
+    if (m_manager.hasDatabase())
+        m_manager.database().recordChange(*t, change.first, change.removedCount, change.insertedCount);
+    else
+        logEdit(*t, change);
+    scheduleAutosave();
+
+    if (change.isFullReset()) {
+        m_searchSession.reset();
+        m_trigramIndex.clear(); // rebuilt lazily by the next search
+        m_segmentStore.clear();
+        return;
+    }
+
+    // Index and store first: the session may use them on its next full scan
+    m_trigramIndex.segmentsReplaced(*t, change.first,
+                                    change.removedCount, change.insertedCount);
+    m_segmentStore.segmentsReplaced(*t, change.first,
+                                    change.removedCount, change.insertedCount);
+    m_searchSession.segmentsReplaced(*t, change.first,
+                                     change.removedCount, change.insertedCount);
+
+    scheduleStoreCompaction();
+
+    emit segmentsReplaced(currentTranscript(), change.first,
+                          change.removedCount, change.insertedCount);
+}
+
+void AppController::ensureTrigramIndex() const {
+
+    const Transcript* t = currentTranscript();
+    if (!t)
+        return;
+
+    if (!m_trigramIndex.isBuilt())
+        m_trigramIndex.build(*t);
+    else
+        m_trigramIndex.refresh(*t);
+}
+
+void AppController::ensureSegmentStore() const {
+
+    const Transcript* t = currentTranscript();
+    if (t && !m_segmentStore.refresh(*t))
+        m_segmentStore.build(*t);
+}
+
+void AppController::scheduleStoreCompaction() {
+
+    if (m_storeCompactionPending || !m_segmentStore.needsCompaction())
+        return;
+
+    m_storeCompactionPending = true;
+
+    // Implicitly shared copy: the worker packs it while edits keep going here
+    const Model::Data::SegmentStore snapshot = m_segmentStore;
+    const quint64 generation = snapshot.generation();
+
+    QMetaObject::invokeMethod(m_searchWorker, [this, snapshot, generation]() {
+        const Model::Data::SegmentStore packed = snapshot.compacted();
+
+        QMetaObject::invokeMethod(this, [this, packed, generation]() {
+            m_storeCompactionPending = false;
+            if (m_segmentStore.generation() == generation)
+                m_segmentStore = packed;
+        }, Qt::QueuedConnection);
+    }, Qt::QueuedConnection);
+}
+
 }
@@ -5,6 +5,12 @@
 #include "Model/Service/TranscriptEditor.h"
 #include "Model/Service/TranscriptExporter.h"
 #include "Model/Service/TranscriptSearch.h"
+#include "Model/Service/TranscriptSearchSession.h"
+#include "Model/Service/TrigramIndex.h"
+#include "Model/Data/SegmentStore.h"
+#include "Model/Data/TranscriptVersion.h"
+#include "Controller/SaveWorker.h"
+#include "Controller/SearchWorker.h"
 
 #include <QObject>
 #include <QString>
@@ -12,6 +18,11 @@
 #include <QVector>
 #include <QMediaPlayer>
 #include <QAudioOutput>
+#include <QThread>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QFileSystemWatcher>
+#include <QHash>
 
 namespace Controller {
 
@@ -49,10 +60,62 @@ public:
     /**
      * @brief Loads all transcripts from the current root directory.
      *
-     * Emits transcriptsReloaded() and currentTranscriptChanged() if successful.
+     * With a database open (see openDatabase()), loads them from the
+     * database instead. Emits transcriptsReloaded() and
+     * currentTranscriptChanged() if successful.
      */
     bool loadTranscripts(QString* errorMessage = nullptr);
 
+    /**
+     * @brief Switches storage to the SQLite database at path and reloads from it.
+     *
+     * Loaded transcripts not in the database yet are stored into it first.
+     * From then on, edits are queued for the database instead of the edit
+     * logs, and a save writes everything queued in one transaction.
+     */
+    bool openDatabase(const QString& path, QString* errorMessage = nullptr);
+
+    /** @brief Returns true if transcripts are stored in a database. */
+    bool hasDatabase() const;
+
+    /** @brief Delay after the last change in the watched root before it is rescanned. */
+    static constexpr int RescanDelayMs = 500;
+
+    /**
+     * @brief Enables or disables watching the root directory (default: off).
+     *
+     * While enabled, changes to the root directory, its transcript folders
+     * and bundles are applied through rescanRoot() once they settle for
+     * RescanDelayMs. Has no effect while a database is open.
+     */
+    void setWatchRoot(bool enabled);
+
+    /** @brief Returns true if the root directory is watched. */
+    bool watchRoot() const;
+
+    /**
+     * @brief Applies added, removed and changed transcripts of the root directory.
+     *
+     * Unlike loadTranscripts(), transcripts that did not change stay as
+     * they are; the current one keeps its selection and undo history unless
+     * it was itself removed or changed. Emits transcriptRemoved(),
+     * transcriptReloaded() and transcriptAdded() per change, in that order
+     * (see TranscriptManager::rescanRoot()).
+     */
+    bool rescanRoot(QString* errorMessage = nullptr);
+
+    /**
+     * @brief Sets how much memory loaded transcripts may use (0: no limit).
+     *
+     * Least recently shown transcripts without unsaved edits are evicted
+     * past it and loaded again when selected (see
+     * TranscriptManager::enforceMemoryBudget()).
+     */
+    void setMemoryBudget(qsizetype bytes);
+
+    /** @brief Returns the approximate memory held by the transcript at index (diagnostics). */
+    qsizetype transcriptResidentBytes(int index) const;
+
     /** @brief Returns the number of loaded transcripts. */
     int transcriptCount() const;
 
@@ -94,26 +157,89 @@ public:
     Model::Service::TranscriptEditor* editor();
     const Model::Service::TranscriptEditor* editor() const;
 
+    /**
+     * @brief Returns the current transcript's state as an immutable version.
+     *
+     * O(1); the version can be read from any thread while editing goes on.
+     * Returns a null version if no transcript is selected.
+     */
+    Model::Data::TranscriptVersion currentVersion() const;
+
+    /** @brief Returns the current index of the segment with the given stable ID, or -1. */
+    int segmentIndexForID(quint64 segmentID) const;
+
+    /** @brief Returns the stable ID of the segment at index, or 0 if index is invalid. */
+    quint64 segmentIDAt(int index) const;
+
     /**
      * @brief Search helper for the UI: find all segment indices matching pattern.
      *
      * If speakerFilter is empty, performs a plain text search over all segments.
      * Otherwise, restricts search to segments whose speaker is in speakerFilter.
+     * Results are served by an incremental search session, so typing a longer
+     * pattern only re-checks the previous matches. With accentInsensitive,
+     * "cafe" also matches "café".
      */
     QVector<int> searchSegments(const QString& pattern,
                                 const QStringList& speakerFilter,
-                                Qt::CaseSensitivity cs = Qt::CaseInsensitive) const;
+                                Qt::CaseSensitivity cs = Qt::CaseInsensitive,
+                                bool accentInsensitive = false) const;
+
+    /**
+     * @brief Searches every transcript in the database for a phrase.
+     *
+     * Optionally restricted to segments of speakerID. Fails if no database
+     * is open (see openDatabase()).
+     */
+    bool searchAllTranscripts(const QString& text,
+                              const QString& speakerID,
+                              QVector<Model::Service::TranscriptDatabase::SegmentHit>& outHits,
+                              QString* errorMessage = nullptr);
 
     /**
      * @brief Search helper for "Find next" starting from fromIndex (exclusive).
      *
-     * If speakerFilter is empty, uses TranscriptSearch::findNext; otherwise it
-     * searches within the list returned by findBySpeakersAndText.
+     * Uses a lazy TranscriptSearch::MatchIterator, so only the segments up to
+     * the next hit are checked. If wrapAround is true and nothing is found
+     * after fromIndex, the search continues from the first segment.
      */
     int searchNext(const QString& pattern,
                    const QStringList& speakerFilter,
                    int fromIndex,
-                   Qt::CaseSensitivity cs = Qt::CaseInsensitive) const;
+                   Qt::CaseSensitivity cs = Qt::CaseInsensitive,
+                   bool wrapAround = false,
+                   bool accentInsensitive = false) const;
+
+    /**
+     * @brief Search helper for "Find previous" starting from fromIndex (exclusive).
+     *
+     * Mirror of searchNext() walking towards the first segment; with
+     * wrapAround it continues from the last segment.
+     */
+    int searchPrevious(const QString& pattern,
+                       const QStringList& speakerFilter,
+                       int fromIndex,
+                       Qt::CaseSensitivity cs = Qt::CaseInsensitive,
+                       bool wrapAround = false,
+                       bool accentInsensitive = false) const;
+
+    /**
+     * @brief Starts a search on the background search thread.
+     *
+     * The worker searches a snapshot of the current transcript, so edits made
+     * meanwhile do not affect it. Any search still running is cancelled.
+     * Results arrive through searchResultsPartial() and searchFinished().
+     *
+     * @return The query ID used in those signals, or 0 if nothing was started.
+     */
+    quint64 requestSearch(const QString& pattern,
+                          const QStringList& speakerFilter,
+                          Qt::CaseSensitivity cs = Qt::CaseInsensitive,
+                          bool useRegex = false,
+                          bool accentInsensitive = false);
+
+    /** @brief Cancels the running background search, if any. */
+    void cancelSearch();
 
 Q_SIGNALS:
 
@@ -126,9 +252,29 @@ Q_SIGNALS:
     /** @brief Emitted whenever the current transcript content changes. */
     void transcriptContentChanged(Model::Data::Transcript* transcript);
 
-    /** @brief Emitted when a save operation completes successfully. */
+    /**
+     * @brief Emitted before transcriptContentChanged() when an edit touched a known range.
+     *
+     * Segments [first, first + removedCount) were replaced by
+     * [first, first + insertedCount). Lets views patch their rows in place
+     * instead of rebuilding; not emitted for whole-transcript changes.
+     */
+    void segmentsReplaced(Model::Data::Transcript* transcript,
+                          int first,
+                          int removedCount,
+                          int insertedCount);
+
+    /**
+     * @brief Emitted when a save operation completes successfully.
+     *
+     * Saves run on a writer thread, so this arrives after requestSaveCurrent()
+     * or requestSaveAll() has returned.
+     */
     void saveCompleted(Model::Data::Transcript* transcript);
 
+    /** @brief Emitted when requestExportBundle() has written the bundle file. */
+    void bundleExported(const QString& bundlePath);
+
     /**
      * @brief Emitted when a new transcript is imported and added.
      * @param newIndex Index of the newly added transcript.
@@ -136,6 +282,24 @@ Q_SIGNALS:
      */
     void importCompleted(int newIndex, Model::Data::Transcript* transcript);
 
+    /** @brief Emitted when the number of transcripts with unsaved edits changes. */
+    void dirtyCountChanged(int count);
+
+    /**
+     * @brief Emitted after loading if edit logs held edits that were never saved.
+     * @param titles Titles of the recovered transcripts (now dirty).
+     */
+    void transcriptsRecovered(const QStringList& titles);
+
+    /** @brief Emitted by rescanRoot() after the transcript at index was removed. */
+    void transcriptRemoved(int index);
+
+    /** @brief Emitted by rescanRoot() after the transcript at index was loaded again from disk. */
+    void transcriptReloaded(int index);
+
+    /** @brief Emitted by rescanRoot() after a new transcript was appended at index. */
+    void transcriptAdded(int index);
+
     /** @brief Emitted whenever an error occurs that should be shown in the UI. */
     void errorOccurred(const QString& message);
 
@@ -148,6 +312,12 @@ Q_SIGNALS:
     /** @brief Emitted when audio playback state changes (playing/paused/stopped). */
     void audioPlaybackStateChanged(QMediaPlayer::PlaybackState state);
 
+    /** @brief Emitted per batch with new matches of the active background search. */
+    void searchResultsPartial(quint64 queryId, const QVector<int>& indices);
+
+    /** @brief Emitted once the active background search has scanned every segment. */
+    void searchFinished(quint64 queryId, const QVector<int>& indices);
+
 public Q_SLOTS:
 
     /** @brief Selects the transcript at index and updates audio source. */
@@ -164,6 +334,9 @@ public Q_SLOTS:
     /** @brief Sets the text of a segment. */
     void requestSetSegmentText(int index, const QString& text);
 
+    /** @brief Replaces charsRemoved characters at position with insertedText in a segment. */
+    void requestSpliceSegmentText(int index, int position, int charsRemoved, const QString& insertedText);
+
     /** @brief Appends text to a segment. */
     void requestAppendToSegment(int index, const QString& text);
 
@@ -212,6 +385,40 @@ public Q_SLOTS:
     /** @brief Normalizes whitespace across all segments. */
     void requestNormalizeWhitespaceAll();
 
+    // ==== Editing by stable segment ID ====
+    // Same as the index-based requests above, but the segment is addressed by
+    // its stable ID, which stays valid while other segments move. Requests
+    // for unknown IDs (e.g. an already deleted segment) are ignored.
+
+    /** @brief Sets the text of a segment. */
+    void requestSetSegmentTextByID(quint64 segmentID, const QString& text);
+
+    /** @brief Replaces charsRemoved characters at position with insertedText in a segment. */
+    void requestSpliceSegmentTextByID(quint64 segmentID,
+                                      int position,
+                                      int charsRemoved,
+                                      const QString& insertedText);
+
+    /** @brief Changes the speaker of a segment. */
+    void requestChangeSegmentSpeakerByID(quint64 segmentID, const QString& speakerID);
+
+    /** @brief Splits a segment at a character position, assigning two speakers. */
+    bool requestSplitSegmentWithSpeakersByID(quint64 segmentID,
+                                             int splitPos,
+                                             const QString& speakerFirst,
+                                             const QString& speakerSecond);
+
+    /** @brief Merges a segment with the one following it. */
+    void requestMergeWithNextByID(quint64 segmentID);
+
+    /** @brief Inserts a new segment right after the given one. */
+    void requestInsertSegmentAfterID(quint64 segmentID,
+                                     const QString& speakerID,
+                                     const QString& text);
+
+    /** @brief Deletes a segment. */
+    void requestDeleteSegmentByID(quint64 segmentID);
+
     // ==== Import / export ====
 
     /**
@@ -227,18 +434,74 @@ public Q_SLOTS:
     /**
      * @brief Saves the currently selected transcript to disk.
      *
-     * Uses TranscriptExporter to write editable.txt and meta.json.
+     * Every edit is already in the transcript's edit log (see
+     * Model::Service::EditLog), so a save normally only appends a commit to
+     * it. The transcript is compacted instead (editable.txt and meta.json
+     * written through TranscriptExporter, then the log reset) when the log
+     * has grown past EditLog::CompactionBytes, when it misses edits, or with
+     * exportReference. A transcript loaded from a bundle is saved by
+     * rewriting its bundle file. Either way the work runs asynchronously on
+     * the writer thread; completion is reported through saveCompleted() or
+     * errorOccurred().
+     *
+     * With a database open, the queued database changes are written instead,
+     * right away; exportReference is ignored (see requestExportToFolder()).
      */
     void requestSaveCurrent(bool exportReference = false);
 
     /**
-     * @brief Saves all loaded transcripts to disk.
+     * @brief Saves all transcripts with unsaved edits to disk.
      *
-     * Currently calls TranscriptExporter for each transcript without
-     * changing the current selection.
+     * Queues one asynchronous save per dirty transcript (see
+     * requestSaveCurrent()) without changing the current selection.
+     * Transcripts without edits are not rewritten. With exportReference, the
+     * reference file is also written for those that have one.
      */
     void requestSaveAll(bool exportReference = false);
 
+    /**
+     * @brief Writes the current transcript to a single-file bundle.
+     *
+     * A copy: the transcript keeps being saved where it was loaded from.
+     * Written on the writer thread; completion is reported through
+     * bundleExported() or errorOccurred().
+     */
+    void requestExportBundle(const QString& bundlePath, bool includeAudio = true);
+
+    /**
+     * @brief Writes the current transcript as a transcript folder.
+     *
+     * A copy in the folder format (see
+     * TranscriptManager::exportTranscriptToFolder()), e.g. to take a
+     * transcript out of the database.
+     */
+    bool requestExportToFolder(const QString& folderPath, QString* errorMessage = nullptr);
+
+    /** @brief Returns the number of transcripts with unsaved edits. */
+    int dirtyTranscriptCount() const;
+
+
+    // ==== Autosave / recovery ====
+
+    /** @brief Idle time after the last edit before dirty transcripts are autosaved. */
+    static constexpr int AutosaveIdleMs = 2000;
+
+    /** @brief Longest time an edit stays unsaved while edits keep coming. */
+    static constexpr int AutosaveMaxDelayMs = 30000;
+
+    /**
+     * @brief Enables or disables autosave (default: on).
+     *
+     * While enabled, dirty transcripts are saved in the background once
+     * editing pauses for AutosaveIdleMs, or at the latest AutosaveMaxDelayMs
+     * after the first unsaved edit. Edits are written to the edit log
+     * either way; autosaving commits them.
+     */
+    void setAutosaveEnabled(bool enabled);
+
+    /** @brief Returns true if autosave is enabled. */
+    bool autosaveEnabled() const;
+
 
     // ==== Audio ====
 
@@ -265,6 +528,31 @@ private Q_SLOTS:
     /** @brief Internal slot for QMediaPlayer::playbackStateChanged. */
     void handleMediaPlaybackStateChanged(QMediaPlayer::PlaybackState state);
 
+    /** @brief Internal slot for SearchWorker::resultsPartial (drops stale queries). */
+    void handleSearchResultsPartial(quint64 queryId, const QVector<int>& indices);
+
+    /** @brief Internal slot for SearchWorker::finished (drops stale or cancelled queries). */
+    void handleSearchFinished(quint64 queryId, const QVector<int>& indices, bool cancelled);
+
+    /** @brief Internal slot for SaveWorker::finished (updates lastEdited, reports the result). */
+    void handleSaveFinished(const QString& transcriptID,
+                            const QDateTime& savedAt,
+                            quint64 generation,
+                            bool ok,
+                            const QString& errorMessage);
+
+    /** @brief Internal slot for SaveWorker::logFailed: compacts the transcript (reported once per session). */
+    void handleLogFailed(const QString& transcriptID, const QString& errorMessage);
+
+    /** @brief Internal slot for SaveWorker::bundleExported. */
+    void handleBundleExported(const QString& bundlePath, bool ok, const QString& errorMessage);
+
+    /** @brief Internal slot for the autosave timer: queues saves of all dirty transcripts. */
+    void handleAutosaveTimeout();
+
+    /** @brief Internal slot for the rescan timer: applies the changes in the watched root. */
+    void handleRescanTimeout();
+
 private:
 
     Model::Service::TranscriptManager m_manager;
@@ -273,6 +561,36 @@ private:
 
     int m_currentIndex = -1;
 
+    mutable Model::Service::TranscriptSearchSession m_searchSession;
+    mutable Model::Service::TrigramIndex m_trigramIndex;
+    mutable Model::Data::SegmentStore m_segmentStore;
+    bool m_storeCompactionPending = false;
+
+    QThread* m_searchThread = nullptr;
+    SearchWorker* m_searchWorker = nullptr;
+    SearchCancelToken m_searchCancelToken;
+    quint64 m_lastSearchID = 0;
+
+    QThread* m_saveThread = nullptr;
+    SaveWorker* m_saveWorker = nullptr;
+    int m_dirtyCount = 0;
+
+    QTimer* m_autosaveTimer = nullptr;
+    QElapsedTimer m_autosavePendingSince;   // Started at the first edit not yet autosaved
+    bool m_autosaveEnabled = true;
+
+    // Watched root: watcher signals (re)start the single-shot rescan timer
+    QFileSystemWatcher* m_rootWatcher = nullptr;
+    QTimer* m_rescanTimer = nullptr;
+    bool m_watchRoot = false;
+
+    // Per transcript ID: log bytes past the compacted snapshot, and the
+    // generation the log has recorded up to. Transcripts missing here (or
+    // whose generation moved without a logged edit) are compacted on save.
+    QHash<QString, qint64> m_logTailBytes;
+    QHash<QString, quint64> m_loggedGeneration;
+    bool m_logErrorReported = false;
+
     QMediaPlayer* m_mediaPlayer = nullptr;
     QAudioOutput* m_audioOutput = nullptr;
     qint64 m_durationMs = 0;
@@ -280,12 +598,93 @@ private:
     /** @brief Updates QMediaPlayer source for the current transcript. */
     void updateMediaForCurrentTranscript();
 
+    /**
+     * @brief Queues a save of transcript on the writer thread.
+     *
+     * A commit to the edit log, or a compaction (see requestSaveCurrent()).
+     * Returns false (with errorMessage set) if the save cannot be prepared,
+     * e.g. because the transcript folder is missing.
+     */
+    bool queueSave(const Model::Data::Transcript& transcript,
+                   bool exportReference,
+                   QString* errorMessage);
+
+    /** @brief Writes the database changes queued so far and marks the transcript saved. */
+    bool saveToDatabase(const QString& transcriptID, QString* errorMessage);
+
+    /**
+     * @brief Queues saves of every dirty transcript (see requestSaveAll()).
+     *
+     * Bundles are rewritten as a whole (audio included) on every save, so
+     * autosaves leave them out. Preparation errors are reported through
+     * errorOccurred().
+     */
+    void queueDirtySaves(bool exportReference, bool includeBundles = true);
+
+    /** @brief Recounts dirty transcripts and emits dirtyCountChanged() if the count changed. */
+    void updateDirtyCount();
+
+    /** @brief Returns true if the next save of transcript must compact it. */
+    bool needsCompaction(const Model::Data::Transcript& transcript) const;
+
+    /**
+     * @brief Appends an edit of transcript to its edit log.
+     *
+     * Logs the editor operations of change (undo and redo included), which
+     * the writer thread serializes. Queues a compaction once the log is
+     * large enough.
+     */
+    void logEdit(const Model::Data::Transcript& transcript,
+                 const Model::Service::TranscriptEditor::SegmentChange& change);
+
+    /** @brief Records that transcript's on-disk state (text file + log) matches memory. */
+    void markLogInSync(const Model::Data::Transcript& transcript, qint64 tailBytes);
+
+    /** @brief (Re)starts the autosave timer after an edit. */
+    void scheduleAutosave();
+
+    /** @brief Watches the root directory and every folder, file and bundle loaded from it. */
+    void updateWatchedPaths();
+
+    /**
+     * @brief Replays the edit logs of all loaded transcripts.
+     *
+     * Transcripts whose log ends in edits that were never committed are
+     * marked dirty and their titles appended to outUncommittedTitles.
+     */
+    void replayEditLogs(QStringList& outUncommittedTitles);
+
+    /** @brief Replays the edit log of one transcript (see replayEditLogs()). */
+    void replayEditLog(Model::Data::Transcript& transcript, QStringList& outUncommittedTitles);
+
     /** @brief Recreates the editor for the currently selected transcript. */
     void recreateEditorForCurrentTranscript();
 
     /** @brief Emits undoRedoAvailabilityChanged based on editor state. */
     void emitUndoRedoAvailability();
 
+    /**
+     * @brief Forwards the editor's last segment change to the search session and index.
+     *
+     * Also emits segmentsReplaced() for range changes, and dirtyCountChanged()
+     * if the edit made the transcript dirty. Logs the edit and schedules
+     * an autosave.
+     */
+    void applyLastEditToSearch();
+
+    /** @brief Builds the trigram index of the current transcript, or indexes its pending segments. */
+    void ensureTrigramIndex() const;
+
+    /** @brief Packs the current transcript (or only its pending segments) into the segment store. */
+    void ensureSegmentStore() const;
+
+    /**
+     * @brief Repacks the segment store on the search thread if it has grown fragmented.
+     *
+     * The result is dropped if the store was modified in the meantime.
+     */
+    void scheduleStoreCompaction();
+
 };
 
 }
@@ -0,0 +1,81 @@
+#include "SaveWorker.h"
+
+#include "Model/Service/EditLog.h"
+
+namespace Controller {
+
+using Model::Service::TranscriptExporter;
+using Model::Service::EditLog;
+using Model::Service::TranscriptBundle;
+
+SaveWorker::SaveWorker(QObject* parent)
+    : QObject(parent)
+{}
+
+void SaveWorker::compact(const TranscriptExporter::SavePlan& plan,
+                         const QString& logPath,
+                         const Model::Data::TranscriptVersion& state) {
+    QString error;
+    QDateTime lastEdited;
+    bool ok = TranscriptExporter::writeSave(plan, &error, &lastEdited);
+
+    // Edits queued after this job were recorded against state
+    if (ok)
+        ok = EditLog::reset(logPath, plan.editablePath, EditLog::snapshotRecord(state.transcript()),
+                            lastEdited, &error);
+
+    if (ok)
+        brokenLogs.remove(logPath);
+
+    emit finished(plan.transcriptID, lastEdited, plan.generation, ok, error);
+}
+
+void SaveWorker::commit(const QString& transcriptID,
+                        const QString& logPath,
+                        const QStringList& basePaths,
+                        const QDateTime& savedAt,
+                        quint64 generation) {
+    QString error;
+    bool ok = false;
+
+    if (brokenLogs.contains(logPath))
+        error = QStringLiteral("The edit log is incomplete; the transcript must be saved in full: %1").arg(logPath);
+    else
+        ok = EditLog::append(logPath, basePaths, EditLog::commitRecord(savedAt), &error);
+
+    emit finished(transcriptID, ok ? savedAt : QDateTime(), generation, ok, error);
+}
+
+void SaveWorker::saveBundle(const TranscriptBundle::Plan& plan) {
+
+    QString error;
+    const bool ok = TranscriptBundle::write(plan, &error);
+
+    emit finished(plan.transcriptID, ok ? plan.savedAt : QDateTime(), plan.generation, ok, error);
+}
+
+void SaveWorker::exportBundle(const TranscriptBundle::Plan& plan) {
+
+    QString error;
+    const bool ok = TranscriptBundle::write(plan, &error);
+
+    emit bundleExported(plan.bundlePath, ok, error);
+}
+
+void SaveWorker::appendLog(const QString& transcriptID,
+                           const QString& logPath,
+                           const QStringList& basePaths,
+                           const QVector<Model::Service::TranscriptEditor::Operation>& operations) {
+
+    // Replaying after a gap would apply later records to the wrong segments
+    if (brokenLogs.contains(logPath))
+        return;
+
+    QString error;
+    if (!EditLog::append(logPath, basePaths, EditLog::operationsRecord(operations), &error)) {
+        brokenLogs.insert(logPath);
+        emit logFailed(transcriptID, error);
+    }
+}
+
+}
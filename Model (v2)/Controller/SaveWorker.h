@@ -0,0 +1,112 @@
+#ifndef CONTROLLER_SAVE_WORKER_H
+#define CONTROLLER_SAVE_WORKER_H
+
+#include "Model/Service/TranscriptExporter.h"
+#include "Model/Service/TranscriptBundle.h"
+#include "Model/Service/TranscriptEditor.h"
+#include "Model/Data/TranscriptVersion.h"
+
+#include <QObject>
+#include <QByteArray>
+#include <QDateTime>
+#include <QString>
+#include <QStringList>
+#include <QSet>
+
+namespace Controller {
+
+/**
+ * @brief Writes transcripts to disk on a worker thread.
+ *
+ * Lives on the writer thread owned by AppController. Each job is a
+ * TranscriptExporter::SavePlan prepared on the GUI thread; the worker
+ * encodes the fragments and writes the files that changed through
+ * QSaveFile, then reports through finished(). Jobs run one at a time in the
+ * order they were queued, so two saves of the same transcript never
+ * interleave.
+ *
+ * The worker also owns the edit logs (see Model::Service::EditLog): edit
+ * records, commits and compactions share the queue, so they reach the log
+ * in edit order, and are serialized here rather than on the GUI thread.
+ * Once an append fails, that log is missing a record and further appends
+ * to it are dropped until a compaction resets it.
+ */
+
+class SaveWorker : public QObject {
+
+    Q_OBJECT
+
+public:
+
+    /** @brief Constructs a worker with optional parent QObject. */
+    explicit SaveWorker(QObject* parent = nullptr);
+
+    /**
+     * @brief Compacts a transcript: writes plan to disk. Must be called on the worker thread.
+     *
+     * On success, also resets the edit log at logPath to a snapshot of
+     * state, the version plan was built from (see Model::Service::EditLog::reset()).
+     */
+    void compact(const Model::Service::TranscriptExporter::SavePlan& plan,
+                 const QString& logPath,
+                 const Model::Data::TranscriptVersion& state);
+
+    /**
+     * @brief Saves a transcript by appending a commit to its edit log.
+     *
+     * Reports through finished() like compact(); fails if the log is broken.
+     */
+    void commit(const QString& transcriptID,
+                const QString& logPath,
+                const QStringList& basePaths,
+                const QDateTime& savedAt,
+                quint64 generation);
+
+    /**
+     * @brief Saves a bundled transcript by rewriting its bundle file.
+     *
+     * Bundles have no edit log; reports through finished() like compact().
+     */
+    void saveBundle(const Model::Service::TranscriptBundle::Plan& plan);
+
+    /** @brief Writes a copy of a transcript as a bundle; reports through bundleExported(). */
+    void exportBundle(const Model::Service::TranscriptBundle::Plan& plan);
+
+    /** @brief Appends the operations of an edit to an edit log. Must be called on the worker thread. */
+    void appendLog(const QString& transcriptID,
+                   const QString& logPath,
+                   const QStringList& basePaths,
+                   const QVector<Model::Service::TranscriptEditor::Operation>& operations);
+
+Q_SIGNALS:
+
+    /**
+     * @brief Emitted once per job.
+     *
+     * @param transcriptID ID of the saved transcript.
+     * @param savedAt      lastEdited value written to meta.json (invalid on failure).
+     * @param generation   Transcript generation that was written.
+     * @param ok           False if any file could not be written.
+     * @param errorMessage Human-readable error if ok is false.
+     */
+    void finished(const QString& transcriptID,
+                  const QDateTime& savedAt,
+                  quint64 generation,
+                  bool ok,
+                  const QString& errorMessage);
+
+    /** @brief Emitted once per exportBundle() job. */
+    void bundleExported(const QString& bundlePath, bool ok, const QString& errorMessage);
+
+    /** @brief Emitted when an edit record could not be appended; the log needs a compaction. */
+    void logFailed(const QString& transcriptID, const QString& errorMessage);
+
+private:
+
+    // Logs missing a record since their last reset
+    QSet<QString> brokenLogs;
+};
+
+}
+
+#endif // CONTROLLER_SAVE_WORKER_H
@@ -0,0 +1,88 @@
+#include "SearchWorker.h"
+
+#include "Model/Service/TranscriptSearch.h"
+
+#include <QRegularExpression>
+
+namespace Controller {
+
+using Model::Data::Transcript;
+using Model::Data::Segment;
+using Model::Service::TranscriptSearch;
+using Model::Service::TextFolding;
+
+SearchWorker::SearchWorker(QObject* parent)
+    : QObject(parent)
+{}
+
+void SearchWorker::run(const SearchQuery& query,
+                       const Transcript& snapshot,
+                       const SearchCancelToken& cancelToken) {
+
+    QVector<int> allMatches;
+
+    const TranscriptSearch::SpeakerFilter speakerFilter(snapshot, query.speakerFilter);
+
+    // The snapshot shares segments with the GUI thread, so never fill their
+    // shadow caches from here.
+    const TranscriptSearch::TextMatcher matcher(query.pattern, query.cs,
+                                                query.accentInsensitive, false);
+
+    QRegularExpression regex;
+    if (query.useRegex) {
+        QRegularExpression::PatternOptions options = QRegularExpression::UseUnicodePropertiesOption;
+        if (query.cs == Qt::CaseInsensitive)
+            options |= QRegularExpression::CaseInsensitiveOption;
+
+        regex = QRegularExpression(query.pattern, options);
+        if (!regex.isValid()) {
+            emit finished(query.id, allMatches, false);
+            return;
+        }
+    }
+
+    const auto& segments = snapshot.segments;
+    const int count = segments.size();
+    const int total = query.restrictToCandidates ? query.candidates.size() : count;
+
+    for (int batchStart = 0; batchStart < total; batchStart += BatchSize) {
+
+        if (cancelToken && cancelToken->loadRelaxed() != 0) {
+            emit finished(query.id, allMatches, true);
+            return;
+        }
+
+        QVector<int> batchMatches;
+        const int batchEnd = qMin(batchStart + BatchSize, total);
+
+        for (int k = batchStart; k < batchEnd; ++k) {
+            const int i = query.restrictToCandidates ? query.candidates[k] : k;
+            if (i < 0 || i >= count)
+                continue;
+
+            const Segment& seg = segments[i];
+
+            if (!speakerFilter.accepts(seg))
+                continue;
+
+            bool hit = false;
+            if (!query.useRegex)
+                hit = matcher.matches(seg);
+            else if (query.accentInsensitive)
+                hit = regex.match(TextFolding::fold(seg.text(), TextFolding::StripAccents)).hasMatch();
+            else
+                hit = regex.match(seg.text()).hasMatch();
+            if (hit)
+                batchMatches.push_back(i);
+        }
+
+        if (!batchMatches.isEmpty()) {
+            allMatches += batchMatches;
+            emit resultsPartial(query.id, batchMatches);
+        }
+    }
+
+    emit finished(query.id, allMatches, false);
+}
+
+}
@@ -0,0 +1,84 @@
+#ifndef CONTROLLER_SEARCH_WORKER_H
+#define CONTROLLER_SEARCH_WORKER_H
+
+#include "Model/Data/Transcript.h"
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QAtomicInt>
+#include <QSharedPointer>
+
+namespace Controller {
+
+/**
+ * @brief Parameters of one background search request.
+ */
+struct SearchQuery {
+    quint64 id = 0;
+    QString pattern;
+    QStringList speakerFilter;
+    Qt::CaseSensitivity cs = Qt::CaseInsensitive;
+    bool useRegex = false;
+    bool accentInsensitive = false;
+
+    // If set, only these segment indices (sorted) are checked, e.g. the
+    // candidates computed by a TrigramIndex.
+    bool restrictToCandidates = false;
+    QVector<int> candidates;
+};
+
+/**
+ * @brief Shared flag used to abort a running search.
+ *
+ * The controller sets it to 1; the worker checks it once per segment batch.
+ */
+using SearchCancelToken = QSharedPointer<QAtomicInt>;
+
+
+/**
+ * @brief Executes searches on a worker thread.
+ *
+ * Lives on the thread owned by AppController. Each query runs over its own
+ * copy of the Transcript (cheap thanks to implicit sharing), so the GUI
+ * thread can keep editing while a search is in progress. Matches are
+ * reported per batch through resultsPartial() and once more in full
+ * through finished().
+ */
+
+class SearchWorker : public QObject {
+
+    Q_OBJECT
+
+public:
+
+    /** @brief Number of segments checked between two cancellation checks. */
+    static constexpr int BatchSize = 256;
+
+    /** @brief Constructs a worker with optional parent QObject. */
+    explicit SearchWorker(QObject* parent = nullptr);
+
+    /**
+     * @brief Runs a query over snapshot. Must be called on the worker thread.
+     *
+     * Returns early (with cancelled = true in finished()) as soon as
+     * cancelToken is set.
+     */
+    void run(const SearchQuery& query,
+             const Model::Data::Transcript& snapshot,
+             const SearchCancelToken& cancelToken);
+
+Q_SIGNALS:
+
+    /** @brief Emitted after each batch that produced matches (indices of that batch only). */
+    void resultsPartial(quint64 queryId, const QVector<int>& indices);
+
+    /** @brief Emitted once per query with all matches found so far. */
+    void finished(quint64 queryId, const QVector<int>& indices, bool cancelled);
+
+};
+
+}
+
+#endif // CONTROLLER_SEARCH_WORKER_H
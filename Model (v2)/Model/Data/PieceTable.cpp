@@ -0,0 +1,229 @@
+#include "PieceTable.h"
+
+#include <QRandomGenerator>
+
+namespace Model {
+namespace Data {
+
+PieceTable::PieceTable(const QString& text) {
+
+    if (!text.isEmpty())
+        root = makeLeaf(text, 0, text.size());
+}
+
+int PieceTable::size() const {
+
+    return lengthOf(root);
+}
+
+bool PieceTable::isEmpty() const {
+
+    return lengthOf(root) == 0;
+}
+
+int PieceTable::pieceCount() const {
+
+    return piecesOf(root);
+}
+
+QChar PieceTable::at(int position) const {
+
+    const Node* node = root.data();
+
+    while (node) {
+        const int leftLength = lengthOf(node->left);
+        if (position < leftLength) {
+            node = node->left.data();
+        }
+        else if (position < leftLength + node->length) {
+            return node->buffer.at(node->start + position - leftLength);
+        }
+        else {
+            position -= leftLength + node->length;
+            node = node->right.data();
+        }
+    }
+
+    return QChar();
+}
+
+void PieceTable::insert(int position, const QString& text) {
+
+    if (text.isEmpty())
+        return;
+
+    position = qBound(0, position, size());
+
+    NodePtr left;
+    NodePtr right;
+    split(root, position, left, right);
+    root = merge(merge(left, makeLeaf(text, 0, text.size())), right);
+}
+
+void PieceTable::remove(int position, int length) {
+
+    if (position < 0) {
+        length += position;
+        position = 0;
+    }
+    if (length <= 0 || position >= size())
+        return;
+
+    NodePtr left;
+    NodePtr rest;
+    NodePtr removed;
+    NodePtr right;
+    split(root, position, left, rest);
+    split(rest, length, removed, right);
+    root = merge(left, right);
+}
+
+void PieceTable::append(const QString& text) {
+
+    if (text.isEmpty())
+        return;
+
+    root = merge(root, makeLeaf(text, 0, text.size()));
+}
+
+void PieceTable::append(const PieceTable& other) {
+
+    root = merge(root, other.root);
+}
+
+PieceTable PieceTable::splitOff(int position) {
+
+    position = qBound(0, position, size());
+
+    PieceTable tail;
+    NodePtr left;
+    split(root, position, left, tail.root);
+    root = left;
+    return tail;
+}
+
+QString PieceTable::mid(int position, int length) const {
+
+    const int total = size();
+    position = qBound(0, position, total);
+    length = qBound(0, length, total - position);
+
+    QString out;
+    out.reserve(length);
+    appendRange(root, position, length, out);
+    return out;
+}
+
+QString PieceTable::toString() const {
+
+    return mid(0, size());
+}
+
+
+// === Private helpers ===
+
+PieceTable::NodePtr PieceTable::makeNode(const QString& buffer, int start, int length, quint32 priority,
+                                         const NodePtr& left, const NodePtr& right) {
+
+    QSharedPointer<Node> node = QSharedPointer<Node>::create();
+    node->buffer = buffer;
+    node->start = start;
+    node->length = length;
+    node->priority = priority;
+    node->left = left;
+    node->right = right;
+    node->totalLength = lengthOf(left) + length + lengthOf(right);
+    node->totalPieces = piecesOf(left) + 1 + piecesOf(right);
+    return node;
+}
+
+PieceTable::NodePtr PieceTable::makeLeaf(const QString& buffer, int start, int length) {
+
+    return makeNode(buffer, start, length, QRandomGenerator::global()->generate(), NodePtr(), NodePtr());
+}
+
+int PieceTable::lengthOf(const NodePtr& node) {
+
+    return node ? node->totalLength : 0;
+}
+
+int PieceTable::piecesOf(const NodePtr& node) {
+
+    return node ? node->totalPieces : 0;
+}
+
+PieceTable::NodePtr PieceTable::merge(const NodePtr& a, const NodePtr& b) {
+
+    if (!a)
+        return b;
+    if (!b)
+        return a;
+
+    // Path copying: only the nodes along the merge spine are recreated
+    if (a->priority > b->priority)
+        return makeNode(a->buffer, a->start, a->length, a->priority, a->left, merge(a->right, b));
+
+    return makeNode(b->buffer, b->start, b->length, b->priority, merge(a, b->left), b->right);
+}
+
+void PieceTable::split(const NodePtr& node, int position, NodePtr& outLeft, NodePtr& outRight) {
+
+    if (!node) {
+        outLeft.reset();
+        outRight.reset();
+        return;
+    }
+
+    const int leftLength = lengthOf(node->left);
+
+    if (position <= leftLength) {
+        NodePtr inner;
+        split(node->left, position, outLeft, inner);
+        outRight = makeNode(node->buffer, node->start, node->length, node->priority, inner, node->right);
+        return;
+    }
+
+    if (position >= leftLength + node->length) {
+        NodePtr inner;
+        split(node->right, position - leftLength - node->length, inner, outRight);
+        outLeft = makeNode(node->buffer, node->start, node->length, node->priority, node->left, inner);
+        return;
+    }
+
+    // The cut falls inside this node's piece: both halves share its buffer
+    const int offset = position - leftLength;
+    outLeft = merge(node->left, makeLeaf(node->buffer, node->start, offset));
+    outRight = merge(makeLeaf(node->buffer, node->start + offset, node->length - offset), node->right);
+}
+
+void PieceTable::appendRange(const NodePtr& node, int position, int length, QString& out) {
+
+    if (!node || length <= 0)
+        return;
+
+    const int leftLength = lengthOf(node->left);
+
+    if (position < leftLength) {
+        const int take = qMin(length, leftLength - position);
+        appendRange(node->left, position, take, out);
+        position += take;
+        length -= take;
+    }
+    if (length <= 0)
+        return;
+
+    const int inPiece = position - leftLength;
+    if (inPiece < node->length) {
+        const int take = qMin(length, node->length - inPiece);
+        out.append(QStringView(node->buffer).mid(node->start + inPiece, take));
+        position += take;
+        length -= take;
+    }
+    if (length <= 0)
+        return;
+
+    appendRange(node->right, position - leftLength - node->length, length, out);
+}
+
+}
+}
@@ -0,0 +1,110 @@
+#ifndef MODEL_DATA_PIECE_TABLE_H
+#define MODEL_DATA_PIECE_TABLE_H
+
+#include <QString>
+#include <QSharedPointer>
+
+namespace Model {
+namespace Data {
+
+/**
+ * @brief Persistent piece table for long texts.
+ *
+ * The text is a sequence of pieces, each a range of an immutable QString
+ * buffer. Pieces are kept in a balanced tree (treap) ordered by position and
+ * annotated with subtree lengths, so insert, remove, split and append cost
+ * O(log n) in the number of pieces instead of copying the whole text.
+ *
+ * Nodes and buffers are never modified once created: copying a PieceTable is
+ * O(1) and copies can be read from other threads while the original is
+ * edited.
+ */
+
+class PieceTable {
+
+public:
+
+    /** @brief Constructs an empty table. */
+    PieceTable() = default;
+
+    /** @brief Constructs a table holding text as a single piece. */
+    explicit PieceTable(const QString& text);
+
+    /** @brief Returns the text length in UTF-16 code units. */
+    int size() const;
+
+    /** @brief Returns true if the text is empty. */
+    bool isEmpty() const;
+
+    /** @brief Returns the number of pieces (a measure of fragmentation). */
+    int pieceCount() const;
+
+    /** @brief Returns the character at position (0 <= position < size()). */
+    QChar at(int position) const;
+
+    /** @brief Inserts text before position (clamped to [0, size()]). */
+    void insert(int position, const QString& text);
+
+    /** @brief Removes up to length characters starting at position. */
+    void remove(int position, int length);
+
+    /** @brief Appends text at the end. */
+    void append(const QString& text);
+
+    /** @brief Appends the content of other at the end (shares its pieces). */
+    void append(const PieceTable& other);
+
+    /**
+     * @brief Splits the text at position.
+     *
+     * This table keeps [0, position); the returned table holds the rest.
+     */
+    PieceTable splitOff(int position);
+
+    /** @brief Returns length characters starting at position as a QString. */
+    QString mid(int position, int length) const;
+
+    /** @brief Returns the whole text as a single QString. */
+    QString toString() const;
+
+private:
+
+    struct Node;
+    using NodePtr = QSharedPointer<const Node>;
+
+    struct Node {
+        QString buffer;
+        int start = 0;
+        int length = 0;
+
+        quint32 priority = 0;
+        NodePtr left;
+        NodePtr right;
+
+        int totalLength = 0;   // Characters in this subtree
+        int totalPieces = 0;   // Pieces in this subtree
+    };
+
+    static NodePtr makeNode(const QString& buffer, int start, int length, quint32 priority,
+                            const NodePtr& left, const NodePtr& right);
+    static NodePtr makeLeaf(const QString& buffer, int start, int length);
+
+    static int lengthOf(const NodePtr& node);
+    static int piecesOf(const NodePtr& node);
+
+    /** @brief Concatenates two trees (all of a before all of b). */
+    static NodePtr merge(const NodePtr& a, const NodePtr& b);
+
+    /** @brief Splits a tree into the first position characters and the rest. */
+    static void split(const NodePtr& node, int position, NodePtr& outLeft, NodePtr& outRight);
+
+    /** @brief Appends the characters [position, position + length) of the subtree to out. */
+    static void appendRange(const NodePtr& node, int position, int length, QString& out);
+
+    NodePtr root;
+};
+
+}
+}
+
+#endif // MODEL_DATA_PIECE_TABLE_H
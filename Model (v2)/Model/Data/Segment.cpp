@@ -3,40 +3,389 @@
 namespace Model {
 namespace Data {
 
-Segment::Segment(const QString& speakerID,
+Segment::Segment(int speaker,
                  const QString& text)
-    : speakerID(speakerID),
-    text(text)
+    : speaker(speaker),
+    plainText(text)
 {}
 
 bool Segment::isValid() const {
 
-    return !speakerID.isEmpty() && !text.trimmed().isEmpty();
+    return speaker >= 0 && !text().trimmed().isEmpty();
 }
 
 bool Segment::startsWithLabel() const {
 
     // A label ends with ":" — simple heuristic
-    return text.contains(":") && text.indexOf(":") < text.indexOf(" ");
+    const QString& t = text();
+    return t.contains(":") && t.indexOf(":") < t.indexOf(" ");
 }
 
 void Segment::appendText(const QString& extra) {
 
     if (extra.isEmpty())
         return;
-    if (!text.endsWith("\n"))
-        text.append("\n");
-    text.append(extra);
+
+    expand();
+
+    preparePieces();
+
+    if (usesPieces) {
+        if (lastChar() != QLatin1Char('\n'))
+            pieces.append(QStringLiteral("\n"));
+        pieces.append(extra);
+        piecesChanged();
+        return;
+    }
+
+    if (!plainText.endsWith("\n"))
+        plainText.append("\n");
+    plainText.append(extra);
+    invalidateCaches();
 }
 
 QString Segment::cleanText() const {
 
-    return text.trimmed();
+    return text().trimmed();
+}
+
+QString Segment::exportFormat(const QString& speakerID) const {
+
+    return speakerID + ":\n" + text().trimmed() + "\n\n";
+}
+
+void Segment::invalidateCaches() {
+
+    foldedText.clear();
+    foldedOptions = -1;
+    exportText = QString();
+    exportSpeakerID = QString();
+}
+
+
+// === Text ===
+
+const QString& Segment::text() const {
+
+    if (!usesPieces && textStorage == Storage::Utf16)
+        return plainText;
+
+    QMutexLocker lock(&flat->mutex);
+    if (!flat->valid) {
+        flat->text = usesPieces ? pieces.toString() : decodeCompact();
+        flat->valid = true;
+    }
+    return flat->text;
+}
+
+int Segment::textLength() const {
+
+    if (textStorage != Storage::Utf16)
+        return compactLength;
+
+    return usesPieces ? pieces.size() : plainText.size();
+}
+
+QString Segment::textMid(int position, int length) const {
+
+    if (textStorage != Storage::Utf16)
+        return decodeCompact().mid(position, length);
+
+    return usesPieces ? pieces.mid(position, length) : plainText.mid(position, length);
+}
+
+void Segment::setText(const QString& newText) {
+
+    compactText = QByteArray();
+    compactLength = 0;
+    textStorage = Storage::Utf16;
+    plainText = newText;
+    pieces = PieceTable();
+    usesPieces = false;
+    flat.reset();
+    invalidateCaches();
+}
+
+void Segment::insertText(int position, const QString& inserted) {
+
+    if (inserted.isEmpty())
+        return;
+
+    expand();
+    position = qBound(0, position, textLength());
+    preparePieces();
+
+    if (usesPieces) {
+        pieces.insert(position, inserted);
+        piecesChanged();
+        return;
+    }
+
+    plainText.insert(position, inserted);
+    invalidateCaches();
+}
+
+void Segment::removeText(int position, int length) {
+
+    if (length <= 0)
+        return;
+
+    expand();
+    preparePieces();
+
+    if (usesPieces) {
+        pieces.remove(position, length);
+        piecesChanged();
+        return;
+    }
+
+    plainText.remove(position, length);
+    invalidateCaches();
+}
+
+Segment Segment::splitOff(int position) {
+
+    expand();
+    position = qBound(0, position, textLength());
+    preparePieces();
+
+    Segment tail(speaker, QString());
+
+    if (usesPieces) {
+        tail.pieces = pieces.splitOff(position);
+        tail.usesPieces = true;
+        tail.piecesChanged();
+        piecesChanged();
+        return tail;
+    }
+
+    tail.setText(plainText.mid(position));
+    plainText.truncate(position);
+    invalidateCaches();
+    return tail;
+}
+
+void Segment::appendSegmentText(const Segment& other) {
+
+    expand();
+
+    // Merging into or from a long text: share the other side's pieces
+    if (other.usesPieces)
+        ensurePieces();
+    else
+        preparePieces();
+
+    if (usesPieces) {
+        if (textLength() > 0 && lastChar() != QLatin1Char('\n'))
+            pieces.append(QStringLiteral("\n"));
+        if (other.usesPieces)
+            pieces.append(other.pieces);
+        else
+            pieces.append(other.text());
+        piecesChanged();
+        return;
+    }
+
+    if (!plainText.isEmpty() && !plainText.endsWith("\n"))
+        plainText.append('\n');
+    plainText.append(other.text());
+    invalidateCaches();
+}
+
+void Segment::trim() {
+
+    expand();
+
+    if (!usesPieces) {
+        const QString trimmedText = plainText.trimmed();
+        if (trimmedText.size() != plainText.size())
+            setText(trimmedText);
+        return;
+    }
+
+    const int length = pieces.size();
+
+    int begin = 0;
+    int end = length;
+    trimmedBounds(begin, end);
+
+    if (begin == 0 && end == length)
+        return;
+
+    pieces.remove(end, length - end);
+    pieces.remove(0, begin);
+    piecesChanged();
+}
+
+void Segment::trimmedBounds(int& outBegin, int& outEnd) const {
+
+    const int length = textLength();
+    const QString flatText = usesPieces ? QString() : text();
+    const auto at = [&](int position) {
+        return usesPieces ? pieces.at(position) : flatText.at(position);
+    };
+
+    outBegin = 0;
+    while (outBegin < length && at(outBegin).isSpace())
+        ++outBegin;
+
+    outEnd = length;
+    while (outEnd > outBegin && at(outEnd - 1).isSpace())
+        --outEnd;
+}
+
+bool Segment::isPieceBacked() const {
+
+    return usesPieces;
+}
+
+
+// === Compact storage ===
+
+void Segment::compact() {
+
+    if (textStorage != Storage::Utf16) {
+        // Drop the decoded copy left by text(). Copies of this segment (a
+        // search snapshot, an undo version) may still be reading it, so
+        // detach from it instead of clearing it
+        bool decoded = false;
+        {
+            QMutexLocker lock(&flat->mutex);
+            decoded = flat->valid;
+        }
+        if (decoded)
+            flat = QSharedPointer<FlatText>::create();
+        exportText = QString();
+        exportSpeakerID = QString();
+        return;
+    }
+
+    const QString source = text();
+
+    bool latin1 = true;
+    for (qsizetype i = 0; i < source.size(); ++i) {
+        const QChar c = source.at(i);
+        if (c.unicode() <= 0xff)
+            continue;
+
+        latin1 = false;
+
+        // UTF-8 cannot hold a lone surrogate: keep such text as it is
+        if (c.isHighSurrogate() && i + 1 < source.size() && source.at(i + 1).isLowSurrogate())
+            ++i;
+        else if (c.isSurrogate())
+            return;
+    }
+
+    QByteArray bytes = latin1 ? source.toLatin1() : source.toUtf8();
+
+    // Mostly non-Latin text (e.g. CJK) is smaller as UTF-16
+    if (!latin1 && bytes.size() >= source.size() * 2)
+        return;
+
+    compactText = bytes;
+    compactLength = source.size();
+    textStorage = latin1 ? Storage::Latin1 : Storage::Utf8;
+
+    plainText = QString();
+    pieces = PieceTable();
+    usesPieces = false;
+    flat = QSharedPointer<FlatText>::create();
+
+    // The folded shadow is rebuilt on demand if this segment is searched again
+    invalidateCaches();
+}
+
+void Segment::expand() {
+
+    if (textStorage == Storage::Utf16)
+        return;
+
+    plainText = decodeCompact();
+    compactText = QByteArray();
+    compactLength = 0;
+    textStorage = Storage::Utf16;
+    flat.reset();
+}
+
+Segment::Storage Segment::storage() const {
+
+    return textStorage;
+}
+
+const QByteArray& Segment::compactBytes() const {
+
+    return compactText;
+}
+
+qsizetype Segment::textMemoryBytes() const {
+
+    qsizetype bytes = textStorage != Storage::Utf16
+                          ? compactText.size()
+                          : qsizetype(textLength()) * qsizetype(sizeof(QChar));
+
+    if (flat) {
+        QMutexLocker lock(&flat->mutex);
+        if (flat->valid)
+            bytes += flat->text.size() * qsizetype(sizeof(QChar));
+    }
+
+    bytes += exportText.size() * qsizetype(sizeof(QChar));
+    return bytes + foldedText.size() * qsizetype(sizeof(QChar));
+}
+
+
+// === Private helpers ===
+
+void Segment::preparePieces() {
+
+    if (!usesPieces && plainText.size() >= PieceTableThreshold)
+        ensurePieces();
+}
+
+void Segment::ensurePieces() {
+
+    if (usesPieces)
+        return;
+
+    // Shares plainText's buffer, no copy
+    pieces = PieceTable(plainText);
+    plainText.clear();
+    usesPieces = true;
+    flat.reset();
+}
+
+void Segment::piecesChanged() {
+
+    if (pieces.size() < PieceTableThreshold / 2) {
+        // Short again: plain strings are cheaper
+        plainText = pieces.toString();
+        pieces = PieceTable();
+        usesPieces = false;
+        flat.reset();
+    }
+    else {
+        // Many tiny pieces (e.g. one per keystroke): repack into one buffer
+        if (pieces.pieceCount() > MaxPieces)
+            pieces = PieceTable(pieces.toString());
+        flat = QSharedPointer<FlatText>::create();
+    }
+
+    invalidateCaches();
+}
+
+QString Segment::decodeCompact() const {
+
+    return textStorage == Storage::Latin1 ? QString::fromLatin1(compactText)
+                                          : QString::fromUtf8(compactText);
 }
 
-QString Segment::exportFormat() const {
+QChar Segment::lastChar() const {
 
-    return speakerID + ":\n" + text.trimmed() + "\n\n";
+    const int length = textLength();
+    if (length == 0)
+        return QChar();
+    return usesPieces ? pieces.at(length - 1) : plainText.at(length - 1);
 }
 
 }
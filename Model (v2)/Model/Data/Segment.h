@@ -1,6 +1,11 @@
 #ifndef MODEL_DATA_SEGMENT_H
 #define MODEL_DATA_SEGMENT_H
 
+#include "PieceTable.h"
+
+#include <QByteArray>
+#include <QMutex>
+#include <QSharedPointer>
 #include <QString>
 
 namespace Model {
@@ -9,8 +14,27 @@ namespace Data {
 /**
  * @brief Represents a single block of transcript text spoken by one speaker.
  *
- * Contains the speaker identifier and the full text for that segment.
+ * Contains the speaker handle and the full text for that segment.
  * Used as a simple data container within the Transcript model.
+ *
+ * The speaker is stored as an interned handle (index into the owning
+ * Transcript::speakers), not as a string. Use Transcript::speakerIDOf() to
+ * get the speaker name.
+ *
+ * Each segment also carries a stable ID (see Transcript::assignSegmentID()).
+ * Unlike its index, the ID survives inserts, removals and moves of other
+ * segments, and it is restored together with the segment by undo/redo.
+ *
+ * Text is accessed through text()/setText() and the incremental edit
+ * functions. Long texts (see PieceTableThreshold) switch to a PieceTable on
+ * their first incremental edit, so inserts, removals, splits and merges no
+ * longer copy the whole string; text() then flattens on demand and caches
+ * the result until the next edit.
+ *
+ * Segments of transcripts that are not being shown can be compacted (see
+ * compact()): the text is then held as Latin-1 bytes when every character
+ * fits, or as UTF-8 otherwise, roughly halving its memory for mostly-ASCII
+ * text. Any edit expands it back to a QString.
  */
 
 class Segment {
@@ -21,17 +45,101 @@ public:
     Segment() = default;
 
     /**
-     * @brief Constructs a segment with a speaker ID and text.
-     * @param speakerID The identifier of the speaker (e.g. "Stephen").
+     * @brief Constructs a segment with a speaker handle and text.
+     * @param speaker Handle from Transcript::internSpeaker().
      * @param text The text spoken in this segment.
      */
-    Segment(const QString& speakerID, const QString& text);
+    Segment(int speaker, const QString& text);
+
+
+    /** @brief Text length from which incremental edits use a PieceTable. */
+    static constexpr int PieceTableThreshold = 16 * 1024;
 
+    /** @brief Piece count above which a piece-backed text is repacked. */
+    static constexpr int MaxPieces = 1024;
 
-    /** @brief Checks if the segment contains valid (non-empty) speaker and text. */
+    /** @brief How the text is currently held. */
+    enum class Storage : quint8 {
+        Utf16,   // QString (plain or piece table)
+        Latin1,  // Compact: one byte per character
+        Utf8     // Compact: UTF-8 bytes
+    };
+
+
+    /** @brief Checks if the segment has a speaker handle and non-empty text. */
     bool isValid() const;
 
 
+    // === Text ===
+
+    /**
+     * @brief Returns the full text.
+     *
+     * For piece-backed texts the first call after an edit flattens the
+     * pieces; the result is shared by copies of this segment and safe to
+     * request from any thread.
+     */
+    const QString& text() const;
+
+    /** @brief Returns the text length without flattening. */
+    int textLength() const;
+
+    /** @brief Returns length characters starting at position, without flattening piece-backed text. */
+    QString textMid(int position, int length) const;
+
+    /** @brief Replaces the whole text. */
+    void setText(const QString& newText);
+
+    /** @brief Inserts inserted before position. */
+    void insertText(int position, const QString& inserted);
+
+    /** @brief Removes length characters starting at position. */
+    void removeText(int position, int length);
+
+    /**
+     * @brief Splits the text at position.
+     *
+     * This segment keeps [0, position); the returned segment has the same
+     * speaker and the rest of the text.
+     */
+    Segment splitOff(int position);
+
+    /** @brief Appends other's text, separated by a newline unless this text is empty or ends with one. */
+    void appendSegmentText(const Segment& other);
+
+    /** @brief Removes leading and trailing whitespace. */
+    void trim();
+
+    /** @brief Returns the range [outBegin, outEnd) of the text that trim() keeps. */
+    void trimmedBounds(int& outBegin, int& outEnd) const;
+
+    /** @brief Returns true if the text is currently stored in a PieceTable. */
+    bool isPieceBacked() const;
+
+
+    // === Compact storage ===
+
+    /**
+     * @brief Stores the text as Latin-1 or UTF-8 bytes instead of UTF-16.
+     *
+     * Keeps UTF-16 if the UTF-8 form would not be smaller. On an already
+     * compact segment this drops the QString decoded by text(), if any.
+     */
+    void compact();
+
+    /** @brief Returns the text to QString storage. */
+    void expand();
+
+    /** @brief Returns how the text is currently held. */
+    Storage storage() const;
+
+    /** @brief Returns the compact bytes (empty unless storage() is Latin1 or Utf8). */
+    const QByteArray& compactBytes() const;
+
+    /** @brief Returns the approximate heap size of the text and its cached copies. */
+    qsizetype textMemoryBytes() const;
+
+
     /** @brief Checks whether the text begins with a speaker label (e.g. "Stephen:"). */
     bool startsWithLabel() const;
 
@@ -41,14 +149,73 @@ public:
     /** @brief Returns the cleaned (trimmed) text for display or processing. */
     QString cleanText() const;
 
-    /** @brief Returns this segment in exportable text format ("Speaker:\ntext\n\n"). */
-    QString exportFormat() const;
+    /**
+     * @brief Returns this segment in exportable text format ("Speaker:\ntext\n\n").
+     * @param speakerID Resolved speaker name (see Transcript::speakerIDOf()).
+     */
+    QString exportFormat(const QString& speakerID) const;
+
+    /**
+     * @brief Drops cached data derived from text.
+     *
+     * Called by every text modifier of this class.
+     */
+    void invalidateCaches();
 
 
     // === Data Members ===
 
-    QString speakerID;
-    QString text;
+    int speaker = -1;   // Handle into Transcript::speakers, -1 if none
+    quint64 id = 0;     // Stable ID within the owning transcript, 0 if unassigned
+
+    // === Derived caches (not saved) ===
+
+    // Folded shadow of text for insensitive search, filled lazily by
+    // Model::Service::TranscriptSearch. foldedOptions is -1 while empty.
+    // Only touched from the GUI thread; background readers fold on the fly.
+    mutable QString foldedText;
+    mutable int foldedOptions = -1;
+
+    // Serialized form of this segment in transcript files, filled lazily by
+    // Model::Service::TranscriptExporter for exportSpeakerID. Valid while
+    // exportSpeakerID is non-null; an empty exportText means the segment is
+    // skipped (blank text).
+    mutable QString exportText;
+    mutable QString exportSpeakerID;
+
+private:
+
+    // Flattened piece text, computed once per edit. A new instance is
+    // created on every modification, so copies never see each other's edits.
+    struct FlatText {
+        QMutex mutex;
+        bool valid = false;
+        QString text;
+    };
+
+    /** @brief Switches to a PieceTable if the text is long enough. */
+    void preparePieces();
+
+    /** @brief Switches to a PieceTable regardless of length. */
+    void ensurePieces();
+
+    /** @brief Repacks or flattens the pieces after an edit and drops caches. */
+    void piecesChanged();
+
+    /** @brief Returns the last character, or a null QChar if empty. */
+    QChar lastChar() const;
+
+    /** @brief Returns the compact bytes as a QString. */
+    QString decodeCompact() const;
+
+    QString plainText;
+    PieceTable pieces;
+    bool usesPieces = false;
+    QSharedPointer<FlatText> flat;   // Flattened pieces or decoded compact text
+
+    QByteArray compactText;
+    int compactLength = 0;           // Length in UTF-16 code units
+    Storage textStorage = Storage::Utf16;
 };
 
 }
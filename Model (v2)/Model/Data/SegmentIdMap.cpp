@@ -0,0 +1,255 @@
+#include "SegmentIdMap.h"
+
+#include <QRandomGenerator>
+
+namespace Model {
+namespace Data {
+
+void SegmentIdMap::build(const SegmentList& segments) {
+
+    clear();
+
+    nodes.reserve(segments.size());
+    nodeByID.reserve(segments.size());
+
+    root = buildSubtree(segments, 0, segments.size());
+    if (root >= 0)
+        nodes[root].parent = -1;
+}
+
+void SegmentIdMap::clear() {
+
+    nodes.clear();
+    freeNodes.clear();
+    nodeByID.clear();
+    root = -1;
+}
+
+int SegmentIdMap::size() const {
+
+    return sizeOf(root);
+}
+
+bool SegmentIdMap::contains(quint64 id) const {
+
+    return nodeByID.contains(id);
+}
+
+quint64 SegmentIdMap::idAt(int position) const {
+
+    if (position < 0 || position >= size())
+        return 0;
+
+    int node = root;
+
+    while (node >= 0) {
+        const int leftSize = sizeOf(nodes[node].left);
+        if (position < leftSize) {
+            node = nodes[node].left;
+        }
+        else if (position == leftSize) {
+            return nodes[node].id;
+        }
+        else {
+            position -= leftSize + 1;
+            node = nodes[node].right;
+        }
+    }
+
+    return 0;
+}
+
+int SegmentIdMap::positionOf(quint64 id) const {
+
+    const auto it = nodeByID.constFind(id);
+    if (it == nodeByID.constEnd())
+        return -1;
+
+    // Rank = entries left of the node, plus every ancestor reached from the right
+    int node = it.value();
+    int position = sizeOf(nodes[node].left);
+
+    while (nodes[node].parent >= 0) {
+        const int parent = nodes[node].parent;
+        if (nodes[parent].right == node)
+            position += sizeOf(nodes[parent].left) + 1;
+        node = parent;
+    }
+
+    return position;
+}
+
+bool SegmentIdMap::segmentsReplaced(const SegmentList& segments,
+                                    int first,
+                                    int removedCount,
+                                    int insertedCount) {
+
+    if (first < 0 || removedCount < 0 || insertedCount < 0
+        || first + removedCount > size()
+        || first + insertedCount > segments.size()) {
+        clear();
+        return false;
+    }
+
+    int left = -1;
+    int rest = -1;
+    int removed = -1;
+    int right = -1;
+    split(root, first, left, rest);
+    split(rest, removedCount, removed, right);
+
+    freeSubtree(removed);
+
+    const int inserted = buildSubtree(segments, first, insertedCount);
+
+    root = merge(merge(left, inserted), right);
+    if (root >= 0)
+        nodes[root].parent = -1;
+
+    if (size() != segments.size()) {
+        clear();
+        return false;
+    }
+
+    return true;
+}
+
+
+// === Private helpers ===
+
+int SegmentIdMap::allocNode(quint64 id) {
+
+    int node;
+    if (!freeNodes.isEmpty()) {
+        node = freeNodes.takeLast();
+        nodes[node] = Node();
+    }
+    else {
+        node = nodes.size();
+        nodes.push_back(Node());
+    }
+
+    nodes[node].id = id;
+    nodes[node].priority = QRandomGenerator::global()->generate();
+    nodeByID.insert(id, node);
+    return node;
+}
+
+void SegmentIdMap::freeSubtree(int node) {
+
+    if (node < 0)
+        return;
+
+    QVector<int> pending{ node };
+
+    while (!pending.isEmpty()) {
+        const int current = pending.takeLast();
+        if (nodes[current].left >= 0)
+            pending.push_back(nodes[current].left);
+        if (nodes[current].right >= 0)
+            pending.push_back(nodes[current].right);
+
+        nodeByID.remove(nodes[current].id);
+        freeNodes.push_back(current);
+    }
+}
+
+int SegmentIdMap::buildSubtree(const SegmentList& segments, int first, int count) {
+
+    // Cartesian tree construction in O(count): the stack holds the right
+    // spine. A node popped off the spine is final, so it is sized right away.
+    QVector<int> spine;
+
+    for (int i = first; i < first + count; ++i) {
+        const int node = allocNode(segments[i].id);
+
+        int lastPopped = -1;
+        while (!spine.isEmpty() && nodes[spine.last()].priority < nodes[node].priority) {
+            lastPopped = spine.takeLast();
+            update(lastPopped);
+        }
+
+        nodes[node].left = lastPopped;
+        if (!spine.isEmpty())
+            nodes[spine.last()].right = node;
+
+        spine.push_back(node);
+    }
+
+    if (spine.isEmpty())
+        return -1;
+
+    for (int k = spine.size() - 1; k >= 0; --k)
+        update(spine[k]);
+
+    nodes[spine.first()].parent = -1;
+    return spine.first();
+}
+
+int SegmentIdMap::sizeOf(int node) const {
+
+    return node >= 0 ? nodes[node].size : 0;
+}
+
+void SegmentIdMap::update(int node) {
+
+    Node& n = nodes[node];
+    n.size = 1 + sizeOf(n.left) + sizeOf(n.right);
+
+    if (n.left >= 0)
+        nodes[n.left].parent = node;
+    if (n.right >= 0)
+        nodes[n.right].parent = node;
+}
+
+int SegmentIdMap::merge(int a, int b) {
+
+    if (a < 0)
+        return b;
+    if (b < 0)
+        return a;
+
+    if (nodes[a].priority > nodes[b].priority) {
+        nodes[a].right = merge(nodes[a].right, b);
+        update(a);
+        return a;
+    }
+
+    nodes[b].left = merge(a, nodes[b].left);
+    update(b);
+    return b;
+}
+
+void SegmentIdMap::split(int node, int count, int& outLeft, int& outRight) {
+
+    if (node < 0) {
+        outLeft = -1;
+        outRight = -1;
+        return;
+    }
+
+    const int leftSize = sizeOf(nodes[node].left);
+
+    if (count <= leftSize) {
+        int inner = -1;
+        split(nodes[node].left, count, outLeft, inner);
+        nodes[node].left = inner;
+        update(node);
+        outRight = node;
+    }
+    else {
+        int inner = -1;
+        split(nodes[node].right, count - leftSize - 1, inner, outRight);
+        nodes[node].right = inner;
+        update(node);
+        outLeft = node;
+    }
+
+    if (outLeft >= 0)
+        nodes[outLeft].parent = -1;
+    if (outRight >= 0)
+        nodes[outRight].parent = -1;
+}
+
+}
+}
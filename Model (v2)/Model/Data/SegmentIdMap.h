@@ -0,0 +1,102 @@
+#ifndef MODEL_DATA_SEGMENT_ID_MAP_H
+#define MODEL_DATA_SEGMENT_ID_MAP_H
+
+#include "SegmentList.h"
+
+#include <QHash>
+#include <QVector>
+
+namespace Model {
+namespace Data {
+
+/**
+ * @brief Order-statistics map between stable segment IDs and positions.
+ *
+ * Holds the segment IDs of a transcript in order, in an implicit treap whose
+ * nodes know their subtree size and parent. idAt() walks down from the root
+ * and positionOf() walks up from the ID's node, both in O(log n), so a
+ * segment can be found again after inserts, removals and moves shift every
+ * index behind it.
+ *
+ * The map is kept in sync through segmentsReplaced(), using the same change
+ * ranges as the search structures.
+ */
+
+class SegmentIdMap {
+
+public:
+
+    /** @brief Constructs an empty map. */
+    SegmentIdMap() = default;
+
+    /** @brief Loads the IDs of segments, replacing previous content. */
+    void build(const SegmentList& segments);
+
+    /** @brief Drops all entries. */
+    void clear();
+
+    /** @brief Returns the number of entries. */
+    int size() const;
+
+    /** @brief Returns true if id is in the map. */
+    bool contains(quint64 id) const;
+
+    /** @brief Returns the ID at position, or 0 if position is out of range. */
+    quint64 idAt(int position) const;
+
+    /** @brief Returns the position of id, or -1 if it is not in the map. */
+    int positionOf(quint64 id) const;
+
+    /**
+     * @brief Mirrors a replaced segment range.
+     *
+     * Entries [first, first + removedCount) are replaced by the IDs of
+     * segments [first, first + insertedCount) of the current state.
+     * @return false (and leaves the map empty) if the range does not fit.
+     */
+    bool segmentsReplaced(const SegmentList& segments,
+                          int first,
+                          int removedCount,
+                          int insertedCount);
+
+private:
+
+    struct Node {
+        quint64 id = 0;
+        quint32 priority = 0;
+        int left = -1;
+        int right = -1;
+        int parent = -1;
+        int size = 1;
+    };
+
+    /** @brief Returns a node for id from the free list or a new slot. */
+    int allocNode(quint64 id);
+
+    /** @brief Frees every node of a subtree and drops their IDs. */
+    void freeSubtree(int node);
+
+    /** @brief Builds a subtree holding ids[first, first + count) in order. */
+    int buildSubtree(const SegmentList& segments, int first, int count);
+
+    int sizeOf(int node) const;
+
+    /** @brief Recomputes size and re-links the children of node. */
+    void update(int node);
+
+    /** @brief Concatenates two subtrees (all of a before all of b). */
+    int merge(int a, int b);
+
+    /** @brief Splits a subtree into the first count entries and the rest. */
+    void split(int node, int count, int& outLeft, int& outRight);
+
+    QVector<Node> nodes;
+    QVector<int> freeNodes;
+    QHash<quint64, int> nodeByID;
+    int root = -1;
+};
+
+}
+}
+
+#endif // MODEL_DATA_SEGMENT_ID_MAP_H
@@ -0,0 +1,244 @@
+#include "SegmentList.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace Model {
+namespace Data {
+
+SegmentList::SegmentList(const QVector<Segment>& segments) {
+
+    // Half-full chunks leave room for inserts before the first split
+    const int step = ChunkCapacity / 2;
+
+    chunks.reserve(segments.size() / step + 1);
+    for (int first = 0; first < segments.size(); first += step)
+        chunks.push_back(segments.mid(first, step));
+
+    refreshEnds(0);
+}
+
+int SegmentList::size() const {
+
+    return chunkEnds.isEmpty() ? 0 : chunkEnds.last();
+}
+
+bool SegmentList::isEmpty() const {
+
+    return chunks.isEmpty();
+}
+
+const Segment& SegmentList::at(int index) const {
+
+    Q_ASSERT_X(index >= 0 && index < size(), "SegmentList::at", "index out of range");
+
+    int chunk = 0;
+    int offset = 0;
+    locate(index, chunk, offset);
+    return chunks.at(chunk).at(offset);
+}
+
+const Segment& SegmentList::operator[](int index) const {
+
+    return at(index);
+}
+
+Segment& SegmentList::operator[](int index) {
+
+    Q_ASSERT_X(index >= 0 && index < size(), "SegmentList::operator[]", "index out of range");
+
+    int chunk = 0;
+    int offset = 0;
+    locate(index, chunk, offset);
+    return chunks[chunk][offset];
+}
+
+const Segment& SegmentList::last() const {
+
+    return chunks.last().last();
+}
+
+Segment& SegmentList::last() {
+
+    return chunks.last().last();
+}
+
+void SegmentList::push_back(const Segment& segment) {
+
+    push_back(Segment(segment));
+}
+
+void SegmentList::push_back(Segment&& segment) {
+
+    if (chunks.isEmpty() || chunks.last().size() >= ChunkCapacity) {
+        chunks.push_back(QVector<Segment>());
+        chunks.last().reserve(ChunkCapacity);
+        chunkEnds.push_back(size());
+    }
+
+    chunks.last().push_back(std::move(segment));
+    ++chunkEnds.last();
+}
+
+void SegmentList::insert(int index, const Segment& segment) {
+
+    if (index >= size()) {
+        push_back(segment);
+        return;
+    }
+
+    int chunk = 0;
+    int offset = 0;
+    locate(qMax(0, index), chunk, offset);
+
+    chunks[chunk].insert(offset, segment);
+    chunkResized(chunk);
+}
+
+void SegmentList::removeAt(int index) {
+
+    remove(index, 1);
+}
+
+void SegmentList::remove(int index, int count) {
+
+    count = qMin(count, size() - index);
+
+    while (count > 0) {
+        int chunk = 0;
+        int offset = 0;
+        locate(index, chunk, offset);
+
+        const int take = qMin(count, chunks.at(chunk).size() - offset);
+        chunks[chunk].remove(offset, take);
+        count -= take;
+
+        chunkResized(chunk);
+    }
+}
+
+Segment SegmentList::takeAt(int index) {
+
+    int chunk = 0;
+    int offset = 0;
+    locate(index, chunk, offset);
+
+    Segment taken = std::move(chunks[chunk][offset]);
+    chunks[chunk].removeAt(offset);
+    chunkResized(chunk);
+    return taken;
+}
+
+void SegmentList::swapItemsAt(int indexA, int indexB) {
+
+    if (indexA == indexB)
+        return;
+
+    // Detach both chunks first so neither reference is invalidated
+    Segment& a = (*this)[indexA];
+    Segment& b = (*this)[indexB];
+    std::swap(a, b);
+}
+
+void SegmentList::clear() {
+
+    chunks.clear();
+    chunkEnds.clear();
+}
+
+QVector<Segment> SegmentList::toVector() const {
+
+    QVector<Segment> out;
+    out.reserve(size());
+
+    for (const QVector<Segment>& chunk : chunks)
+        out.append(chunk);
+
+    return out;
+}
+
+SegmentList::iterator SegmentList::begin() {
+
+    return iterator(this, 0, 0);
+}
+
+SegmentList::iterator SegmentList::end() {
+
+    return iterator(this, chunks.size(), 0);
+}
+
+SegmentList::const_iterator SegmentList::begin() const {
+
+    return const_iterator(this, 0, 0);
+}
+
+SegmentList::const_iterator SegmentList::end() const {
+
+    return const_iterator(this, chunks.size(), 0);
+}
+
+SegmentList::const_iterator SegmentList::cbegin() const {
+
+    return begin();
+}
+
+SegmentList::const_iterator SegmentList::cend() const {
+
+    return end();
+}
+
+
+// === Private helpers ===
+
+void SegmentList::locate(int index, int& outChunk, int& outOffset) const {
+
+    const auto it = std::upper_bound(chunkEnds.cbegin(), chunkEnds.cend(), index);
+    outChunk = int(it - chunkEnds.cbegin());
+    outOffset = index - (outChunk > 0 ? chunkEnds.at(outChunk - 1) : 0);
+}
+
+void SegmentList::chunkResized(int chunk) {
+
+    const int chunkSize = chunks.at(chunk).size();
+
+    if (chunkSize == 0) {
+        chunks.removeAt(chunk);
+        chunkEnds.removeAt(chunk);
+    }
+    else if (chunkSize > ChunkCapacity) {
+        const int half = chunkSize / 2;
+        QVector<Segment> tail = chunks.at(chunk).mid(half);
+        chunks[chunk].resize(half);
+        chunks.insert(chunk + 1, tail);
+        chunkEnds.insert(chunk + 1, 0);
+    }
+    else if (chunkSize < MinChunkSize) {
+        // Fold into a neighbour if the result still fits
+        if (chunk + 1 < chunks.size() && chunkSize + chunks.at(chunk + 1).size() <= ChunkCapacity) {
+            chunks[chunk].append(chunks.at(chunk + 1));
+            chunks.removeAt(chunk + 1);
+            chunkEnds.removeAt(chunk + 1);
+        }
+        else if (chunk > 0 && chunkSize + chunks.at(chunk - 1).size() <= ChunkCapacity) {
+            chunks[chunk - 1].append(chunks.at(chunk));
+            chunks.removeAt(chunk);
+            chunkEnds.removeAt(chunk);
+        }
+    }
+
+    refreshEnds(qMax(0, chunk - 1));
+}
+
+void SegmentList::refreshEnds(int fromChunk) {
+
+    chunkEnds.resize(chunks.size());
+
+    int end = fromChunk > 0 ? chunkEnds.at(fromChunk - 1) : 0;
+    for (int c = fromChunk; c < chunks.size(); ++c) {
+        end += chunks.at(c).size();
+        chunkEnds[c] = end;
+    }
+}
+
+}
+}
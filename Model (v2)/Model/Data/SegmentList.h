@@ -0,0 +1,188 @@
+#ifndef MODEL_DATA_SEGMENT_LIST_H
+#define MODEL_DATA_SEGMENT_LIST_H
+
+#include "Segment.h"
+
+#include <QVector>
+
+#include <iterator>
+
+namespace Model {
+namespace Data {
+
+/**
+ * @brief Chunked sequence of segments with random access by position.
+ *
+ * Segments are stored in consecutive chunks of at most ChunkCapacity
+ * elements, plus the cumulative end index of every chunk. Access by position
+ * is a binary search over the chunk ends; insert and remove only shift one
+ * chunk and refresh the chunk ends, so they cost O(sqrt n)-ish instead of
+ * moving the whole tail of a single array.
+ *
+ * Chunks are implicitly shared QVectors: copying a list (e.g. for an undo
+ * snapshot) is O(1), and the first write afterwards copies only the chunk
+ * it touches instead of every segment.
+ *
+ * The interface follows the QVector subset used for Transcript::segments.
+ */
+
+class SegmentList {
+
+public:
+
+    /** @brief Maximum number of segments per chunk; fuller chunks are split in half. */
+    static constexpr int ChunkCapacity = 512;
+
+    /** @brief Chunks smaller than this are merged with a neighbour when possible. */
+    static constexpr int MinChunkSize = ChunkCapacity / 4;
+
+    class const_iterator;
+
+    /** @brief Forward iterator; dereferencing detaches the chunk it points into. */
+    class iterator {
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Segment;
+        using difference_type = qsizetype;
+        using pointer = Segment*;
+        using reference = Segment&;
+
+        iterator() = default;
+
+        Segment& operator*() const { return list->chunks[chunk][offset]; }
+        Segment* operator->() const { return &list->chunks[chunk][offset]; }
+
+        iterator& operator++() {
+            if (++offset == list->chunks.at(chunk).size()) {
+                ++chunk;
+                offset = 0;
+            }
+            return *this;
+        }
+
+        bool operator==(const iterator& other) const { return chunk == other.chunk && offset == other.offset; }
+        bool operator!=(const iterator& other) const { return !(*this == other); }
+
+    private:
+        friend class SegmentList;
+        iterator(SegmentList* list, int chunk, int offset) : list(list), chunk(chunk), offset(offset) {}
+
+        SegmentList* list = nullptr;
+        int chunk = 0;
+        int offset = 0;
+    };
+
+    /** @brief Read-only forward iterator. */
+    class const_iterator {
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Segment;
+        using difference_type = qsizetype;
+        using pointer = const Segment*;
+        using reference = const Segment&;
+
+        const_iterator() = default;
+
+        const Segment& operator*() const { return list->chunks.at(chunk).at(offset); }
+        const Segment* operator->() const { return &list->chunks.at(chunk).at(offset); }
+
+        const_iterator& operator++() {
+            if (++offset == list->chunks.at(chunk).size()) {
+                ++chunk;
+                offset = 0;
+            }
+            return *this;
+        }
+
+        bool operator==(const const_iterator& other) const { return chunk == other.chunk && offset == other.offset; }
+        bool operator!=(const const_iterator& other) const { return !(*this == other); }
+
+    private:
+        friend class SegmentList;
+        const_iterator(const SegmentList* list, int chunk, int offset) : list(list), chunk(chunk), offset(offset) {}
+
+        const SegmentList* list = nullptr;
+        int chunk = 0;
+        int offset = 0;
+    };
+
+
+    /** @brief Constructs an empty list. */
+    SegmentList() = default;
+
+    /** @brief Constructs a list holding segments in order. */
+    explicit SegmentList(const QVector<Segment>& segments);
+
+    /** @brief Returns the number of segments. */
+    int size() const;
+
+    /** @brief Returns true if there are no segments. */
+    bool isEmpty() const;
+
+    /** @brief Returns the segment at index (0 <= index < size()). */
+    const Segment& at(int index) const;
+    const Segment& operator[](int index) const;
+
+    /** @brief Returns the segment at index for modification (detaches its chunk). */
+    Segment& operator[](int index);
+
+    /** @brief Returns the last segment (list must not be empty). */
+    const Segment& last() const;
+    Segment& last();
+
+    /** @brief Appends a segment. */
+    void push_back(const Segment& segment);
+    void push_back(Segment&& segment);
+
+    /** @brief Inserts a segment before index (0 <= index <= size()). */
+    void insert(int index, const Segment& segment);
+
+    /** @brief Removes the segment at index. */
+    void removeAt(int index);
+
+    /** @brief Removes count segments starting at index. */
+    void remove(int index, int count);
+
+    /** @brief Removes the segment at index and returns it. */
+    Segment takeAt(int index);
+
+    /** @brief Exchanges the segments at indexA and indexB. */
+    void swapItemsAt(int indexA, int indexB);
+
+    /** @brief Removes all segments. */
+    void clear();
+
+    /** @brief Returns all segments as one contiguous vector. */
+    QVector<Segment> toVector() const;
+
+    iterator begin();
+    iterator end();
+    const_iterator begin() const;
+    const_iterator end() const;
+    const_iterator cbegin() const;
+    const_iterator cend() const;
+
+private:
+
+    /** @brief Finds the chunk holding index and the offset inside it. */
+    void locate(int index, int& outChunk, int& outOffset) const;
+
+    /** @brief Splits, merges or drops chunk after a size change and refreshes chunkEnds. */
+    void chunkResized(int chunk);
+
+    /** @brief Recomputes chunkEnds from fromChunk on. */
+    void refreshEnds(int fromChunk);
+
+    // Never empty chunks, each at most ChunkCapacity segments
+    QVector<QVector<Segment>> chunks;
+
+    // chunkEnds[c] = index one past the last segment of chunk c
+    QVector<int> chunkEnds;
+};
+
+}
+}
+
+#endif // MODEL_DATA_SEGMENT_LIST_H
@@ -0,0 +1,204 @@
+#include "SegmentStore.h"
+
+namespace Model {
+namespace Data {
+
+void SegmentStore::build(const Transcript& transcript) {
+
+    clear();
+    source = &transcript;
+    sourceGen = transcript.generation();
+
+    const auto& segments = transcript.segments;
+
+    qsizetype total = 0;
+    for (const Segment& seg : segments)
+        total += seg.textLength();
+
+    arena.reserve(total);
+    offsets.reserve(segments.size());
+    lengths.reserve(segments.size());
+    speakers.reserve(segments.size());
+    inOverflow.reserve(segments.size());
+
+    for (const Segment& seg : segments) {
+        offsets.push_back(appendText(arena, seg.text()));
+        lengths.push_back(seg.text().size());
+        speakers.push_back(seg.speaker);
+        inOverflow.push_back(false);
+    }
+}
+
+void SegmentStore::clear() {
+
+    source = nullptr;
+    arena.clear();
+    overflow.clear();
+    offsets.clear();
+    lengths.clear();
+    speakers.clear();
+    inOverflow.clear();
+    deadChars = 0;
+    pendingCount = 0;
+    ++gen;
+}
+
+bool SegmentStore::isInSyncWith(const Transcript& transcript) const {
+
+    return source == &transcript
+        && sourceGen == transcript.generation()
+        && offsets.size() == transcript.segments.size()
+        && pendingCount == 0;
+}
+
+bool SegmentStore::refresh(const Transcript& transcript) {
+
+    if (source != &transcript
+        || sourceGen != transcript.generation()
+        || offsets.size() != transcript.segments.size())
+        return false;
+
+    if (pendingCount == 0)
+        return true;
+
+    const auto& segments = transcript.segments;
+    for (int i = 0; i < offsets.size() && pendingCount > 0; ++i) {
+        if (offsets[i] >= 0)
+            continue;
+
+        const QString& text = segments[i].text();
+        offsets[i] = appendText(overflow, text);
+        lengths[i] = text.size();
+        inOverflow[i] = true;
+        --pendingCount;
+    }
+
+    ++gen;
+    return true;
+}
+
+int SegmentStore::size() const {
+
+    return offsets.size();
+}
+
+QStringView SegmentStore::textAt(int index) const {
+
+    const QString& buffer = inOverflow[index] ? overflow : arena;
+    return QStringView(buffer).mid(offsets[index], lengths[index]);
+}
+
+int SegmentStore::speakerAt(int index) const {
+
+    return speakers[index];
+}
+
+void SegmentStore::segmentsReplaced(const Transcript& transcript,
+                                    int first,
+                                    int removedCount,
+                                    int insertedCount) {
+
+    if (source != &transcript)
+        return;
+
+    if (first < 0 || first + removedCount > offsets.size()) {
+        build(transcript);
+        return;
+    }
+
+    for (int pos = first; pos < first + removedCount; ++pos) {
+        if (offsets[pos] < 0)
+            --pendingCount;
+        else
+            deadChars += lengths[pos];
+    }
+
+    offsets.remove(first, removedCount);
+    lengths.remove(first, removedCount);
+    speakers.remove(first, removedCount);
+    inOverflow.remove(first, removedCount);
+
+    offsets.insert(first, insertedCount, 0);
+    lengths.insert(first, insertedCount, 0);
+    speakers.insert(first, insertedCount, -1);
+    inOverflow.insert(first, insertedCount, true);
+
+    const auto& segments = transcript.segments;
+    for (int k = 0; k < insertedCount; ++k) {
+        const Segment& seg = segments[first + k];
+        speakers[first + k] = seg.speaker;
+
+        // Flattening a long text on every keystroke would cost its whole length
+        if (seg.isPieceBacked()) {
+            offsets[first + k] = -1;
+            ++pendingCount;
+            continue;
+        }
+
+        offsets[first + k] = appendText(overflow, seg.text());
+        lengths[first + k] = seg.text().size();
+    }
+
+    sourceGen = transcript.generation();
+    ++gen;
+
+    // Guard against a change range that does not match the transcript
+    if (offsets.size() != segments.size())
+        build(transcript);
+}
+
+bool SegmentStore::needsCompaction() const {
+
+    const qsizetype waste = overflow.size() + deadChars;
+    return waste >= qMax<qsizetype>(MinCompactionChars, arena.size() / 4);
+}
+
+SegmentStore SegmentStore::compacted() const {
+
+    SegmentStore out;
+    out.source = source;
+    out.sourceGen = sourceGen;
+    out.gen = gen;
+    out.pendingCount = pendingCount;
+
+    const int count = offsets.size();
+
+    qsizetype total = 0;
+    for (int i = 0; i < count; ++i)
+        total += lengths[i];
+
+    out.arena.reserve(total);
+    out.offsets.reserve(count);
+    out.lengths = lengths;
+    out.speakers = speakers;
+    out.inOverflow.fill(false, count);
+
+    for (int i = 0; i < count; ++i) {
+        if (offsets[i] < 0) {
+            out.offsets.push_back(-1);
+            continue;
+        }
+        out.offsets.push_back(out.arena.size());
+        out.arena.append(textAt(i));
+    }
+
+    return out;
+}
+
+quint64 SegmentStore::generation() const {
+
+    return gen;
+}
+
+
+// === Private helpers ===
+
+int SegmentStore::appendText(QString& buffer, const QString& text) {
+
+    const int offset = buffer.size();
+    buffer.append(text);
+    return offset;
+}
+
+}
+}
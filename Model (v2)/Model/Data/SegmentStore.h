@@ -0,0 +1,124 @@
+#ifndef MODEL_DATA_SEGMENT_STORE_H
+#define MODEL_DATA_SEGMENT_STORE_H
+
+#include "Transcript.h"
+
+#include <QString>
+#include <QStringView>
+#include <QVector>
+
+namespace Model {
+namespace Data {
+
+/**
+ * @brief Packed, read-optimized copy of a transcript's segments.
+ *
+ * Struct-of-arrays layout: all segment texts live back to back in one UTF-16
+ * arena, with parallel offset, length and speaker handle arrays. Sequential
+ * search passes then walk contiguous memory instead of one heap allocation
+ * per segment.
+ *
+ * The store mirrors Transcript::segments and is kept in sync through
+ * segmentsReplaced(). Edited segments are appended to an overflow buffer;
+ * compacted() repacks everything into a fresh arena and only reads
+ * implicitly shared data, so it can run on a copy in a background thread.
+ *
+ * Piece-backed segments (see Segment::isPieceBacked()) are not flattened on
+ * every edit: segmentsReplaced() leaves their slot pending, and refresh()
+ * packs the current text once before the next search.
+ *
+ * Views returned by textAt() stay valid until the store is modified.
+ */
+
+class SegmentStore {
+
+public:
+
+    /** @brief Minimum number of overflow/dead characters before compaction is worth it. */
+    static constexpr int MinCompactionChars = 16 * 1024;
+
+    /** @brief Constructs an empty, unbuilt store. */
+    SegmentStore() = default;
+
+    /** @brief Packs every segment of transcript, replacing previous content. */
+    void build(const Transcript& transcript);
+
+    /** @brief Drops all packed data. */
+    void clear();
+
+    /**
+     * @brief Returns true if the store mirrors transcript (same object, same
+     * generation) and no text is pending.
+     */
+    bool isInSyncWith(const Transcript& transcript) const;
+
+    /**
+     * @brief Packs the texts left pending by segmentsReplaced().
+     *
+     * Returns false, changing nothing, if the store does not follow the
+     * current state of transcript; build() it again then.
+     */
+    bool refresh(const Transcript& transcript);
+
+    /** @brief Returns the number of segments. */
+    int size() const;
+
+    /** @brief Returns the text of the segment at index. */
+    QStringView textAt(int index) const;
+
+    /** @brief Returns the speaker handle of the segment at index. */
+    int speakerAt(int index) const;
+
+    /**
+     * @brief Mirrors a replaced segment range.
+     *
+     * Segments [first, first + removedCount) were replaced by
+     * [first, first + insertedCount) in the current state of transcript.
+     * The new texts go to the overflow buffer, except for piece-backed
+     * segments, which stay pending until refresh().
+     */
+    void segmentsReplaced(const Transcript& transcript,
+                          int first,
+                          int removedCount,
+                          int insertedCount);
+
+    /** @brief Returns true if overflow and dead text justify a compaction. */
+    bool needsCompaction() const;
+
+    /** @brief Returns a copy with every live text packed into a single arena. */
+    SegmentStore compacted() const;
+
+    /** @brief Returns a counter bumped on every modification. */
+    quint64 generation() const;
+
+private:
+
+    /** @brief Appends text to buffer and returns its offset. */
+    static int appendText(QString& buffer, const QString& text);
+
+    const Transcript* source = nullptr;
+
+    // Transcript::generation() of source when the store last matched it
+    quint64 sourceGen = 0;
+
+    QString arena;
+    QString overflow;
+
+    QVector<int> offsets;
+    QVector<int> lengths;
+    QVector<int> speakers;
+    QVector<bool> inOverflow;
+
+    // Characters no longer referenced by any segment
+    int deadChars = 0;
+
+    // Slots whose text is not packed yet; their offset is -1
+    int pendingCount = 0;
+
+    quint64 gen = 0;
+};
+
+}
+}
+
+#endif // MODEL_DATA_SEGMENT_STORE_H
@@ -3,20 +3,24 @@
 namespace Model {
 namespace Data {
 
+namespace {
+
+const QString NoSpeaker;
+
+}
+
 // Checks/Validity
 
 bool Transcript::hasAudio() const { return !audioPath.isEmpty(); }
 bool Transcript::hasEditable() const { return !editablePath.isEmpty(); }
+bool Transcript::isBundle() const { return !bundlePath.isEmpty(); }
 bool Transcript::isEmpty() const { return segments.isEmpty(); }
 
 // === SPEAKER HELPERS ===
 
 int Transcript::findSpeakerIndex(const QString& speakerID) const {
 
-    for (int i = 0; i < speakers.size(); ++i)
-        if (speakers[i].id == speakerID)
-            return i;
-    return -1;
+    return speakerIndexByID.value(speakerID, -1);
 }
 
 Speaker* Transcript::speakerFromID(const QString& speakerID) {
@@ -31,10 +35,54 @@ const Speaker* Transcript::speakerFromID(const QString& speakerID) const {
     return (ind >= 0 ? &speakers[ind] : nullptr);
 }
 
+int Transcript::internSpeaker(const QString& speakerID) {
+
+    int ind = findSpeakerIndex(speakerID);
+    if (ind >= 0)
+        return ind;
+
+    speakers.push_back(Speaker(speakerID, speakerID));
+    ind = speakers.size() - 1;
+    speakerIndexByID.insert(speakerID, ind);
+
+    assertSpeakerIndex();
+    return ind;
+}
+
+const QString& Transcript::speakerIDOf(int speakerHandle) const {
+
+    if (speakerHandle < 0 || speakerHandle >= speakers.size())
+        return NoSpeaker;
+    return speakers[speakerHandle].id;
+}
+
+const QString& Transcript::speakerIDOf(const Segment& segment) const {
+
+    return speakerIDOf(segment.speaker);
+}
+
+void Transcript::setSpeakers(const QVector<Speaker>& newSpeakers) {
+
+    speakers = newSpeakers;
+    rebuildSpeakerIndex();
+}
+
+#ifdef QT_DEBUG
+bool Transcript::checkSpeakerIndex() const {
+
+    // Every ID must map to its first occurrence, and nothing else may be indexed
+    QHash<QString, int> expected;
+    for (int i = 0; i < speakers.size(); ++i) {
+        if (!expected.contains(speakers[i].id))
+            expected.insert(speakers[i].id, i);
+    }
+    return expected == speakerIndexByID;
+}
+#endif
+
 void Transcript::addSpeakerIfMissing(const QString& speakerID) {
 
-    if (findSpeakerIndex(speakerID) == -1)
-        speakers.push_back(Speaker(speakerID, speakerID));
+    internSpeaker(speakerID);
 }
 
 void Transcript::renameSpeaker(const QString& oldID, const QString& newID) {
@@ -43,12 +91,32 @@ void Transcript::renameSpeaker(const QString& oldID, const QString& newID) {
     if (ind < 0)
         return;
 
-    speakers[ind].id = newID;
-    speakers[ind].displayName = newID;
+    const int target = findSpeakerIndex(newID);
+    if (target < 0 || target == ind) {
+        // Plain rename: segments keep their handle
+        speakers[ind].id = newID;
+        speakers[ind].displayName = newID;
+
+        speakerIndexByID.remove(oldID);
+        speakerIndexByID.insert(newID, ind);
+        // Duplicate IDs in the vector: let the rebuild pick the first entries
+        if (speakerIndexByID.size() != speakers.size())
+            rebuildSpeakerIndex();
+
+        assertSpeakerIndex();
+        return;
+    }
 
-    for (auto& seg : segments)
-        if (seg.speakerID == oldID)
-            seg.speakerID = newID;
+    // Merge into the existing speaker and drop the old entry; handles above
+    // the removed one shift down by one.
+    for (auto& seg : segments) {
+        if (seg.speaker == ind)
+            seg.speaker = target;
+        if (seg.speaker > ind)
+            --seg.speaker;
+    }
+    speakers.removeAt(ind);
+    rebuildSpeakerIndex();
 }
 
 
@@ -62,53 +130,168 @@ int Transcript::segmentCount() const {
 void Transcript::addSegment(const Segment& s) {
 
     segments.push_back(s);
+    if (segments.last().id == 0)
+        assignSegmentID(segments.last());
 }
 
-QVector<Segment> Transcript::segmentsBySpeaker(const QString& speakerID) const {
+void Transcript::addSegment(Segment&& s) {
+
+    segments.push_back(std::move(s));
+    if (segments.last().id == 0)
+        assignSegmentID(segments.last());
+}
+
+void Transcript::assignSegmentID(Segment& segment) {
+
+    segment.id = nextSegmentID++;
+}
+
+void Transcript::ensureSegmentIDs() {
+
+    // Segments may arrive with IDs already (e.g. setSegments()); never hand
+    // out one of those again. at() keeps the vector shared if nothing changes.
+    for (int i = 0; i < segments.size(); ++i)
+        nextSegmentID = qMax(nextSegmentID, segments.at(i).id + 1);
+
+    for (int i = 0; i < segments.size(); ++i)
+        if (segments.at(i).id == 0)
+            assignSegmentID(segments[i]);
+}
+
+QVector<int> Transcript::segmentIndicesBySpeaker(const QString& speakerID) const {
+
+    QVector<int> out;
 
-    QVector<Segment> out;
-    out.reserve(segments.size());
+    const int handle = findSpeakerIndex(speakerID);
+    if (handle < 0)
+        return out;
 
-    for (const auto& seg : segments)
-        if (seg.speakerID == speakerID)
-            out.push_back(seg);
+    for (int i = 0; i < segments.size(); ++i)
+        if (segments[i].speaker == handle)
+            out.push_back(i);
 
     return out;
 }
 
 void Transcript::mergeAdjacentSameSpeaker() {
 
-    if (segments.size() < 2)
+    const int count = segments.size();
+    if (count < 2)
         return;
 
-    QVector<Segment> merged;
-    merged.reserve(segments.size());
+    // Nothing to merge: leave the vector (and any sharing) untouched
+    bool hasRun = false;
+    for (int i = 1; i < count && !hasRun; ++i)
+        hasRun = segments.at(i).speaker == segments.at(i - 1).speaker;
+    if (!hasRun)
+        return;
+
+    // Two-pointer compaction: [0, write] holds the merged segments so far
+    int write = 0;
 
-    Segment current = segments[0];
+    for (int read = 1; read < count; ++read) {
+        Segment& current = segments[write];
+        Segment& next = segments[read];
 
-    for (int i = 1; i < segments.size(); ++i) {
-        const auto& next = segments[i];
-        if (next.speakerID == current.speakerID) {
-            current.appendText(next.text);
+        if (next.speaker == current.speaker) {
+            current.appendText(next.text());
         }
         else {
-            merged.push_back(current);
-            current = next;
+            ++write;
+            if (write != read)
+                segments[write] = std::move(next);
         }
     }
 
-    merged.push_back(current);
-    segments = merged;
+    segments.remove(write + 1, count - write - 1);
 }
 
 QString Transcript::allText() const {
 
+    // Same layout as Segment::exportFormat(), assembled in one pre-sized buffer
+    qsizetype total = 1;
+    for (const Segment& seg : segments)
+        total += speakerIDOf(seg).size() + seg.textLength() + 4;
+
     QString out;
+    out.reserve(total);
+
+    for (const Segment& seg : segments) {
+        out += speakerIDOf(seg);
+        out += QLatin1String(":\n");
+        out += QStringView(seg.text()).trimmed();
+        out += QLatin1String("\n\n");
+    }
+
+    // The rvalue overload trims in place instead of copying
+    out = std::move(out).trimmed();
+    out += QLatin1Char('\n');
+    return out;
+}
+
+void Transcript::compactText() {
+
+    for (Segment& seg : segments)
+        seg.compact();
+}
+
+void Transcript::expandText() {
+
+    for (Segment& seg : segments)
+        seg.expand();
+}
+
+qsizetype Transcript::textMemoryBytes() const {
+
+    qsizetype bytes = 0;
+    for (const Segment& seg : segments)
+        bytes += seg.textMemoryBytes();
+    return bytes;
+}
+
+
+// === CHANGE TRACKING ===
+
+void Transcript::markModified() {
+
+    ++editGeneration;
+}
+
+quint64 Transcript::generation() const {
+
+    return editGeneration;
+}
+
+bool Transcript::isDirty() const {
+
+    return editGeneration != savedGeneration;
+}
+
+void Transcript::markSaved(quint64 savedGen) {
+
+    if (savedGen == editGeneration)
+        savedGeneration = savedGen;
+}
+
+
+// === SPEAKER INDEX ===
+
+void Transcript::rebuildSpeakerIndex() {
+
+    speakerIndexByID.clear();
+    speakerIndexByID.reserve(speakers.size());
+
+    for (int i = 0; i < speakers.size(); ++i) {
+        if (!speakerIndexByID.contains(speakers[i].id))
+            speakerIndexByID.insert(speakers[i].id, i);
+    }
+}
 
-    for (const auto& seg : segments)
-        out += seg.exportFormat();
+void Transcript::assertSpeakerIndex() const {
 
-    return out.trimmed() + "\n";
+#ifdef QT_DEBUG
+    Q_ASSERT_X(checkSpeakerIndex(), "Transcript", "speaker index out of sync with speakers");
+#endif
 }
 
 
@@ -117,12 +300,17 @@ QString Transcript::allText() const {
 void Transcript::clear() {
 
     speakers.clear();
+    speakerIndexByID.clear();
     segments.clear();
+    nextSegmentID = 1;
+    editGeneration = 0;
+    savedGeneration = 0;
     id.clear();
     title.clear();
     referencePath.clear();
     editablePath.clear();
     audioPath.clear();
+    bundlePath.clear();
 }
 
 
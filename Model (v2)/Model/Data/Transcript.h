@@ -3,10 +3,12 @@
 
 #include <QString>
 #include <QVector>
+#include <QHash>
 #include <QDateTime>
 
 #include "Speaker.h"
 #include "Segment.h"
+#include "SegmentList.h"
 
 namespace Model {
 namespace Data {
@@ -32,6 +34,9 @@ public:
     /** @brief Returns true if an editable transcript path is set. */
     bool hasEditable() const;
 
+    /** @brief Returns true if the transcript is stored as a bundle file. */
+    bool isBundle() const;
+
     /** @brief Returns true if there are no segments. */
     bool isEmpty() const;
 
@@ -40,11 +45,41 @@ public:
 
     /**
      * @brief Finds the index of a speaker with the given ID.
+     *
+     * The index is also the speaker handle stored in Segment::speaker.
+     * Served from a hash index, so this is O(1).
+     *
      * @param speakerID Identifier to search for.
      * @return Index in the speakers vector, or -1 if not found.
      */
     int findSpeakerIndex(const QString& speakerID) const;
 
+    /**
+     * @brief Returns the handle for speakerID, adding the speaker if missing.
+     *
+     * Handles stay valid until the speaker is removed (see renameSpeaker()).
+     */
+    int internSpeaker(const QString& speakerID);
+
+    /** @brief Returns the speaker ID for a handle, or an empty string if invalid. */
+    const QString& speakerIDOf(int speakerHandle) const;
+
+    /** @brief Returns the speaker ID of a segment, or an empty string if it has none. */
+    const QString& speakerIDOf(const Segment& segment) const;
+
+    /**
+     * @brief Replaces the speaker list and rebuilds the speaker ID index.
+     *
+     * Use this instead of assigning speakers directly (e.g. when restoring
+     * an undo snapshot) so that lookups stay consistent.
+     */
+    void setSpeakers(const QVector<Speaker>& newSpeakers);
+
+#ifdef QT_DEBUG
+    /** @brief Returns true if the speaker ID index matches the speakers vector (debug only). */
+    bool checkSpeakerIndex() const;
+#endif
+
     /**
      * @brief Returns a pointer to a speaker by ID (modifiable).
      */
@@ -62,6 +97,11 @@ public:
 
     /**
      * @brief Renames a speaker ID throughout the transcript.
+     *
+     * Segments refer to the speaker by handle, so only the speaker entry is
+     * updated. If newID already exists, the two speakers are merged: segments
+     * of oldID are moved to newID and the oldID entry is removed.
+     *
      * @param oldID Existing speaker ID.
      * @param newID New ID to replace it with.
      */
@@ -79,14 +119,33 @@ public:
      */
     void addSegment(const Segment& s);
 
+    /** @brief Adds a new segment to the transcript, taking over its data. */
+    void addSegment(Segment&& s);
+
+    /**
+     * @brief Gives segment a new ID, unique within this transcript.
+     *
+     * IDs are never reused, so a removed segment's ID cannot come back
+     * except through undo/redo restoring that same segment.
+     */
+    void assignSegmentID(Segment& segment);
+
+    /** @brief Assigns an ID to every segment that has none (id == 0). */
+    void ensureSegmentIDs();
+
     /**
-     * @brief Returns all segments belonging to a speaker.
+     * @brief Returns the indices of all segments belonging to a speaker.
+     *
+     * Indices into segments, in order; no segment is copied.
      * @param speakerID The speaker whose segments to fetch.
      */
-    QVector<Segment> segmentsBySpeaker(const QString& speakerID) const;
+    QVector<int> segmentIndicesBySpeaker(const QString& speakerID) const;
 
     /**
      * @brief Merges consecutive segments spoken by the same speaker.
+     *
+     * Compacts segments in place: kept segments are moved down, merged text
+     * is appended to the surviving segment, and no temporary vector is built.
      */
     void mergeAdjacentSameSpeaker();
 
@@ -95,6 +154,35 @@ public:
      */
     QString allText() const;
 
+    /** @brief Switches every segment to compact storage (see Segment::compact()). */
+    void compactText();
+
+    /** @brief Returns every segment to QString storage, e.g. before editing. */
+    void expandText();
+
+    /** @brief Returns the approximate heap size of all segment texts. */
+    qsizetype textMemoryBytes() const;
+
+
+    // === Change tracking ===
+
+    /** @brief Records an edit: bumps generation() and makes the transcript dirty. */
+    void markModified();
+
+    /** @brief Returns a counter bumped by every markModified(). */
+    quint64 generation() const;
+
+    /** @brief Returns true if there are edits not yet written to disk. */
+    bool isDirty() const;
+
+    /**
+     * @brief Records that the state at generation savedGen is on disk.
+     *
+     * Edits made after that generation (e.g. while an asynchronous save was
+     * running) keep the transcript dirty.
+     */
+    void markSaved(quint64 savedGen);
+
     /** @brief Clears all data within this transcript. */
     void clear();
 
@@ -107,13 +195,37 @@ public:
     QString editablePath;
     QString audioPath;
 
+    // Absolute; set if the transcript was loaded from a single-file bundle
+    // (see Model::Service::TranscriptBundle) instead of a folder
+    QString bundlePath;
+
+    // Add, remove or re-ID speakers only through internSpeaker(),
+    // renameSpeaker(), setSpeakers() or clear(); they keep the ID index in sync.
     QVector<Speaker> speakers;
-    QVector<Segment> segments;
+    SegmentList segments;
 
     QDateTime dateImported;
     QDateTime lastEdited;
 
     qint64 lastPlaybackPositionMs = 0;
+
+private:
+
+    /** @brief Rebuilds speakerIndexByID from speakers (first entry wins on duplicates). */
+    void rebuildSpeakerIndex();
+
+    /** @brief Asserts the speaker index is consistent (no-op in release builds). */
+    void assertSpeakerIndex() const;
+
+    // Speaker ID -> index in speakers
+    QHash<QString, int> speakerIndexByID;
+
+    // Next value handed out by assignSegmentID()
+    quint64 nextSegmentID = 1;
+
+    // Bumped by markModified(); dirty while it differs from the saved one
+    quint64 editGeneration = 0;
+    quint64 savedGeneration = 0;
 };
 
 }
@@ -0,0 +1,33 @@
+#include "TranscriptVersion.h"
+
+namespace Model {
+namespace Data {
+
+TranscriptVersion::TranscriptVersion(const Transcript& transcript, quint64 number)
+    : state(QSharedPointer<const Transcript>::create(transcript)),
+    versionNumber(number)
+{}
+
+bool TranscriptVersion::isNull() const {
+
+    return state.isNull();
+}
+
+quint64 TranscriptVersion::number() const {
+
+    return versionNumber;
+}
+
+const Transcript& TranscriptVersion::transcript() const {
+
+    Q_ASSERT_X(state, "TranscriptVersion::transcript", "null version");
+    return *state;
+}
+
+const Transcript* TranscriptVersion::operator->() const {
+
+    return &transcript();
+}
+
+}
+}
@@ -0,0 +1,59 @@
+#ifndef MODEL_DATA_TRANSCRIPT_VERSION_H
+#define MODEL_DATA_TRANSCRIPT_VERSION_H
+
+#include "Transcript.h"
+
+#include <QSharedPointer>
+
+namespace Model {
+namespace Data {
+
+/**
+ * @brief Immutable, structurally shared state of a Transcript.
+ *
+ * A version is a frozen copy of the transcript taken in O(1): speakers,
+ * segment chunks (see SegmentList) and piece-backed texts are implicitly
+ * shared with the live transcript, and the next edit only copies the chunk
+ * and text it touches. Older versions therefore cost only what changed
+ * since.
+ *
+ * Versions are never modified after construction, so undo history, savers
+ * and worker threads can hold and read them without locks. Copying a
+ * version is a reference count increment.
+ */
+
+class TranscriptVersion {
+
+public:
+
+    /** @brief Constructs a null version. */
+    TranscriptVersion() = default;
+
+    /**
+     * @brief Captures the current state of transcript.
+     * @param number Version number, e.g. TranscriptEditor::versionNumber().
+     */
+    explicit TranscriptVersion(const Transcript& transcript, quint64 number = 0);
+
+    /** @brief Returns true if this version holds no state. */
+    bool isNull() const;
+
+    /** @brief Returns the version number given at construction. */
+    quint64 number() const;
+
+    /** @brief Returns the frozen transcript (the version must not be null). */
+    const Transcript& transcript() const;
+
+    /** @brief Shorthand for transcript(). */
+    const Transcript* operator->() const;
+
+private:
+
+    QSharedPointer<const Transcript> state;
+    quint64 versionNumber = 0;
+};
+
+}
+}
+
+#endif // MODEL_DATA_TRANSCRIPT_VERSION_H
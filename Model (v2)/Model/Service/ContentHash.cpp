@@ -0,0 +1,167 @@
+#include "ContentHash.h"
+
+#include <cstring>
+
+namespace Model {
+namespace Service {
+
+namespace {
+
+constexpr quint64 Prime1 = 0x9E3779B185EBCA87ULL;
+constexpr quint64 Prime2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr quint64 Prime3 = 0x165667B19E3779F9ULL;
+constexpr quint64 Prime4 = 0x85EBCA77C2B2AE63ULL;
+constexpr quint64 Prime5 = 0x27D4EB2F165667C5ULL;
+
+quint64 rotl(quint64 value, int bits) {
+
+    return (value << bits) | (value >> (64 - bits));
+}
+
+// Little-endian reads, independent of the host byte order
+quint64 read64(const uchar* p) {
+
+    quint64 value = 0;
+    for (int i = 7; i >= 0; --i)
+        value = (value << 8) | p[i];
+    return value;
+}
+
+quint32 read32(const uchar* p) {
+
+    return quint32(p[0]) | (quint32(p[1]) << 8) | (quint32(p[2]) << 16) | (quint32(p[3]) << 24);
+}
+
+quint64 round(quint64 acc, quint64 input) {
+
+    acc += input * Prime2;
+    acc = rotl(acc, 31);
+    return acc * Prime1;
+}
+
+quint64 mergeRound(quint64 acc, quint64 value) {
+
+    acc ^= round(0, value);
+    return acc * Prime1 + Prime4;
+}
+
+}
+
+ContentHash::ContentHash(quint64 seed)
+    : seed(seed)
+{
+    reset();
+}
+
+void ContentHash::reset() {
+
+    acc[0] = seed + Prime1 + Prime2;
+    acc[1] = seed + Prime2;
+    acc[2] = seed;
+    acc[3] = seed - Prime1;
+    pendingSize = 0;
+    totalLength = 0;
+}
+
+void ContentHash::addData(const char* data, qsizetype length) {
+
+    if (length <= 0)
+        return;
+
+    const uchar* p = reinterpret_cast<const uchar*>(data);
+    const uchar* const end = p + length;
+    totalLength += quint64(length);
+
+    // Complete a stripe left over from the previous call
+    if (pendingSize > 0) {
+        const int take = int(qMin<qsizetype>(StripeSize - pendingSize, end - p));
+        std::memcpy(pending + pendingSize, p, size_t(take));
+        pendingSize += take;
+        p += take;
+
+        if (pendingSize < StripeSize)
+            return;
+
+        consumeStripe(pending);
+        pendingSize = 0;
+    }
+
+    while (end - p >= StripeSize) {
+        consumeStripe(p);
+        p += StripeSize;
+    }
+
+    pendingSize = int(end - p);
+    if (pendingSize > 0)
+        std::memcpy(pending, p, size_t(pendingSize));
+}
+
+void ContentHash::addData(const QByteArray& data) {
+
+    addData(data.constData(), data.size());
+}
+
+quint64 ContentHash::result() const {
+
+    quint64 h;
+
+    if (totalLength >= quint64(StripeSize)) {
+        h = rotl(acc[0], 1) + rotl(acc[1], 7) + rotl(acc[2], 12) + rotl(acc[3], 18);
+        for (int i = 0; i < 4; ++i)
+            h = mergeRound(h, acc[i]);
+    }
+    else {
+        h = seed + Prime5;
+    }
+
+    h += totalLength;
+
+    // Tail: the bytes that did not fill a whole stripe
+    const uchar* p = pending;
+    const uchar* const end = pending + pendingSize;
+
+    while (end - p >= 8) {
+        h ^= round(0, read64(p));
+        h = rotl(h, 27) * Prime1 + Prime4;
+        p += 8;
+    }
+
+    if (end - p >= 4) {
+        h ^= quint64(read32(p)) * Prime1;
+        h = rotl(h, 23) * Prime2 + Prime3;
+        p += 4;
+    }
+
+    while (p < end) {
+        h ^= quint64(*p) * Prime5;
+        h = rotl(h, 11) * Prime1;
+        ++p;
+    }
+
+    // Final avalanche
+    h ^= h >> 33;
+    h *= Prime2;
+    h ^= h >> 29;
+    h *= Prime3;
+    h ^= h >> 32;
+    return h;
+}
+
+quint64 ContentHash::hash(const QByteArray& data, quint64 seed) {
+
+    ContentHash hasher(seed);
+    hasher.addData(data);
+    return hasher.result();
+}
+
+
+// === Private helpers ===
+
+void ContentHash::consumeStripe(const uchar* stripe) {
+
+    for (int i = 0; i < 4; ++i)
+        acc[i] = round(acc[i], read64(stripe + 8 * i));
+}
+
+}
+}
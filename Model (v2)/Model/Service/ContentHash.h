@@ -0,0 +1,58 @@
+#ifndef MODEL_SERVICE_CONTENT_HASH_H
+#define MODEL_SERVICE_CONTENT_HASH_H
+
+#include <QByteArray>
+#include <QtGlobal>
+
+namespace Model {
+namespace Service {
+
+/**
+ * @brief Streaming 64-bit xxHash (XXH64) for change detection.
+ *
+ * Fast and non-cryptographic: used to tell whether serialized output
+ * differs from what is already on disk, not to protect against tampering.
+ * Data can be fed in any number of addData() calls; the result is the same
+ * as hashing the concatenation in one go.
+ */
+
+class ContentHash {
+
+public:
+
+    /** @brief Starts a new hash with the given seed. */
+    explicit ContentHash(quint64 seed = 0);
+
+    /** @brief Discards all data added so far. */
+    void reset();
+
+    /** @brief Feeds length bytes to the hash. */
+    void addData(const char* data, qsizetype length);
+
+    /** @brief Feeds data to the hash. */
+    void addData(const QByteArray& data);
+
+    /** @brief Returns the hash of everything added so far (does not reset). */
+    quint64 result() const;
+
+    /** @brief Returns the hash of data in one call. */
+    static quint64 hash(const QByteArray& data, quint64 seed = 0);
+
+private:
+
+    static constexpr int StripeSize = 32;
+
+    /** @brief Mixes one 32-byte stripe into the accumulators. */
+    void consumeStripe(const uchar* stripe);
+
+    quint64 seed;
+    quint64 acc[4];
+    uchar pending[StripeSize];
+    int pendingSize = 0;
+    quint64 totalLength = 0;
+};
+
+}
+}
+
+#endif // MODEL_SERVICE_CONTENT_HASH_H
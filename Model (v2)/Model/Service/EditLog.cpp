@@ -0,0 +1,581 @@
+#include "EditLog.h"
+#include "ContentHash.h"
+
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+
+namespace Model {
+namespace Service {
+
+using namespace Model::Data;
+
+using Operation = TranscriptEditor::Operation;
+
+QString EditLog::logPath(const QString& folderPath) {
+
+    return QDir(folderPath).filePath(QLatin1String(FileName));
+}
+
+QString EditLog::basePathOf(const Transcript& transcript) {
+
+    return transcript.editablePath.isEmpty() ? transcript.referencePath
+                                             : transcript.editablePath;
+}
+
+qint64 EditLog::estimatedSize(const QVector<Operation>& operations) {
+
+    // Fixed fields at their widest, strings as UTF-16 with a length prefix
+    const auto stringSize = [](int length) { return 4 + 2 * qint64(length); };
+
+    qint64 size = RecordHeaderSize + 1 + 4;
+    for (const Operation& op : operations) {
+        size += 1 + 8 + 8 + 4 + 4
+              + stringSize(op.text.size()) + stringSize(op.speakerID.size())
+              + stringSize(op.oldSpeakerID.size());
+
+        if (op.kind == Operation::Kind::Reset && !op.state.isNull()) {
+            for (const Speaker& sp : op.state->speakers)
+                size += stringSize(sp.id.size()) + stringSize(sp.displayName.size()) + 11;
+            for (const Segment& seg : op.state->segments)
+                size += 8 + stringSize(0) + stringSize(seg.textLength());
+        }
+    }
+
+    return size;
+}
+
+
+// === Records ===
+
+QByteArray EditLog::operationsRecord(const QVector<Operation>& operations) {
+
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    out.setVersion(StreamVersion);
+
+    out << quint8(RecordKind::Operations) << qint32(operations.size());
+    for (const Operation& op : operations)
+        writeOperation(out, op);
+
+    return payload;
+}
+
+QByteArray EditLog::snapshotRecord(const Transcript& transcript) {
+
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    out.setVersion(StreamVersion);
+
+    out << quint8(RecordKind::Snapshot);
+    writeState(out, transcript);
+    return payload;
+}
+
+QByteArray EditLog::commitRecord(const QDateTime& savedAt) {
+
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    out.setVersion(StreamVersion);
+
+    out << quint8(RecordKind::Commit) << savedAt.toMSecsSinceEpoch();
+    return payload;
+}
+
+
+// === Files ===
+
+bool EditLog::append(const QString& logPath,
+                     const QStringList& basePaths,
+                     const QByteArray& record,
+                     QString* errorMessage) {
+
+    QFile f(logPath);
+    const bool isNew = !f.exists();
+
+    if (!f.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        if (errorMessage)
+            *errorMessage = QStringLiteral("Cannot open edit log: %1").arg(logPath);
+        return false;
+    }
+
+    QByteArray bytes;
+    if (isNew) {
+        quint64 baseHash = 0;
+        for (const QString& path : basePaths) {
+            if (!path.isEmpty() && QFileInfo::exists(path) && hashFile(path, baseHash))
+                break;
+        }
+        bytes = header(baseHash);
+    }
+    bytes += frame(record);
+
+    // One write per record, handed to the OS right away: survives the app being killed
+    if (f.write(bytes) != bytes.size() || !f.flush()) {
+        if (errorMessage)
+            *errorMessage = QStringLiteral("Failed to append to edit log: %1").arg(logPath);
+        return false;
+    }
+
+    return true;
+}
+
+bool EditLog::reset(const QString& logPath,
+                    const QString& basePath,
+                    const QByteArray& snapshot,
+                    const QDateTime& savedAt,
+                    QString* errorMessage) {
+
+    quint64 baseHash = 0;
+    if (!hashFile(basePath, baseHash)) {
+        if (errorMessage)
+            *errorMessage = QStringLiteral("Cannot read compacted transcript: %1").arg(basePath);
+        return false;
+    }
+
+    QSaveFile f(logPath);
+    if (!f.open(QIODevice::WriteOnly)) {
+        if (errorMessage)
+            *errorMessage = QStringLiteral("Cannot write edit log: %1").arg(logPath);
+        return false;
+    }
+
+    f.write(header(baseHash));
+    f.write(frame(snapshot));
+    f.write(frame(commitRecord(savedAt)));
+
+    if (!f.commit()) {
+        if (errorMessage)
+            *errorMessage = QStringLiteral("Failed to write edit log: %1").arg(logPath);
+        return false;
+    }
+
+    return true;
+}
+
+bool EditLog::replay(Transcript& transcript,
+                     ReplayResult* outResult,
+                     QString* errorMessage) {
+    if (outResult)
+        *outResult = ReplayResult();
+
+    // Bundles are saved as a whole and have no log
+    if (transcript.folderPath.isEmpty())
+        return true;
+
+    const QString path = logPath(transcript.folderPath);
+
+    QFile f(path);
+    if (!f.exists())
+        return true;
+
+    if (!f.open(QIODevice::ReadOnly)) {
+        if (errorMessage)
+            *errorMessage = QStringLiteral("Cannot read edit log: %1").arg(path);
+        return false;
+    }
+
+    const QByteArray data = f.readAll();
+    f.close();
+
+    // Killed while creating the log: no record made it
+    if (data.size() < HeaderSize) {
+        QFile::remove(path);
+        return true;
+    }
+
+    QDataStream in(data);
+    in.setVersion(StreamVersion);
+
+    quint32 magic = 0;
+    quint16 version = 0;
+    quint64 baseHash = 0;
+    in >> magic >> version >> baseHash;
+
+    quint64 currentHash = 0;
+    if (magic != Magic || version != FormatVersion
+        || !hashFile(basePathOf(transcript), currentHash) || currentHash != baseHash) {
+        // The text file was changed behind the log's back: keep the edits for inspection
+        const QString stalePath = path + QStringLiteral(".stale");
+        QFile::remove(stalePath);
+        QFile::rename(path, stalePath);
+
+        if (errorMessage)
+            *errorMessage = QStringLiteral("The edit log of \"%1\" does not match its text file "
+                                           "and was moved to %2").arg(transcript.title, stalePath);
+        return false;
+    }
+
+    // IDs as the editor assigns them when it opens the parsed transcript
+    Transcript recovered = transcript;
+    recovered.ensureSegmentIDs();
+
+    SegmentIdMap ids;
+    ids.build(recovered.segments);
+
+    ReplayResult result;
+
+    qint64 goodEnd = HeaderSize;
+    qint64 snapshotEnd = HeaderSize;
+
+    while (data.size() - goodEnd >= RecordHeaderSize) {
+        quint32 length = 0;
+        quint64 checksum = 0;
+        in >> length >> checksum;
+
+        // A crash mid-append leaves a short or mismatching last record
+        if (data.size() - in.device()->pos() < qint64(length))
+            break;
+
+        QByteArray payload(int(length), Qt::Uninitialized);
+        in.readRawData(payload.data(), int(length));
+        if (ContentHash::hash(payload) != checksum)
+            break;
+
+        const quint8 kind = kindOf(payload);
+        if (kind == quint8(RecordKind::Commit)) {
+            result.uncommitted = 0;
+        }
+        else {
+            if (!applyRecord(payload, recovered, ids)) {
+                if (errorMessage)
+                    *errorMessage = QStringLiteral("Edit log does not match transcript: %1").arg(path);
+                return false;
+            }
+            ++result.applied;
+            ++result.uncommitted;
+        }
+
+        goodEnd = in.device()->pos();
+
+        // A compacted log starts with the snapshot of the compacted state
+        if (kind == quint8(RecordKind::Snapshot) && result.applied == 1)
+            snapshotEnd = goodEnd;
+    }
+
+    // Cut a torn tail, or records appended after it would never be read
+    if (goodEnd < data.size())
+        QFile::resize(path, goodEnd);
+
+    result.tailBytes = goodEnd - snapshotEnd;
+
+    if (result.applied > 0) {
+        recovered.ensureSegmentIDs();
+        transcript = recovered;
+    }
+
+    if (outResult)
+        *outResult = result;
+    return true;
+}
+
+
+// === Private helpers ===
+
+QByteArray EditLog::header(quint64 baseHash) {
+
+    QByteArray bytes;
+    QDataStream out(&bytes, QIODevice::WriteOnly);
+    out.setVersion(StreamVersion);
+    out << Magic << FormatVersion << baseHash;
+    return bytes;
+}
+
+QByteArray EditLog::frame(const QByteArray& record) {
+
+    QByteArray bytes;
+    bytes.reserve(RecordHeaderSize + record.size());
+
+    QDataStream out(&bytes, QIODevice::WriteOnly);
+    out.setVersion(StreamVersion);
+    out << quint32(record.size()) << ContentHash::hash(record);
+    out.writeRawData(record.constData(), int(record.size()));
+    return bytes;
+}
+
+bool EditLog::hashFile(const QString& path, quint64& outHash) {
+
+    QFile f(path);
+
+    // Text mode, like the importer reads it
+    if (!f.open(QIODevice::ReadOnly | QIODevice::Text))
+        return false;
+
+    ContentHash hasher;
+    while (!f.atEnd()) {
+        const QByteArray chunk = f.read(64 * 1024);
+        if (chunk.isEmpty())
+            return false;
+        hasher.addData(chunk);
+    }
+
+    outHash = hasher.result();
+    return true;
+}
+
+int EditLog::speakerHandle(Transcript& transcript, const QString& speakerID) {
+
+    // Segments without a speaker are logged with an empty ID
+    return speakerID.isEmpty() ? -1 : transcript.internSpeaker(speakerID);
+}
+
+void EditLog::writeState(QDataStream& out, const Transcript& transcript) {
+
+    out << qint32(transcript.speakers.size());
+    for (const Speaker& sp : transcript.speakers)
+        out << sp.id << sp.displayName << sp.color;
+
+    out << qint32(transcript.segments.size());
+    for (const Segment& seg : transcript.segments)
+        out << seg.id << transcript.speakerIDOf(seg) << seg.text();
+}
+
+void EditLog::readState(QDataStream& in, Transcript& transcript) {
+
+    qint32 speakerCount = 0;
+    in >> speakerCount;
+
+    QVector<Speaker> speakers;
+    for (int i = 0; i < speakerCount && in.status() == QDataStream::Ok; ++i) {
+        Speaker sp;
+        in >> sp.id >> sp.displayName >> sp.color;
+        speakers.push_back(sp);
+    }
+    transcript.setSpeakers(speakers);
+
+    qint32 segmentCount = 0;
+    in >> segmentCount;
+
+    SegmentList segments;
+    for (int i = 0; i < segmentCount && in.status() == QDataStream::Ok; ++i) {
+        quint64 id = 0;
+        QString speakerID;
+        QString text;
+        in >> id >> speakerID >> text;
+
+        Segment seg(speakerHandle(transcript, speakerID), text);
+        seg.id = id;
+        segments.push_back(seg);
+    }
+    transcript.segments = segments;
+}
+
+void EditLog::writeOperation(QDataStream& out, const Operation& op) {
+
+    out << quint8(op.kind);
+
+    switch (op.kind) {
+    case Operation::Kind::Splice:
+        out << op.segmentID << qint32(op.position) << qint32(op.length) << op.text;
+        break;
+    case Operation::Kind::Split:
+        out << op.segmentID << qint32(op.position) << op.otherID << op.speakerID;
+        break;
+    case Operation::Kind::Join:
+        out << op.segmentID << op.otherID;
+        break;
+    case Operation::Kind::Insert:
+        out << qint32(op.position) << op.segmentID << op.speakerID << op.text;
+        break;
+    case Operation::Kind::Remove:
+        out << op.segmentID;
+        break;
+    case Operation::Kind::Move:
+        out << op.segmentID << qint32(op.position);
+        break;
+    case Operation::Kind::SetSpeaker:
+        out << op.segmentID << op.speakerID;
+        break;
+    case Operation::Kind::RenameSpeaker:
+        out << op.oldSpeakerID << op.speakerID;
+        break;
+    case Operation::Kind::Reset:
+        writeState(out, op.state.transcript());
+        break;
+    }
+}
+
+void EditLog::readOperation(QDataStream& in, Operation& op) {
+
+    quint8 kind = 0;
+    qint32 position = 0;
+    qint32 length = 0;
+    in >> kind;
+    op.kind = Operation::Kind(kind);
+
+    switch (op.kind) {
+    case Operation::Kind::Splice:
+        in >> op.segmentID >> position >> length >> op.text;
+        break;
+    case Operation::Kind::Split:
+        in >> op.segmentID >> position >> op.otherID >> op.speakerID;
+        break;
+    case Operation::Kind::Join:
+        in >> op.segmentID >> op.otherID;
+        break;
+    case Operation::Kind::Insert:
+        in >> position >> op.segmentID >> op.speakerID >> op.text;
+        break;
+    case Operation::Kind::Remove:
+        in >> op.segmentID;
+        break;
+    case Operation::Kind::Move:
+        in >> op.segmentID >> position;
+        break;
+    case Operation::Kind::SetSpeaker:
+        in >> op.segmentID >> op.speakerID;
+        break;
+    case Operation::Kind::RenameSpeaker:
+        in >> op.oldSpeakerID >> op.speakerID;
+        break;
+    case Operation::Kind::Reset: {
+        Transcript state;
+        readState(in, state);
+        op.state = TranscriptVersion(state);
+        break;
+    }
+    default:
+        in.setStatus(QDataStream::ReadCorruptData);
+        break;
+    }
+
+    op.position = position;
+    op.length = length;
+}
+
+quint8 EditLog::kindOf(const QByteArray& payload) {
+
+    return payload.isEmpty() ? 0 : quint8(payload.at(0));
+}
+
+bool EditLog::applyRecord(const QByteArray& payload, Transcript& transcript, SegmentIdMap& ids) {
+
+    QDataStream in(payload);
+    in.setVersion(StreamVersion);
+
+    quint8 kind = 0;
+    in >> kind;
+
+    if (kind == quint8(RecordKind::Operations)) {
+        qint32 count = 0;
+        in >> count;
+
+        for (int i = 0; i < count; ++i) {
+            Operation op;
+            readOperation(in, op);
+            if (in.status() != QDataStream::Ok || !applyOperation(op, transcript, ids))
+                return false;
+        }
+
+        return in.status() == QDataStream::Ok;
+    }
+
+    if (kind == quint8(RecordKind::Snapshot)) {
+        readState(in, transcript);
+        ids.build(transcript.segments);
+        return in.status() == QDataStream::Ok;
+    }
+
+    return false;
+}
+
+bool EditLog::applyOperation(const Operation& op, Transcript& transcript, SegmentIdMap& ids) {
+
+    SegmentList& segments = transcript.segments;
+
+    const auto replaced = [&](int first, int removedCount, int insertedCount) {
+        if (!ids.segmentsReplaced(segments, first, removedCount, insertedCount))
+            ids.build(segments);
+    };
+
+    // Operations that create a segment (or a speaker) have no position to look up
+    switch (op.kind) {
+    case Operation::Kind::Insert: {
+        if (op.position < 0 || op.position > segments.size() || op.segmentID == 0)
+            return false;
+
+        Segment seg(speakerHandle(transcript, op.speakerID), op.text);
+        seg.id = op.segmentID;
+        segments.insert(op.position, seg);
+        replaced(op.position, 0, 1);
+        return true;
+    }
+    case Operation::Kind::RenameSpeaker:
+        if (transcript.findSpeakerIndex(op.oldSpeakerID) < 0 || op.speakerID.isEmpty())
+            return false;
+        transcript.renameSpeaker(op.oldSpeakerID, op.speakerID);
+        return true;
+    case Operation::Kind::Reset:
+        if (op.state.isNull())
+            return false;
+        transcript.setSpeakers(op.state->speakers);
+        segments = op.state->segments;
+        ids.build(segments);
+        return true;
+    default:
+        break;
+    }
+
+    const int index = ids.positionOf(op.segmentID);
+    if (index < 0 || index >= segments.size() || segments.at(index).id != op.segmentID)
+        return false;
+
+    switch (op.kind) {
+    case Operation::Kind::Splice: {
+        Segment& seg = segments[index];
+        if (op.position < 0 || op.length < 0 || op.position + op.length > seg.textLength())
+            return false;
+        seg.removeText(op.position, op.length);
+        seg.insertText(op.position, op.text);
+        return true;
+    }
+    case Operation::Kind::Split: {
+        Segment& seg = segments[index];
+        if (op.position < 0 || op.position > seg.textLength() || op.otherID == 0)
+            return false;
+
+        Segment tail = seg.splitOff(op.position);
+        tail.speaker = speakerHandle(transcript, op.speakerID);
+        tail.id = op.otherID;
+        segments.insert(index + 1, tail);
+        replaced(index, 1, 2);
+        return true;
+    }
+    case Operation::Kind::Join: {
+        if (index + 1 >= segments.size() || segments.at(index + 1).id != op.otherID)
+            return false;
+
+        // Exactly the two texts: a separator, if any, was logged as a splice
+        const QString nextText = segments.at(index + 1).text();
+        Segment& seg = segments[index];
+        seg.insertText(seg.textLength(), nextText);
+        segments.removeAt(index + 1);
+        replaced(index, 2, 1);
+        return true;
+    }
+    case Operation::Kind::Remove:
+        segments.removeAt(index);
+        replaced(index, 1, 0);
+        return true;
+    case Operation::Kind::Move: {
+        if (op.position < 0 || op.position >= segments.size())
+            return false;
+
+        segments.insert(op.position, segments.takeAt(index));
+        const int first = qMin(index, op.position);
+        const int span = qMax(index, op.position) - first + 1;
+        replaced(first, span, span);
+        return true;
+    }
+    case Operation::Kind::SetSpeaker:
+        segments[index].speaker = speakerHandle(transcript, op.speakerID);
+        return true;
+    default:
+        return false;
+    }
+}
+
+}
+}
@@ -0,0 +1,200 @@
+#ifndef MODEL_SERVICE_EDIT_LOG_H
+#define MODEL_SERVICE_EDIT_LOG_H
+
+#include "Model/Data/Transcript.h"
+#include "Model/Data/SegmentIdMap.h"
+#include "TranscriptEditor.h"
+
+#include <QByteArray>
+#include <QDataStream>
+#include <QDateTime>
+#include <QString>
+#include <QStringList>
+
+namespace Model {
+namespace Service {
+
+/**
+ * @brief Append-only write-ahead log of a transcript's edits.
+ *
+ * The primary on-disk form of a transcript is its last compacted text file
+ * (editable.txt, or the reference text before the first compaction) plus
+ * the log next to it. Every edit appends one record, so its cost depends on
+ * the size of the edit, not of the segment or transcript:
+ *  - Operations: the TranscriptEditor::Operation list of an edit (a text
+ *    splice, split, join, insert, remove, move, speaker change...). Undo and
+ *    redo are logged as the inverse and the original operations.
+ *  - Snapshot: the whole transcript (speakers, segments and their IDs).
+ *  - Commit: a save point. Records after the last commit are edits the
+ *    user has not saved.
+ *
+ * Compaction rewrites the text file and resets the log to a snapshot of the
+ * compacted state followed by a commit. The snapshot is needed because the
+ * text format does not round-trip exactly (the parser trims text and merges
+ * adjacent same-speaker segments) and does not store segment IDs, which
+ * operations address segments by.
+ *
+ * The header records the hash of the text file the log applies to, so a log
+ * is only replayed on the exact file it was written against. Each record
+ * carries its length and an XXH64 checksum: replay stops at the first torn
+ * or corrupt record, which is what a crash mid-append leaves behind, and
+ * cuts the file there so later appends stay readable.
+ *
+ * Records are built from values and immutable versions only, and the file
+ * functions only touch their arguments: all of it can run on any thread.
+ */
+
+class EditLog {
+
+public:
+
+    /** @brief File name of the log inside a transcript folder. */
+    static constexpr const char* FileName = ".edit.log";
+
+    /** @brief Log bytes past the compacted snapshot after which compaction is due. */
+    static constexpr qint64 CompactionBytes = 1024 * 1024;
+
+    /** @brief What replay() found in a log. */
+    struct ReplayResult {
+        int applied = 0;        // Edit records applied (snapshots and operations)
+        int uncommitted = 0;    // Edit records after the last commit
+        qint64 tailBytes = 0;   // Log bytes past the leading snapshot (see needsCompaction())
+    };
+
+    /** @brief Returns the log path of the transcript in folderPath. */
+    static QString logPath(const QString& folderPath);
+
+    /**
+     * @brief Returns the text file a log of transcript applies to.
+     *
+     * The file the importer loads: the editable text if there is one,
+     * otherwise the reference text.
+     */
+    static QString basePathOf(const Model::Data::Transcript& transcript);
+
+    /**
+     * @brief Returns about the number of log bytes operationsRecord(operations) takes.
+     *
+     * Cheap enough for the thread that edits, which only needs the size.
+     */
+    static qint64 estimatedSize(const QVector<TranscriptEditor::Operation>& operations);
+
+
+    // === Records ===
+
+    /** @brief Serializes the operations of an edit (see TranscriptEditor::SegmentChange). */
+    static QByteArray operationsRecord(const QVector<TranscriptEditor::Operation>& operations);
+
+    /** @brief Serializes the whole current state of transcript (speakers, segments and IDs). */
+    static QByteArray snapshotRecord(const Model::Data::Transcript& transcript);
+
+    /** @brief Serializes a save point made at savedAt. */
+    static QByteArray commitRecord(const QDateTime& savedAt);
+
+
+    // === Files ===
+
+    /**
+     * @brief Appends record to the log, creating it if needed.
+     *
+     * A new log is written against the first existing file among basePaths
+     * (see basePathOf()); its hash goes into the header.
+     */
+    static bool append(const QString& logPath,
+                       const QStringList& basePaths,
+                       const QByteArray& record,
+                       QString* errorMessage = nullptr);
+
+    /**
+     * @brief Atomically replaces the log after a compaction.
+     *
+     * The new log applies to basePath (just written) and holds snapshot
+     * (see snapshotRecord()) followed by a commit at savedAt.
+     */
+    static bool reset(const QString& logPath,
+                      const QString& basePath,
+                      const QByteArray& snapshot,
+                      const QDateTime& savedAt,
+                      QString* errorMessage = nullptr);
+
+    /**
+     * @brief Replays the log of transcript on top of its parsed text file.
+     *
+     * Does nothing (returning true, with an empty outResult) if there is no
+     * log. Records are applied to a copy, and transcript is only replaced
+     * if every intact record applied.
+     *
+     * A log written against a different version of the text file cannot be
+     * applied; it is renamed to "<log>.stale" and false is returned, so the
+     * edits it holds are not lost silently.
+     */
+    static bool replay(Model::Data::Transcript& transcript,
+                       ReplayResult* outResult = nullptr,
+                       QString* errorMessage = nullptr);
+
+private:
+
+    enum class RecordKind : quint8 {
+        Snapshot = 2,
+        Commit = 3,
+        Operations = 4
+    };
+
+    static constexpr quint32 Magic = 0x54454C31;   // "TEL1"
+    static constexpr quint16 FormatVersion = 2;
+
+    // Pinned so the encoding does not follow the Qt version that wrote the file
+    static constexpr QDataStream::Version StreamVersion = QDataStream::Qt_6_0;
+
+    // quint32 magic + quint16 version + quint64 base hash
+    static constexpr int HeaderSize = 14;
+
+    // Record framing: quint32 payload length + quint64 payload checksum
+    static constexpr int RecordHeaderSize = 12;
+
+    /** @brief Returns the header of a log applying to a file with hash baseHash. */
+    static QByteArray header(quint64 baseHash);
+
+    /** @brief Returns record framed with its length and checksum. */
+    static QByteArray frame(const QByteArray& record);
+
+    /** @brief Returns the XXH64 hash of a text file read in text mode, or false if unreadable. */
+    static bool hashFile(const QString& path, quint64& outHash);
+
+    /** @brief Returns the handle for speakerID in transcript (-1 for an empty ID). */
+    static int speakerHandle(Model::Data::Transcript& transcript, const QString& speakerID);
+
+    /** @brief Writes the speakers and segments (with IDs) of transcript. */
+    static void writeState(QDataStream& out, const Model::Data::Transcript& transcript);
+
+    /** @brief Reads what writeState() wrote into transcript's speakers and segments. */
+    static void readState(QDataStream& in, Model::Data::Transcript& transcript);
+
+    /** @brief Writes one operation. */
+    static void writeOperation(QDataStream& out, const TranscriptEditor::Operation& op);
+
+    /** @brief Reads what writeOperation() wrote. */
+    static void readOperation(QDataStream& in, TranscriptEditor::Operation& op);
+
+    /** @brief Returns the kind of a record payload (0 if empty). */
+    static quint8 kindOf(const QByteArray& payload);
+
+    /**
+     * @brief Applies one edit record payload to transcript; false if it does not fit.
+     *
+     * ids maps the segment IDs of transcript to positions and is kept in sync.
+     */
+    static bool applyRecord(const QByteArray& payload,
+                            Model::Data::Transcript& transcript,
+                            Model::Data::SegmentIdMap& ids);
+
+    /** @brief Applies op like the TranscriptEditor function that made it; false if it does not fit. */
+    static bool applyOperation(const TranscriptEditor::Operation& op,
+                               Model::Data::Transcript& transcript,
+                               Model::Data::SegmentIdMap& ids);
+};
+
+}
+}
+
+#endif // MODEL_SERVICE_EDIT_LOG_H
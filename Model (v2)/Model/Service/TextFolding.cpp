@@ -0,0 +1,49 @@
+#include "TextFolding.h"
+
+namespace Model {
+namespace Service {
+
+TextFolding::Options TextFolding::optionsFor(Qt::CaseSensitivity cs, bool accentInsensitive) {
+
+    Options options = NoFolding;
+    if (cs == Qt::CaseInsensitive)
+        options |= CaseFold;
+    if (accentInsensitive)
+        options |= StripAccents | CompatibilityNormalize;
+    return options;
+}
+
+QString TextFolding::fold(const QString& text, Options options) {
+
+    if (!options || text.isEmpty())
+        return text;
+
+    QString out = text;
+
+    if (options.testFlag(StripAccents)) {
+        // Decompose first so accents become separate combining marks
+        out = out.normalized(options.testFlag(CompatibilityNormalize)
+                                 ? QString::NormalizationForm_KD
+                                 : QString::NormalizationForm_D);
+
+        QString stripped;
+        stripped.reserve(out.size());
+        for (int i = 0; i < out.size(); ++i) {
+            const QChar ch = out.at(i);
+            if (ch.category() != QChar::Mark_NonSpacing)
+                stripped.append(ch);
+        }
+        out = stripped;
+    }
+    else if (options.testFlag(CompatibilityNormalize)) {
+        out = out.normalized(QString::NormalizationForm_KC);
+    }
+
+    if (options.testFlag(CaseFold))
+        out = out.toCaseFolded();
+
+    return out;
+}
+
+}
+}
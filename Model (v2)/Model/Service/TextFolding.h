@@ -0,0 +1,49 @@
+#ifndef MODEL_SERVICE_TEXT_FOLDING_H
+#define MODEL_SERVICE_TEXT_FOLDING_H
+
+#include <QString>
+#include <QFlags>
+
+namespace Model {
+namespace Service {
+
+/**
+ * @brief Builds normalized "shadow" copies of text for insensitive matching.
+ *
+ * Folding both the text and the pattern once turns a case- or
+ * accent-insensitive search into a plain case-sensitive substring scan.
+ * Folded text is only used for matching; its positions do not map back
+ * to the original text.
+ */
+
+class TextFolding {
+
+public:
+
+    enum Option {
+        NoFolding = 0x0,
+        CaseFold = 0x1,                 ///< Unicode simple case folding
+        StripAccents = 0x2,             ///< Decompose and drop combining marks ("é" -> "e")
+        CompatibilityNormalize = 0x4    ///< NFKC (e.g. ligatures, full-width forms)
+    };
+    Q_DECLARE_FLAGS(Options, Option)
+
+    /**
+     * @brief Returns the options needed for the given search settings.
+     *
+     * Case-insensitive search adds CaseFold; accent-insensitive search adds
+     * StripAccents and CompatibilityNormalize.
+     */
+    static Options optionsFor(Qt::CaseSensitivity cs, bool accentInsensitive);
+
+    /** @brief Returns the folded form of text. */
+    static QString fold(const QString& text, Options options);
+
+};
+
+Q_DECLARE_OPERATORS_FOR_FLAGS(TextFolding::Options)
+
+}
+}
+
+#endif // MODEL_SERVICE_TEXT_FOLDING_H
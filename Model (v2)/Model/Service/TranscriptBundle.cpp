@@ -0,0 +1,446 @@
+#include "TranscriptBundle.h"
+
+#include <QDataStream>
+#include <QDir>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QSaveFile>
+
+namespace Model {
+namespace Service {
+
+using namespace Model::Data;
+
+bool TranscriptBundle::isBundlePath(const QString& path) {
+
+    return QFileInfo(path).suffix().compare(QLatin1String(Suffix), Qt::CaseInsensitive) == 0;
+}
+
+bool TranscriptBundle::prepare(const Transcript& transcript,
+                               const QString& bundlePath,
+                               bool includeAudio,
+                               Plan& outPlan,
+                               QString* errorMessage) {
+    if (bundlePath.isEmpty()) {
+        if (errorMessage)
+            *errorMessage = QStringLiteral("Target path for the bundle is empty.");
+        return false;
+    }
+
+    Plan plan;
+    plan.transcriptID = transcript.id;
+    plan.bundlePath = QFileInfo(bundlePath).absoluteFilePath();
+    plan.speakers = transcript.speakers;
+    plan.generation = transcript.generation();
+    plan.savedAt = QDateTime::currentDateTimeUtc();
+
+    plan.segmentSpeakers.reserve(transcript.segments.size());
+    plan.segmentTexts.reserve(transcript.segments.size());
+    for (const Segment& seg : transcript.segments) {
+        plan.segmentSpeakers.push_back(seg.speaker);
+        plan.segmentTexts.push_back(seg.text());
+    }
+
+    if (includeAudio && transcript.hasAudio()) {
+        QString audioPath = transcript.audioPath;
+        if (QFileInfo(audioPath).isRelative())
+            audioPath = QDir(transcript.folderPath).filePath(audioPath);
+
+        if (QFileInfo::exists(audioPath))
+            plan.audioPath = audioPath;
+    }
+
+    const QDateTime imported = transcript.dateImported.isValid() ? transcript.dateImported : plan.savedAt;
+
+    plan.meta.insert(QStringLiteral("id"), transcript.id);
+    plan.meta.insert(QStringLiteral("title"), transcript.title);
+    plan.meta.insert(QStringLiteral("dateImported"), imported.toString(Qt::ISODate));
+    plan.meta.insert(QStringLiteral("lastEdited"), plan.savedAt.toString(Qt::ISODate));
+    if (!plan.audioPath.isEmpty())
+        plan.meta.insert(QStringLiteral("audioFileName"), QFileInfo(plan.audioPath).fileName());
+
+    outPlan = plan;
+    return true;
+}
+
+bool TranscriptBundle::write(const Plan& plan, QString* errorMessage) {
+
+    QSaveFile f(plan.bundlePath);
+    if (!f.open(QIODevice::WriteOnly)) {
+        if (errorMessage)
+            *errorMessage = QStringLiteral("Cannot write bundle: %1").arg(plan.bundlePath);
+        return false;
+    }
+
+    QDataStream out(&f);
+    out.setVersion(StreamVersion);
+
+    // Placeholder: the header is written last, once every offset is known
+    f.write(QByteArray(HeaderSize, '\0'));
+
+    // 1) Text blocks, filled segment by segment and compressed one at a time
+    QVector<BlockEntry> blockTable;
+    QVector<SegmentEntry> segmentIndex;
+    segmentIndex.reserve(plan.segmentTexts.size());
+
+    QByteArray raw;
+    const auto flushBlock = [&]() {
+        if (raw.isEmpty())
+            return;
+
+        const QByteArray compressed = qCompress(raw);
+
+        BlockEntry block;
+        block.offset = quint64(f.pos());
+        block.compressedSize = quint32(compressed.size());
+        block.rawSize = quint32(raw.size());
+        blockTable.push_back(block);
+
+        f.write(compressed);
+        raw.clear();
+    };
+
+    for (int i = 0; i < plan.segmentTexts.size(); ++i) {
+        const QByteArray utf8 = plan.segmentTexts.at(i).toUtf8();
+
+        SegmentEntry entry;
+        entry.speaker = plan.segmentSpeakers.value(i, -1);
+        entry.block = quint32(blockTable.size());
+        entry.offset = quint32(raw.size());
+        entry.length = quint32(utf8.size());
+        segmentIndex.push_back(entry);
+
+        raw += utf8;
+        if (raw.size() >= BlockSize)
+            flushBlock();
+    }
+    flushBlock();
+
+    // 2) Block table and segment index
+    const quint64 blockTableOffset = quint64(f.pos());
+    for (const BlockEntry& block : blockTable)
+        out << block.offset << block.compressedSize << block.rawSize;
+
+    const quint64 segmentIndexOffset = quint64(f.pos());
+    for (const SegmentEntry& entry : segmentIndex)
+        out << entry.speaker << entry.block << entry.offset << entry.length;
+
+    // 3) Speakers and metadata
+    const quint64 speakerTableOffset = quint64(f.pos());
+    out << qint32(plan.speakers.size());
+    for (const Speaker& sp : plan.speakers)
+        out << sp.id << sp.displayName << sp.color;
+
+    const quint64 metaOffset = quint64(f.pos());
+    const QByteArray metaJson = QJsonDocument(plan.meta).toJson(QJsonDocument::Compact);
+    f.write(metaJson);
+
+    // 4) Audio, copied as is (already compressed by its codec)
+    const quint64 audioOffset = quint64(f.pos());
+    quint64 audioSize = 0;
+    quint16 flags = 0;
+
+    if (!plan.audioPath.isEmpty()) {
+        QFile audio(plan.audioPath);
+        if (!audio.open(QIODevice::ReadOnly)) {
+            if (errorMessage)
+                *errorMessage = QStringLiteral("Cannot read audio file: %1").arg(plan.audioPath);
+            f.cancelWriting();
+            return false;
+        }
+
+        while (!audio.atEnd()) {
+            const QByteArray chunk = audio.read(CopyChunkSize);
+            if (chunk.isEmpty() || f.write(chunk) != chunk.size())
+                break;
+            audioSize += quint64(chunk.size());
+        }
+
+        if (audioSize != quint64(audio.size())) {
+            if (errorMessage)
+                *errorMessage = QStringLiteral("Failed to copy audio into bundle: %1").arg(plan.bundlePath);
+            f.cancelWriting();
+            return false;
+        }
+        flags |= FlagHasAudio;
+    }
+
+    // 5) Header
+    f.seek(0);
+    out << Magic << FormatVersion << flags
+        << quint32(segmentIndex.size()) << quint32(blockTable.size())
+        << blockTableOffset << segmentIndexOffset << speakerTableOffset
+        << metaOffset << quint64(metaJson.size())
+        << audioOffset << audioSize;
+
+    if (out.status() != QDataStream::Ok || !f.commit()) {
+        if (errorMessage)
+            *errorMessage = QStringLiteral("Failed to write bundle: %1").arg(plan.bundlePath);
+        return false;
+    }
+
+    return true;
+}
+
+
+// === Reading ===
+
+bool TranscriptBundle::open(const QString& path, QString* errorMessage) {
+
+    close();
+
+    file.setFileName(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (errorMessage)
+            *errorMessage = QStringLiteral("Cannot open bundle: %1").arg(path);
+        return false;
+    }
+
+    const auto fail = [&](const QString& reason) {
+        if (errorMessage)
+            *errorMessage = QStringLiteral("Invalid bundle %1: %2").arg(path, reason);
+        close();
+        return false;
+    };
+
+    QDataStream in(&file);
+    in.setVersion(StreamVersion);
+    const quint64 fileSize = quint64(file.size());
+
+    quint32 magic = 0;
+    quint16 version = 0;
+    quint32 segmentCount = 0;
+    quint32 blockCount = 0;
+    quint64 blockTableOffset = 0;
+    quint64 segmentIndexOffset = 0;
+    quint64 speakerTableOffset = 0;
+    quint64 metaOffset = 0;
+    quint64 metaSize = 0;
+
+    in >> magic >> version >> flags >> segmentCount >> blockCount
+       >> blockTableOffset >> segmentIndexOffset >> speakerTableOffset
+       >> metaOffset >> metaSize >> audioOffset >> audioSize;
+
+    if (in.status() != QDataStream::Ok || magic != Magic)
+        return fail(QStringLiteral("not a transcript bundle"));
+    if (version != FormatVersion)
+        return fail(QStringLiteral("unsupported version %1").arg(version));
+
+    // Table sizes are checked against the file before anything is allocated
+    if (blockTableOffset + quint64(blockCount) * 16 > fileSize
+        || segmentIndexOffset + quint64(segmentCount) * 16 > fileSize
+        || speakerTableOffset > fileSize
+        || metaOffset + metaSize > fileSize
+        || audioOffset + audioSize > fileSize)
+        return fail(QStringLiteral("truncated file"));
+
+    file.seek(qint64(blockTableOffset));
+    blocks.resize(int(blockCount));
+    for (BlockEntry& block : blocks) {
+        in >> block.offset >> block.compressedSize >> block.rawSize;
+        if (block.offset + block.compressedSize > fileSize)
+            return fail(QStringLiteral("text block out of range"));
+    }
+
+    file.seek(qint64(segmentIndexOffset));
+    index.resize(int(segmentCount));
+    for (SegmentEntry& entry : index) {
+        in >> entry.speaker >> entry.block >> entry.offset >> entry.length;
+        // Empty segments never reach a block, so their block may be one past the end
+        if (entry.length == 0)
+            continue;
+        if (entry.block >= blockCount
+            || quint64(entry.offset) + entry.length > blocks.at(int(entry.block)).rawSize)
+            return fail(QStringLiteral("segment out of range"));
+    }
+
+    file.seek(qint64(speakerTableOffset));
+    qint32 speakerCount = 0;
+    in >> speakerCount;
+    for (int i = 0; i < speakerCount && in.status() == QDataStream::Ok; ++i) {
+        Speaker sp;
+        in >> sp.id >> sp.displayName >> sp.color;
+        speakerTable.push_back(sp);
+    }
+
+    for (const SegmentEntry& entry : index) {
+        if (entry.speaker < -1 || entry.speaker >= speakerTable.size())
+            return fail(QStringLiteral("unknown speaker"));
+    }
+
+    file.seek(qint64(metaOffset));
+    const QJsonDocument doc = QJsonDocument::fromJson(file.read(qint64(metaSize)));
+    meta = doc.object();
+
+    if (in.status() != QDataStream::Ok)
+        return fail(QStringLiteral("unreadable tables"));
+
+    return true;
+}
+
+void TranscriptBundle::close() {
+
+    file.close();
+    flags = 0;
+    blocks.clear();
+    index.clear();
+    speakerTable.clear();
+    meta = QJsonObject();
+    audioOffset = 0;
+    audioSize = 0;
+    cachedBlock = -1;
+    cachedText.clear();
+}
+
+bool TranscriptBundle::isOpen() const {
+
+    return file.isOpen();
+}
+
+int TranscriptBundle::segmentCount() const {
+
+    return index.size();
+}
+
+const QVector<Speaker>& TranscriptBundle::speakers() const {
+
+    return speakerTable;
+}
+
+const QJsonObject& TranscriptBundle::metadata() const {
+
+    return meta;
+}
+
+QString TranscriptBundle::segmentSpeakerID(int segmentIndex) const {
+
+    const qint32 handle = index.value(segmentIndex).speaker;
+    return handle >= 0 ? speakerTable.at(handle).id : QString();
+}
+
+bool TranscriptBundle::segmentText(int segmentIndex, QString& outText, QString* errorMessage) {
+
+    if (segmentIndex < 0 || segmentIndex >= index.size()) {
+        if (errorMessage)
+            *errorMessage = QStringLiteral("Segment index out of range: %1").arg(segmentIndex);
+        return false;
+    }
+
+    const SegmentEntry& entry = index.at(segmentIndex);
+    if (entry.length == 0) {
+        outText.clear();
+        return true;
+    }
+
+    if (!loadBlock(int(entry.block), errorMessage))
+        return false;
+
+    outText = QString::fromUtf8(cachedText.constData() + entry.offset, qsizetype(entry.length));
+    return true;
+}
+
+bool TranscriptBundle::hasAudio() const {
+
+    return (flags & FlagHasAudio) != 0;
+}
+
+QString TranscriptBundle::audioFileName() const {
+
+    const QString name = meta.value(QStringLiteral("audioFileName")).toString();
+    return name.isEmpty() ? QStringLiteral("audio") : name;
+}
+
+bool TranscriptBundle::extractAudio(const QString& targetPath, QString* errorMessage) {
+
+    if (!hasAudio()) {
+        if (errorMessage)
+            *errorMessage = QStringLiteral("Bundle has no audio: %1").arg(file.fileName());
+        return false;
+    }
+
+    QSaveFile out(targetPath);
+    if (!out.open(QIODevice::WriteOnly)) {
+        if (errorMessage)
+            *errorMessage = QStringLiteral("Cannot write audio file: %1").arg(targetPath);
+        return false;
+    }
+
+    file.seek(qint64(audioOffset));
+    quint64 remaining = audioSize;
+
+    while (remaining > 0) {
+        const QByteArray chunk = file.read(qMin<qint64>(CopyChunkSize, qint64(remaining)));
+        if (chunk.isEmpty() || out.write(chunk) != chunk.size())
+            break;
+        remaining -= quint64(chunk.size());
+    }
+
+    if (remaining > 0 || !out.commit()) {
+        if (errorMessage)
+            *errorMessage = QStringLiteral("Failed to extract audio to: %1").arg(targetPath);
+        return false;
+    }
+
+    return true;
+}
+
+bool TranscriptBundle::readTranscript(Transcript& outTranscript, QString* errorMessage) {
+
+    Transcript transcript;
+    transcript.setSpeakers(speakerTable);
+
+    // Segments are stored in order, so every block is decompressed exactly once
+    QString text;
+    for (int i = 0; i < index.size(); ++i) {
+        if (!segmentText(i, text, errorMessage))
+            return false;
+        transcript.segments.push_back(Segment(index.at(i).speaker, text));
+    }
+    transcript.ensureSegmentIDs();
+
+    transcript.id = meta.value(QStringLiteral("id")).toString();
+    transcript.title = meta.value(QStringLiteral("title")).toString();
+    transcript.dateImported = QDateTime::fromString(meta.value(QStringLiteral("dateImported")).toString(),
+                                                    Qt::ISODate);
+    transcript.lastEdited = QDateTime::fromString(meta.value(QStringLiteral("lastEdited")).toString(),
+                                                  Qt::ISODate);
+    transcript.bundlePath = QFileInfo(file.fileName()).absoluteFilePath();
+
+    if (transcript.title.isEmpty())
+        transcript.title = QFileInfo(file.fileName()).completeBaseName();
+    if (transcript.id.isEmpty())
+        transcript.id = transcript.bundlePath;
+
+    outTranscript = transcript;
+    return true;
+}
+
+
+// === Private helpers ===
+
+bool TranscriptBundle::loadBlock(int block, QString* errorMessage) {
+
+    if (block == cachedBlock)
+        return true;
+
+    const BlockEntry& entry = blocks.at(block);
+
+    file.seek(qint64(entry.offset));
+    const QByteArray compressed = file.read(qint64(entry.compressedSize));
+    QByteArray raw = qUncompress(compressed);
+
+    if (compressed.size() != qsizetype(entry.compressedSize) || raw.size() != qsizetype(entry.rawSize)) {
+        if (errorMessage)
+            *errorMessage = QStringLiteral("Corrupt text block %1 in bundle: %2").arg(block).arg(file.fileName());
+        cachedBlock = -1;
+        cachedText.clear();
+        return false;
+    }
+
+    cachedBlock = block;
+    cachedText = std::move(raw);
+    return true;
+}
+
+}
+}
@@ -0,0 +1,177 @@
+#ifndef MODEL_SERVICE_TRANSCRIPT_BUNDLE_H
+#define MODEL_SERVICE_TRANSCRIPT_BUNDLE_H
+
+#include "Model/Data/Transcript.h"
+
+#include <QByteArray>
+#include <QDataStream>
+#include <QDateTime>
+#include <QFile>
+#include <QJsonObject>
+#include <QString>
+#include <QVector>
+
+namespace Model {
+namespace Service {
+
+/**
+ * @brief Single-file transcript bundle (.tbundle): text, speakers, metadata and audio.
+ *
+ * An alternative to the folder layout (text files + meta.json + audio)
+ * that copies and syncs as one file. Layout, all integers big-endian:
+ *
+ *  - Header (HeaderSize bytes): magic, version, flags, counts and the
+ *    offset of every section below.
+ *  - Text blocks: runs of consecutive segment texts (UTF-8, about
+ *    BlockSize bytes), each compressed on its own with qCompress().
+ *  - Block table: offset, compressed and uncompressed size of each block.
+ *  - Segment index: speaker handle, block, offset and length of each segment.
+ *  - Speaker table: ID, display name and color of each speaker.
+ *  - Metadata: compact JSON (id, title, dates, audio file name).
+ *  - Audio (optional): the original audio file, stored as is.
+ *
+ * Reading (open()) loads the header, tables and metadata only. The text of
+ * one segment is then fetched by decompressing just its block, so random
+ * access never inflates the whole file; the last block read is cached.
+ *
+ * Writing is split like TranscriptExporter: prepare() reads the transcript
+ * on its thread, write() only touches the plan and can run on any thread.
+ * The file is replaced atomically through QSaveFile.
+ */
+
+class TranscriptBundle {
+
+public:
+
+    /** @brief File suffix of bundles (without the dot). */
+    static constexpr const char* Suffix = "tbundle";
+
+    /** @brief Uncompressed bytes after which a text block is closed (segments are never split). */
+    static constexpr int BlockSize = 64 * 1024;
+
+    /** @brief Immutable description of a bundle to write, produced by prepare(). */
+    struct Plan {
+        QString transcriptID;
+        QString bundlePath;                     // Absolute target file
+        QVector<Model::Data::Speaker> speakers;
+        QVector<qint32> segmentSpeakers;        // Speaker handle of each segment
+        QVector<QString> segmentTexts;
+        QJsonObject meta;
+        QString audioPath;                      // Absolute; empty to store no audio
+        QDateTime savedAt;
+        quint64 generation = 0;                 // Transcript::generation() captured by the plan
+    };
+
+    /** @brief Returns true if path names a bundle (by suffix). */
+    static bool isBundlePath(const QString& path);
+
+    /**
+     * @brief Captures transcript for writing to bundlePath.
+     *
+     * With includeAudio, the transcript's audio file (if any) is stored too.
+     */
+    static bool prepare(const Model::Data::Transcript& transcript,
+                        const QString& bundlePath,
+                        bool includeAudio,
+                        Plan& outPlan,
+                        QString* errorMessage = nullptr);
+
+    /** @brief Writes plan to plan.bundlePath. Thread-safe: reads nothing but plan. */
+    static bool write(const Plan& plan, QString* errorMessage = nullptr);
+
+
+    // === Reading ===
+
+    /** @brief Constructs a closed reader. */
+    TranscriptBundle() = default;
+
+    /** @brief Opens the bundle at path and loads its tables and metadata. */
+    bool open(const QString& path, QString* errorMessage = nullptr);
+
+    /** @brief Closes the file and drops all loaded data. */
+    void close();
+
+    /** @brief Returns true if a bundle is open. */
+    bool isOpen() const;
+
+    /** @brief Returns the number of segments. */
+    int segmentCount() const;
+
+    /** @brief Returns the speaker table. */
+    const QVector<Model::Data::Speaker>& speakers() const;
+
+    /** @brief Returns the metadata object. */
+    const QJsonObject& metadata() const;
+
+    /** @brief Returns the speaker ID of the segment at segmentIndex (empty if it has none). */
+    QString segmentSpeakerID(int segmentIndex) const;
+
+    /** @brief Reads the text of the segment at segmentIndex, decompressing only its block. */
+    bool segmentText(int segmentIndex, QString& outText, QString* errorMessage = nullptr);
+
+    /** @brief Returns true if the bundle stores an audio stream. */
+    bool hasAudio() const;
+
+    /** @brief Returns the file name the audio had when it was bundled (keeps its suffix). */
+    QString audioFileName() const;
+
+    /** @brief Copies the audio stream to targetPath, in chunks. */
+    bool extractAudio(const QString& targetPath, QString* errorMessage = nullptr);
+
+    /**
+     * @brief Reads the whole bundle into outTranscript.
+     *
+     * Sets bundlePath; folderPath and audioPath stay empty (see
+     * TranscriptManager for where bundled audio is extracted to).
+     */
+    bool readTranscript(Model::Data::Transcript& outTranscript, QString* errorMessage = nullptr);
+
+private:
+
+    struct BlockEntry {
+        quint64 offset = 0;
+        quint32 compressedSize = 0;
+        quint32 rawSize = 0;
+    };
+
+    struct SegmentEntry {
+        qint32 speaker = -1;
+        quint32 block = 0;
+        quint32 offset = 0;
+        quint32 length = 0;
+    };
+
+    static constexpr quint32 Magic = 0x54454231;   // "TEB1"
+    static constexpr quint16 FormatVersion = 1;
+    static constexpr quint16 FlagHasAudio = 0x0001;
+
+    // Fixed QDataStream encoding (QString, floats) for bundles shared between builds
+    static constexpr QDataStream::Version StreamVersion = QDataStream::Qt_6_0;
+
+    // magic, version, flags, segment count, block count, 7 section offsets/sizes
+    static constexpr int HeaderSize = 72;
+
+    static constexpr qint64 CopyChunkSize = 64 * 1024;
+
+    /** @brief Makes block the cached one, reading and decompressing it if needed. */
+    bool loadBlock(int block, QString* errorMessage);
+
+    QFile file;
+    quint16 flags = 0;
+
+    QVector<BlockEntry> blocks;
+    QVector<SegmentEntry> index;
+    QVector<Model::Data::Speaker> speakerTable;
+    QJsonObject meta;
+
+    quint64 audioOffset = 0;
+    quint64 audioSize = 0;
+
+    int cachedBlock = -1;
+    QByteArray cachedText;   // Uncompressed UTF-8 of cachedBlock
+};
+
+}
+}
+
+#endif // MODEL_SERVICE_TRANSCRIPT_BUNDLE_H
@@ -0,0 +1,661 @@
+#include "TranscriptDatabase.h"
+
+#include <QColor>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QVariant>
+
+#include <algorithm>
+
+namespace Model {
+namespace Service {
+
+using namespace Model::Data;
+
+namespace {
+
+/** @brief Returns "what: driver error" for a failed query. */
+QString sqlError(const QString& what, const QSqlError& error) {
+
+    return QStringLiteral("%1: %2").arg(what, error.text());
+}
+
+}
+
+TranscriptDatabase::TranscriptDatabase()
+    : connectionName(QStringLiteral("transcripts-%1").arg(quintptr(this), 0, 16))
+{}
+
+TranscriptDatabase::~TranscriptDatabase() {
+
+    close();
+}
+
+bool TranscriptDatabase::open(const QString& path, QString* errorMessage) {
+
+    close();
+
+    if (!QSqlDatabase::isDriverAvailable(QStringLiteral("QSQLITE"))) {
+        if (errorMessage)
+            *errorMessage = QStringLiteral("The Qt SQLite driver (QSQLITE) is not available.");
+        return false;
+    }
+
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase(QStringLiteral("QSQLITE"), connectionName);
+        db.setDatabaseName(path);
+
+        if (!db.open()) {
+            if (errorMessage)
+                *errorMessage = sqlError(QStringLiteral("Cannot open database %1").arg(path), db.lastError());
+        }
+    }
+
+    if (!isOpen() || !createSchema(errorMessage)) {
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+void TranscriptDatabase::close() {
+
+    discardPendingChanges();
+    fts = false;
+
+    if (!QSqlDatabase::contains(connectionName))
+        return;
+
+    // The handle must be gone before the connection is removed
+    {
+        QSqlDatabase db = QSqlDatabase::database(connectionName, false);
+        db.close();
+    }
+    QSqlDatabase::removeDatabase(connectionName);
+}
+
+bool TranscriptDatabase::isOpen() const {
+
+    return QSqlDatabase::contains(connectionName)
+           && QSqlDatabase::database(connectionName, false).isOpen();
+}
+
+bool TranscriptDatabase::hasFullTextIndex() const {
+
+    return fts;
+}
+
+
+// === Whole transcripts ===
+
+QStringList TranscriptDatabase::transcriptIDs(QString* errorMessage) const {
+
+    QStringList ids;
+
+    QSqlQuery q(QSqlDatabase::database(connectionName, false));
+    if (!q.exec(QStringLiteral("SELECT id FROM transcripts ORDER BY title, id"))) {
+        if (errorMessage)
+            *errorMessage = sqlError(QStringLiteral("Cannot list transcripts"), q.lastError());
+        return ids;
+    }
+
+    while (q.next())
+        ids << q.value(0).toString();
+    return ids;
+}
+
+bool TranscriptDatabase::contains(const QString& id) const {
+
+    QSqlQuery q(QSqlDatabase::database(connectionName, false));
+    q.prepare(QStringLiteral("SELECT 1 FROM transcripts WHERE id = ?"));
+    q.addBindValue(id);
+    return q.exec() && q.next();
+}
+
+bool TranscriptDatabase::storeTranscript(const Transcript& transcript, QString* errorMessage) {
+
+    QSqlDatabase db = QSqlDatabase::database(connectionName, false);
+    if (!db.transaction()) {
+        if (errorMessage)
+            *errorMessage = sqlError(QStringLiteral("Cannot start transaction"), db.lastError());
+        return false;
+    }
+
+    QVector<qint32> speakers;
+    QVector<QString> texts;
+    speakers.reserve(transcript.segments.size());
+    texts.reserve(transcript.segments.size());
+    for (const Segment& seg : transcript.segments) {
+        speakers.push_back(seg.speaker);
+        texts.push_back(seg.text());
+    }
+
+    QSqlQuery q(db);
+    q.prepare(QStringLiteral("DELETE FROM segments WHERE transcript_id = ?"));
+    q.addBindValue(transcript.id);
+
+    bool ok = q.exec();
+    if (!ok && errorMessage)
+        *errorMessage = sqlError(QStringLiteral("Cannot store transcript %1").arg(transcript.id), q.lastError());
+
+    ok = ok && writeTranscriptRow(transcript, errorMessage)
+            && writeSpeakers(transcript.id, transcript.speakers, errorMessage)
+            && writeSegments(transcript.id, 0, speakers, texts, errorMessage);
+
+    if (!ok || !db.commit()) {
+        if (ok && errorMessage)
+            *errorMessage = sqlError(QStringLiteral("Cannot store transcript %1").arg(transcript.id), db.lastError());
+        db.rollback();
+        return false;
+    }
+
+    // Everything queued for this transcript is part of what was just stored
+    pending.erase(std::remove_if(pending.begin(), pending.end(),
+                                 [&](const PendingChange& c) { return c.transcriptID == transcript.id; }),
+                  pending.end());
+    pendingHeaders.remove(transcript.id);
+    return true;
+}
+
+bool TranscriptDatabase::loadTranscript(const QString& id,
+                                        Transcript& outTranscript,
+                                        QString* errorMessage) const {
+
+    const QSqlDatabase db = QSqlDatabase::database(connectionName, false);
+
+    QSqlQuery q(db);
+    q.prepare(QStringLiteral("SELECT title, folder_path, reference_path, editable_path, audio_path, "
+                             "date_imported, last_edited FROM transcripts WHERE id = ?"));
+    q.addBindValue(id);
+    if (!q.exec() || !q.next()) {
+        if (errorMessage)
+            *errorMessage = sqlError(QStringLiteral("Cannot load transcript %1").arg(id), q.lastError());
+        return false;
+    }
+
+    Transcript transcript;
+    transcript.id = id;
+    transcript.title = q.value(0).toString();
+    transcript.folderPath = q.value(1).toString();
+    transcript.referencePath = q.value(2).toString();
+    transcript.editablePath = q.value(3).toString();
+    transcript.audioPath = q.value(4).toString();
+    transcript.dateImported = QDateTime::fromString(q.value(5).toString(), Qt::ISODate);
+    transcript.lastEdited = QDateTime::fromString(q.value(6).toString(), Qt::ISODate);
+
+    // Stored handles are the speaker indexes; map them in case of gaps
+    QVector<Speaker> speakers;
+    QHash<int, int> speakerByHandle;
+
+    q.prepare(QStringLiteral("SELECT handle, speaker_id, display_name, color FROM speakers "
+                             "WHERE transcript_id = ? ORDER BY handle"));
+    q.addBindValue(id);
+    if (!q.exec()) {
+        if (errorMessage)
+            *errorMessage = sqlError(QStringLiteral("Cannot load speakers of %1").arg(id), q.lastError());
+        return false;
+    }
+    while (q.next()) {
+        const QString color = q.value(3).toString();
+        speakerByHandle.insert(q.value(0).toInt(), speakers.size());
+        speakers.push_back(Speaker(q.value(1).toString(), q.value(2).toString(),
+                                   color.isEmpty() ? QColor() : QColor(color)));
+    }
+    transcript.setSpeakers(speakers);
+
+    q.prepare(QStringLiteral("SELECT speaker_handle, text FROM segments "
+                             "WHERE transcript_id = ? ORDER BY position"));
+    q.addBindValue(id);
+    q.setForwardOnly(true);
+    if (!q.exec()) {
+        if (errorMessage)
+            *errorMessage = sqlError(QStringLiteral("Cannot load segments of %1").arg(id), q.lastError());
+        return false;
+    }
+    while (q.next())
+        transcript.segments.push_back(Segment(speakerByHandle.value(q.value(0).toInt(), -1),
+                                              q.value(1).toString()));
+
+    transcript.ensureSegmentIDs();
+    outTranscript = transcript;
+    return true;
+}
+
+bool TranscriptDatabase::removeTranscript(const QString& id, QString* errorMessage) {
+
+    pending.erase(std::remove_if(pending.begin(), pending.end(),
+                                 [&](const PendingChange& c) { return c.transcriptID == id; }),
+                  pending.end());
+    pendingHeaders.remove(id);
+
+    // Speakers and segments go with it (ON DELETE CASCADE)
+    QSqlQuery q(QSqlDatabase::database(connectionName, false));
+    q.prepare(QStringLiteral("DELETE FROM transcripts WHERE id = ?"));
+    q.addBindValue(id);
+    if (!q.exec()) {
+        if (errorMessage)
+            *errorMessage = sqlError(QStringLiteral("Cannot remove transcript %1").arg(id), q.lastError());
+        return false;
+    }
+    return true;
+}
+
+
+// === Batched edits ===
+
+void TranscriptDatabase::recordChange(const Transcript& transcript,
+                                      int first,
+                                      int removedCount,
+                                      int insertedCount) {
+    PendingChange change;
+    change.transcriptID = transcript.id;
+
+    int from = 0;
+    int count = transcript.segments.size();
+
+    if (first >= 0) {
+        change.first = first;
+        change.removedCount = removedCount;
+        from = first;
+        count = insertedCount;
+    }
+
+    // Typing: the segments replaced in place are already queued, refresh those copies
+    if (first >= 0 && removedCount == insertedCount && !pending.isEmpty()
+        && pending.last().transcriptID == transcript.id) {
+        PendingChange& last = pending.last();
+        const int offset = last.first < 0 ? first : first - last.first;
+        if (offset >= 0 && offset + insertedCount <= last.segments.size()) {
+            for (int k = 0; k < insertedCount; ++k)
+                last.segments[offset + k] = transcript.segments.at(first + k);
+            recordHeader(transcript);
+            return;
+        }
+    }
+
+    // Segments are implicitly shared: queuing copies no text
+    change.segments.reserve(count);
+    for (int k = 0; k < count; ++k)
+        change.segments.push_back(transcript.segments.at(from + k));
+
+    // A full replacement makes everything queued before it irrelevant
+    if (change.first < 0) {
+        pending.erase(std::remove_if(pending.begin(), pending.end(),
+                                     [&](const PendingChange& c) { return c.transcriptID == transcript.id; }),
+                      pending.end());
+    }
+    pending.push_back(change);
+
+    recordHeader(transcript);
+}
+
+void TranscriptDatabase::recordHeader(const Transcript& transcript) {
+
+    PendingHeader& header = pendingHeaders[transcript.id];
+    header.speakers = transcript.speakers;
+    header.lastEdited = transcript.lastEdited;
+}
+
+void TranscriptDatabase::discardPendingChanges() {
+
+    pending.clear();
+    pendingHeaders.clear();
+}
+
+bool TranscriptDatabase::hasPendingChanges() const {
+
+    return !pending.isEmpty() || !pendingHeaders.isEmpty();
+}
+
+bool TranscriptDatabase::hasPendingChanges(const QString& id) const {
+
+    return pendingHeaders.contains(id);
+}
+
+bool TranscriptDatabase::flush(QString* errorMessage) {
+
+    if (!hasPendingChanges())
+        return true;
+
+    QSqlDatabase db = QSqlDatabase::database(connectionName, false);
+    if (!db.transaction()) {
+        if (errorMessage)
+            *errorMessage = sqlError(QStringLiteral("Cannot start transaction"), db.lastError());
+        return false;
+    }
+
+    bool ok = true;
+
+    for (auto it = pendingHeaders.constBegin(); ok && it != pendingHeaders.constEnd(); ++it) {
+        QSqlQuery q(db);
+        q.prepare(QStringLiteral("UPDATE transcripts SET last_edited = ? WHERE id = ?"));
+        q.addBindValue(it->lastEdited.toString(Qt::ISODate));
+        q.addBindValue(it.key());
+
+        if (!q.exec()) {
+            if (errorMessage)
+                *errorMessage = sqlError(QStringLiteral("Cannot update transcript %1").arg(it.key()), q.lastError());
+            ok = false;
+            break;
+        }
+
+        ok = writeSpeakers(it.key(), it->speakers, errorMessage);
+    }
+
+    for (int i = 0; ok && i < pending.size(); ++i)
+        ok = applyChange(pending.at(i), errorMessage);
+
+    if (!ok || !db.commit()) {
+        if (ok && errorMessage)
+            *errorMessage = sqlError(QStringLiteral("Cannot write changes"), db.lastError());
+        db.rollback();
+        return false;
+    }
+
+    pending.clear();
+    pendingHeaders.clear();
+    return true;
+}
+
+
+// === Search ===
+
+bool TranscriptDatabase::search(const QString& text,
+                                const QString& speakerID,
+                                QVector<SegmentHit>& outHits,
+                                int limit,
+                                QString* errorMessage) {
+    outHits.clear();
+
+    if (text.trimmed().isEmpty())
+        return true;
+
+    if (!flush(errorMessage))
+        return false;
+
+    QString sql = QStringLiteral("SELECT s.transcript_id, s.position, COALESCE(sp.speaker_id, ''), s.text ");
+
+    if (fts) {
+        sql += QStringLiteral("FROM segments_fts JOIN segments s ON s.id = segments_fts.rowid ");
+    }
+    else {
+        sql += QStringLiteral("FROM segments s ");
+    }
+
+    sql += QStringLiteral("LEFT JOIN speakers sp ON sp.transcript_id = s.transcript_id "
+                          "AND sp.handle = s.speaker_handle ");
+
+    sql += fts ? QStringLiteral("WHERE segments_fts MATCH ? ")
+               : QStringLiteral("WHERE s.text LIKE ? ESCAPE '\\' ");
+
+    if (!speakerID.isEmpty())
+        sql += QStringLiteral("AND sp.speaker_id = ? ");
+
+    sql += QStringLiteral("ORDER BY s.transcript_id, s.position LIMIT ?");
+
+    QSqlQuery q(QSqlDatabase::database(connectionName, false));
+    q.setForwardOnly(true);
+    q.prepare(sql);
+
+    if (fts) {
+        // One quoted phrase: FTS5 query syntax in text is taken literally
+        QString phrase = text.trimmed();
+        phrase.replace(QLatin1Char('"'), QStringLiteral("\"\""));
+        q.addBindValue(QLatin1Char('"') + phrase + QLatin1Char('"'));
+    }
+    else {
+        QString pattern = text;
+        pattern.replace(QLatin1Char('\\'), QStringLiteral("\\\\"))
+               .replace(QLatin1Char('%'), QStringLiteral("\\%"))
+               .replace(QLatin1Char('_'), QStringLiteral("\\_"));
+        q.addBindValue(QLatin1Char('%') + pattern + QLatin1Char('%'));
+    }
+
+    if (!speakerID.isEmpty())
+        q.addBindValue(speakerID);
+    q.addBindValue(limit);
+
+    if (!q.exec()) {
+        if (errorMessage)
+            *errorMessage = sqlError(QStringLiteral("Search failed"), q.lastError());
+        return false;
+    }
+
+    while (q.next()) {
+        SegmentHit hit;
+        hit.transcriptID = q.value(0).toString();
+        hit.position = q.value(1).toInt();
+        hit.speakerID = q.value(2).toString();
+        hit.text = q.value(3).toString();
+        outHits.push_back(hit);
+    }
+
+    return true;
+}
+
+
+// === Private helpers ===
+
+bool TranscriptDatabase::exec(const QString& sql, QString* errorMessage) const {
+
+    QSqlQuery q(QSqlDatabase::database(connectionName, false));
+    if (!q.exec(sql)) {
+        if (errorMessage)
+            *errorMessage = sqlError(QStringLiteral("Database setup failed"), q.lastError());
+        return false;
+    }
+    return true;
+}
+
+bool TranscriptDatabase::createSchema(QString* errorMessage) {
+
+    // WAL: readers are not blocked by a writer; NORMAL sync is durable in WAL mode
+    // except for the last transactions on power loss
+    const QStringList setup = {
+        QStringLiteral("PRAGMA journal_mode = WAL"),
+        QStringLiteral("PRAGMA synchronous = NORMAL"),
+        QStringLiteral("PRAGMA foreign_keys = ON"),
+
+        QStringLiteral("CREATE TABLE IF NOT EXISTS transcripts ("
+                       "id TEXT PRIMARY KEY, title TEXT NOT NULL DEFAULT '', "
+                       "folder_path TEXT, reference_path TEXT, editable_path TEXT, audio_path TEXT, "
+                       "date_imported TEXT, last_edited TEXT)"),
+
+        QStringLiteral("CREATE TABLE IF NOT EXISTS speakers ("
+                       "transcript_id TEXT NOT NULL REFERENCES transcripts(id) ON DELETE CASCADE, "
+                       "handle INTEGER NOT NULL, speaker_id TEXT NOT NULL, "
+                       "display_name TEXT, color TEXT, "
+                       "PRIMARY KEY (transcript_id, handle))"),
+        QStringLiteral("CREATE INDEX IF NOT EXISTS speakers_by_id ON speakers(speaker_id)"),
+
+        // Positions are not unique while a range is being shifted, hence a plain index
+        QStringLiteral("CREATE TABLE IF NOT EXISTS segments ("
+                       "id INTEGER PRIMARY KEY, "
+                       "transcript_id TEXT NOT NULL REFERENCES transcripts(id) ON DELETE CASCADE, "
+                       "position INTEGER NOT NULL, speaker_handle INTEGER NOT NULL, text TEXT NOT NULL)"),
+        QStringLiteral("CREATE INDEX IF NOT EXISTS segments_by_position ON segments(transcript_id, position)")
+    };
+
+    for (const QString& sql : setup) {
+        if (!exec(sql, errorMessage))
+            return false;
+    }
+
+    // Segments stored before the index existed (e.g. by a build without FTS5)
+    // are not in it yet; a new index is filled once below
+    bool ftsExisted = false;
+    {
+        QSqlQuery q(QSqlDatabase::database(connectionName, false));
+        ftsExisted = q.exec(QStringLiteral("SELECT 1 FROM sqlite_master WHERE name = 'segments_fts'"))
+                     && q.next();
+    }
+
+    // External-content FTS5 table: the text lives in segments only
+    fts = exec(QStringLiteral("CREATE VIRTUAL TABLE IF NOT EXISTS segments_fts "
+                              "USING fts5(text, content='segments', content_rowid='id')"), nullptr);
+    if (!fts)
+        return true;
+
+    const QStringList triggers = {
+        QStringLiteral("CREATE TRIGGER IF NOT EXISTS segments_ai AFTER INSERT ON segments BEGIN "
+                       "INSERT INTO segments_fts(rowid, text) VALUES (new.id, new.text); END"),
+        QStringLiteral("CREATE TRIGGER IF NOT EXISTS segments_ad AFTER DELETE ON segments BEGIN "
+                       "INSERT INTO segments_fts(segments_fts, rowid, text) VALUES ('delete', old.id, old.text); END"),
+        QStringLiteral("CREATE TRIGGER IF NOT EXISTS segments_au AFTER UPDATE OF text ON segments BEGIN "
+                       "INSERT INTO segments_fts(segments_fts, rowid, text) VALUES ('delete', old.id, old.text); "
+                       "INSERT INTO segments_fts(rowid, text) VALUES (new.id, new.text); END")
+    };
+
+    for (const QString& sql : triggers) {
+        if (!exec(sql, errorMessage))
+            return false;
+    }
+
+    if (!ftsExisted
+        && !exec(QStringLiteral("INSERT INTO segments_fts(segments_fts) VALUES ('rebuild')"), errorMessage))
+        return false;
+
+    return true;
+}
+
+bool TranscriptDatabase::writeTranscriptRow(const Transcript& transcript, QString* errorMessage) {
+
+    // Upsert, not REPLACE: replacing the row would cascade-delete its segments
+    QSqlQuery q(QSqlDatabase::database(connectionName, false));
+    q.prepare(QStringLiteral("INSERT INTO transcripts (id, title, folder_path, reference_path, editable_path, "
+                             "audio_path, date_imported, last_edited) VALUES (?, ?, ?, ?, ?, ?, ?, ?) "
+                             "ON CONFLICT(id) DO UPDATE SET title = excluded.title, "
+                             "folder_path = excluded.folder_path, reference_path = excluded.reference_path, "
+                             "editable_path = excluded.editable_path, audio_path = excluded.audio_path, "
+                             "date_imported = excluded.date_imported, last_edited = excluded.last_edited"));
+    q.addBindValue(transcript.id);
+    q.addBindValue(transcript.title);
+    q.addBindValue(transcript.folderPath);
+    q.addBindValue(transcript.referencePath);
+    q.addBindValue(transcript.editablePath);
+    q.addBindValue(transcript.audioPath);
+    q.addBindValue(transcript.dateImported.toString(Qt::ISODate));
+    q.addBindValue(transcript.lastEdited.toString(Qt::ISODate));
+
+    if (!q.exec()) {
+        if (errorMessage)
+            *errorMessage = sqlError(QStringLiteral("Cannot write transcript %1").arg(transcript.id), q.lastError());
+        return false;
+    }
+    return true;
+}
+
+bool TranscriptDatabase::writeSpeakers(const QString& id, const QVector<Speaker>& speakers, QString* errorMessage) {
+
+    const QSqlDatabase db = QSqlDatabase::database(connectionName, false);
+
+    QSqlQuery q(db);
+    q.prepare(QStringLiteral("DELETE FROM speakers WHERE transcript_id = ?"));
+    q.addBindValue(id);
+    if (!q.exec()) {
+        if (errorMessage)
+            *errorMessage = sqlError(QStringLiteral("Cannot write speakers of %1").arg(id), q.lastError());
+        return false;
+    }
+
+    q.prepare(QStringLiteral("INSERT INTO speakers (transcript_id, handle, speaker_id, display_name, color) "
+                             "VALUES (?, ?, ?, ?, ?)"));
+    for (int handle = 0; handle < speakers.size(); ++handle) {
+        const Speaker& sp = speakers.at(handle);
+        q.addBindValue(id);
+        q.addBindValue(handle);
+        q.addBindValue(sp.id);
+        q.addBindValue(sp.displayName);
+        q.addBindValue(sp.color.isValid() ? sp.color.name(QColor::HexArgb) : QString());
+
+        if (!q.exec()) {
+            if (errorMessage)
+                *errorMessage = sqlError(QStringLiteral("Cannot write speakers of %1").arg(id), q.lastError());
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool TranscriptDatabase::writeSegments(const QString& id, int firstPosition,
+                                       const QVector<qint32>& speakers, const QVector<QString>& texts,
+                                       QString* errorMessage) {
+
+    // One prepared statement for the whole run, executed once per row
+    QSqlQuery q(QSqlDatabase::database(connectionName, false));
+    q.prepare(QStringLiteral("INSERT INTO segments (transcript_id, position, speaker_handle, text) "
+                             "VALUES (?, ?, ?, ?)"));
+
+    for (int k = 0; k < texts.size(); ++k) {
+        q.addBindValue(id);
+        q.addBindValue(firstPosition + k);
+        q.addBindValue(speakers.value(k, -1));
+        q.addBindValue(texts.at(k));
+
+        if (!q.exec()) {
+            if (errorMessage)
+                *errorMessage = sqlError(QStringLiteral("Cannot write segments of %1").arg(id), q.lastError());
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool TranscriptDatabase::applyChange(const PendingChange& change, QString* errorMessage) {
+
+    QSqlQuery q(QSqlDatabase::database(connectionName, false));
+
+    if (change.first < 0) {
+        q.prepare(QStringLiteral("DELETE FROM segments WHERE transcript_id = ?"));
+        q.addBindValue(change.transcriptID);
+    }
+    else {
+        q.prepare(QStringLiteral("DELETE FROM segments WHERE transcript_id = ? "
+                                 "AND position >= ? AND position < ?"));
+        q.addBindValue(change.transcriptID);
+        q.addBindValue(change.first);
+        q.addBindValue(change.first + change.removedCount);
+    }
+
+    if (!q.exec()) {
+        if (errorMessage)
+            *errorMessage = sqlError(QStringLiteral("Cannot update segments of %1").arg(change.transcriptID),
+                                     q.lastError());
+        return false;
+    }
+
+    // Move the segments after the range to their new positions
+    const int delta = change.segments.size() - change.removedCount;
+    if (change.first >= 0 && delta != 0) {
+        q.prepare(QStringLiteral("UPDATE segments SET position = position + ? "
+                                 "WHERE transcript_id = ? AND position >= ?"));
+        q.addBindValue(delta);
+        q.addBindValue(change.transcriptID);
+        q.addBindValue(change.first + change.removedCount);
+
+        if (!q.exec()) {
+            if (errorMessage)
+                *errorMessage = sqlError(QStringLiteral("Cannot update segments of %1").arg(change.transcriptID),
+                                         q.lastError());
+            return false;
+        }
+    }
+
+    QVector<qint32> speakers;
+    QVector<QString> texts;
+    speakers.reserve(change.segments.size());
+    texts.reserve(change.segments.size());
+    for (const Segment& seg : change.segments) {
+        speakers.push_back(seg.speaker);
+        texts.push_back(seg.text());
+    }
+
+    return writeSegments(change.transcriptID, qMax(change.first, 0), speakers, texts, errorMessage);
+}
+
+}
+}
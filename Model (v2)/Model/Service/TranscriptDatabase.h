@@ -0,0 +1,182 @@
+#ifndef MODEL_SERVICE_TRANSCRIPT_DATABASE_H
+#define MODEL_SERVICE_TRANSCRIPT_DATABASE_H
+
+#include "Model/Data/Transcript.h"
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+namespace Model {
+namespace Service {
+
+/**
+ * @brief SQLite store for a corpus of transcripts (Qt's QSQLITE driver).
+ *
+ * Tables:
+ *  - transcripts: one row per transcript (id, title, paths, dates).
+ *  - speakers:    (transcript, handle) -> speaker ID, display name, color.
+ *  - segments:    (transcript, position) -> speaker handle, text.
+ *  - segments_fts: FTS5 index over segment texts, kept in sync with
+ *    segments by triggers.
+ *
+ * The database runs in WAL mode, so searches can read while a batch is
+ * written. Edits are not written one by one: recordChange() queues the
+ * TranscriptEditor::SegmentChange of each edit with the affected segments,
+ * and flush() applies everything queued in a single transaction.
+ *
+ * If the SQLite build has no FTS5, the store still works and search()
+ * falls back to LIKE scans.
+ *
+ * Not thread-safe: use an instance from one thread only.
+ */
+
+class TranscriptDatabase {
+
+public:
+
+    /** @brief One search hit. */
+    struct SegmentHit {
+        QString transcriptID;
+        int position = -1;      // Segment index within the transcript
+        QString speakerID;
+        QString text;
+    };
+
+    /** @brief Constructs a closed database. */
+    TranscriptDatabase();
+
+    /** @brief Closes the database (pending changes are dropped; flush() first). */
+    ~TranscriptDatabase();
+
+    TranscriptDatabase(const TranscriptDatabase&) = delete;
+    TranscriptDatabase& operator=(const TranscriptDatabase&) = delete;
+
+    /** @brief Opens (creating if needed) the database file at path and sets up the schema. */
+    bool open(const QString& path, QString* errorMessage = nullptr);
+
+    /** @brief Closes the database, dropping changes not yet flushed. */
+    void close();
+
+    /** @brief Returns true if a database is open. */
+    bool isOpen() const;
+
+    /** @brief Returns true if full-text search uses FTS5. */
+    bool hasFullTextIndex() const;
+
+
+    // === Whole transcripts ===
+
+    /** @brief Returns the IDs of all stored transcripts. */
+    QStringList transcriptIDs(QString* errorMessage = nullptr) const;
+
+    /** @brief Returns true if a transcript with id is stored. */
+    bool contains(const QString& id) const;
+
+    /** @brief Stores transcript, replacing any stored version, in one transaction. */
+    bool storeTranscript(const Model::Data::Transcript& transcript, QString* errorMessage = nullptr);
+
+    /** @brief Loads the transcript with id into outTranscript. */
+    bool loadTranscript(const QString& id,
+                        Model::Data::Transcript& outTranscript,
+                        QString* errorMessage = nullptr) const;
+
+    /** @brief Removes a transcript and everything belonging to it. */
+    bool removeTranscript(const QString& id, QString* errorMessage = nullptr);
+
+
+    // === Batched edits ===
+
+    /**
+     * @brief Queues an edit for the next flush().
+     *
+     * Segments [first, first + removedCount) were replaced by
+     * [first, first + insertedCount) in the current state of transcript.
+     * first == -1 replaces every segment. The speaker table and lastEdited
+     * are written as they are at the time of the flush.
+     *
+     * O(number of segments in the range): texts are not read until flush(),
+     * and repeated edits of the same segments replace the queued copies.
+     */
+    void recordChange(const Model::Data::Transcript& transcript,
+                      int first,
+                      int removedCount,
+                      int insertedCount);
+
+    /** @brief Queues the speaker table and lastEdited of transcript for the next flush(). */
+    void recordHeader(const Model::Data::Transcript& transcript);
+
+    /** @brief Drops every recorded change without writing it. */
+    void discardPendingChanges();
+
+    /** @brief Returns true if recorded changes wait for flush(). */
+    bool hasPendingChanges() const;
+
+    /** @brief Returns true if changes of transcript id wait for flush(). */
+    bool hasPendingChanges(const QString& id) const;
+
+    /**
+     * @brief Writes every recorded change in one transaction.
+     *
+     * On failure, the transaction is rolled back and the changes stay queued.
+     */
+    bool flush(QString* errorMessage = nullptr);
+
+
+    // === Search ===
+
+    /**
+     * @brief Finds segments containing text (as a phrase), optionally only by speakerID.
+     *
+     * Searches every stored transcript; pending changes are flushed first.
+     * Hits are ordered by transcript and position; at most limit are returned.
+     */
+    bool search(const QString& text,
+                const QString& speakerID,
+                QVector<SegmentHit>& outHits,
+                int limit = 1000,
+                QString* errorMessage = nullptr);
+
+private:
+
+    /** @brief One queued edit: a range replacement, or all segments if first < 0. */
+    struct PendingChange {
+        QString transcriptID;
+        int first = -1;
+        int removedCount = 0;
+        // The inserted segments. Copies share the text (and a piece table's
+        // pieces); it is only flattened by flush()
+        QVector<Model::Data::Segment> segments;
+    };
+
+    /** @brief Transcript row and speaker table at the time of the last recordChange(). */
+    struct PendingHeader {
+        QVector<Model::Data::Speaker> speakers;
+        QDateTime lastEdited;
+    };
+
+    /** @brief Runs sql; reports the driver error through errorMessage. */
+    bool exec(const QString& sql, QString* errorMessage) const;
+
+    /** @brief Creates the tables, indexes and FTS triggers if missing. */
+    bool createSchema(QString* errorMessage);
+
+    bool writeTranscriptRow(const Model::Data::Transcript& transcript, QString* errorMessage);
+    bool writeSpeakers(const QString& id, const QVector<Model::Data::Speaker>& speakers, QString* errorMessage);
+    bool writeSegments(const QString& id, int firstPosition,
+                       const QVector<qint32>& speakers, const QVector<QString>& texts,
+                       QString* errorMessage);
+    bool applyChange(const PendingChange& change, QString* errorMessage);
+
+    QString connectionName;
+    bool fts = false;
+
+    QVector<PendingChange> pending;
+    QHash<QString, PendingHeader> pendingHeaders;
+};
+
+}
+}
+
+#endif // MODEL_SERVICE_TRANSCRIPT_DATABASE_H
@@ -8,15 +8,100 @@ namespace Service {
 
 using namespace Model::Data;
 
+namespace {
+
+using Operation = TranscriptEditor::Operation;
+
+Operation makeOperation(Operation::Kind kind, quint64 segmentID) {
+
+    Operation op;
+    op.kind = kind;
+    op.segmentID = segmentID;
+    return op;
+}
+
+Operation spliceOperation(quint64 segmentID, int position, int length, const QString& text) {
+
+    Operation op = makeOperation(Operation::Kind::Splice, segmentID);
+    op.position = position;
+    op.length = length;
+    op.text = text;
+    return op;
+}
+
+Operation splitOperation(quint64 segmentID, int position, quint64 newID, const QString& speakerID) {
+
+    Operation op = makeOperation(Operation::Kind::Split, segmentID);
+    op.position = position;
+    op.otherID = newID;
+    op.speakerID = speakerID;
+    return op;
+}
+
+Operation joinOperation(quint64 segmentID, quint64 nextID) {
+
+    Operation op = makeOperation(Operation::Kind::Join, segmentID);
+    op.otherID = nextID;
+    return op;
+}
+
+Operation insertOperation(int index, quint64 segmentID, const QString& speakerID, const QString& text) {
+
+    Operation op = makeOperation(Operation::Kind::Insert, segmentID);
+    op.position = index;
+    op.speakerID = speakerID;
+    op.text = text;
+    return op;
+}
+
+Operation moveOperation(quint64 segmentID, int index) {
+
+    Operation op = makeOperation(Operation::Kind::Move, segmentID);
+    op.position = index;
+    return op;
+}
+
+Operation speakerOperation(quint64 segmentID, const QString& speakerID) {
+
+    Operation op = makeOperation(Operation::Kind::SetSpeaker, segmentID);
+    op.speakerID = speakerID;
+    return op;
+}
+
+Operation renameOperation(const QString& oldID, const QString& newID) {
+
+    Operation op = makeOperation(Operation::Kind::RenameSpeaker, 0);
+    op.oldSpeakerID = oldID;
+    op.speakerID = newID;
+    return op;
+}
+
+Operation resetOperation(const TranscriptVersion& state) {
+
+    Operation op = makeOperation(Operation::Kind::Reset, 0);
+    op.state = state;
+    return op;
+}
+
+}
+
 // === Construction / access ===
 
 TranscriptEditor::TranscriptEditor(Transcript& transcript)
-    : editedTranscript(transcript)
-{}
+    : editedTranscript(&transcript)
+{
+    editedTranscript->ensureSegmentIDs();
+    idMap.build(editedTranscript->segments);
+}
 
-const Transcript& TranscriptEditor::transcript() const { return editedTranscript; }
+const Transcript& TranscriptEditor::transcript() const { return *editedTranscript; }
 
-Transcript& TranscriptEditor::transcript() { return editedTranscript; }
+Transcript& TranscriptEditor::transcript() { return *editedTranscript; }
+
+void TranscriptEditor::rebind(Transcript& transcript) {
+
+    editedTranscript = &transcript;
+}
 
 
 // === Segment-level editing ===
@@ -27,7 +112,38 @@ bool TranscriptEditor::setSegmentText(int index, const QString& newText) {
         return false;
 
     saveSnapshot();
-    editedTranscript.segments[index].text = newText;
+    Segment& seg = editedTranscript->segments[index];
+    const QString oldText = seg.text();
+    seg.setText(newText);
+    recordTextChange(seg.id, oldText, newText);
+    recordChange(index, 1, 1);
+    markEdited();
+    return true;
+}
+
+bool TranscriptEditor::spliceSegmentText(int index,
+                                         int position,
+                                         int charsRemoved,
+                                         const QString& insertedText) {
+
+    if (!isValidSegmentIndex(index))
+        return false;
+
+    const int length = editedTranscript->segments[index].textLength();
+    if (position < 0 || charsRemoved < 0 || position + charsRemoved > length)
+        return false;
+    if (charsRemoved == 0 && insertedText.isEmpty())
+        return false;
+
+    saveSnapshot();
+    // Take the reference after the snapshot so the write detaches from it
+    Segment& seg = editedTranscript->segments[index];
+    const QString removedText = seg.textMid(position, charsRemoved);
+    seg.removeText(position, charsRemoved);
+    seg.insertText(position, insertedText);
+    record(spliceOperation(seg.id, position, charsRemoved, insertedText),
+           spliceOperation(seg.id, position, insertedText.size(), removedText));
+    recordChange(index, 1, 1);
     markEdited();
     return true;
 }
@@ -38,7 +154,14 @@ bool TranscriptEditor::appendToSegment(int index, const QString& extraText) {
         return false;
 
     saveSnapshot();
-    editedTranscript.segments[index].appendText(extraText);
+    Segment& seg = editedTranscript->segments[index];
+    const int oldLength = seg.textLength();
+    seg.appendText(extraText);
+    // Read back what was appended: appendText() may add a separator
+    const QString appended = seg.textMid(oldLength, seg.textLength() - oldLength);
+    record(spliceOperation(seg.id, oldLength, 0, appended),
+           spliceOperation(seg.id, oldLength, appended.size(), QString()));
+    recordChange(index, 1, 1);
     markEdited();
     return true;
 }
@@ -48,29 +171,38 @@ int TranscriptEditor::splitSegment(int index, int splitPosition) {
     if (!isValidSegmentIndex(index))
         return -1;
 
-    Segment& seg = editedTranscript.segments[index];
-    const QString& text = seg.text;
-
-    if (splitPosition <= 0 ||splitPosition >= text.size())
+    if (splitPosition <= 0 || splitPosition >= editedTranscript->segments[index].textLength())
         return -1;
 
     saveSnapshot();
 
-    const QString firstPart = text.left(splitPosition).trimmed();
-    const QString secondPart = text.mid(splitPosition).trimmed();
+    // Split a copy; long texts share their pieces instead of copying halves
+    Segment firstPart = editedTranscript->segments[index];
+    Segment secondPart = firstPart.splitOff(splitPosition);
+    const Segment untrimmedFirst = firstPart;
+    const Segment untrimmedSecond = secondPart;
+    firstPart.trim();
+    secondPart.trim();
 
-    if (firstPart.isEmpty() || secondPart.isEmpty()) {
+    if (firstPart.textLength() == 0 || secondPart.textLength() == 0) {
         // We require both parts to be non-empty for a split.
         // If needed, this behavior can be relaxed later.
-        // Revert snapshot to avoid half-changes.
-        // (But since we haven't modified anything yet, nothing to revert.)
+        // Nothing was modified yet; only the snapshot has to go.
+        dropSnapshot();
         return -1;
     }
 
-    seg.text = firstPart;
-    Segment newSeg(seg.speakerID, secondPart);
+    editedTranscript->assignSegmentID(secondPart);
 
-    editedTranscript.segments.insert(index + 1, newSeg);
+    record(splitOperation(firstPart.id, splitPosition, secondPart.id,
+                          editedTranscript->speakerIDOf(secondPart)),
+           joinOperation(firstPart.id, secondPart.id));
+    recordTrim(secondPart.id, untrimmedSecond);
+    recordTrim(firstPart.id, untrimmedFirst);
+
+    editedTranscript->segments[index] = firstPart;
+    editedTranscript->segments.insert(index + 1, secondPart);
+    recordChange(index, 1, 2);
     markEdited();
     return index + 1;
 
@@ -84,39 +216,39 @@ int TranscriptEditor::splitSegmentWithSpeakers(int index,
     if (!isValidSegmentIndex(index))
         return -1;
 
-    Segment& seg = editedTranscript.segments[index];
-    const QString originalText = seg.text;
-
     // Same positional checks as splitSegment
-    if (splitPosition <= 0 || splitPosition >= originalText.size())
+    if (splitPosition <= 0 || splitPosition >= editedTranscript->segments[index].textLength())
         return -1;
 
     // Take a single snapshot for the whole composite operation.
     saveSnapshot();
 
-    const QString firstText = originalText.left(splitPosition);
-    const QString secondText = originalText.mid(splitPosition);
-
-    // Decide speakers
-    const QString firstSpeaker  = speakerFirst.trimmed().isEmpty()
-                                     ? seg.speakerID
-                                     : speakerFirst.trimmed();
-    const QString secondSpeaker = speakerSecond.trimmed().isEmpty()
-                                      ? seg.speakerID
-                                      : speakerSecond.trimmed();
-
-    // Ensure speakers exist
-    ensureSpeakerExists(firstSpeaker);
-    ensureSpeakerExists(secondSpeaker);
-
-    // Update original segment as "first"
-    seg.speakerID = firstSpeaker;
-    seg.text = firstText;
-
-    // Insert new "second" segment after it
-    Segment newSeg(secondSpeaker, secondText);
-    editedTranscript.segments.insert(index + 1, newSeg);
-
+    Segment& seg = editedTranscript->segments[index];
+    Segment newSeg = seg.splitOff(splitPosition);
+    editedTranscript->assignSegmentID(newSeg);
+
+    // Decide speakers (interning adds them if missing)
+    const int oldSpeaker = seg.speaker;
+    const int firstSpeaker  = speakerFirst.trimmed().isEmpty()
+                                 ? seg.speaker
+                                 : editedTranscript->internSpeaker(speakerFirst.trimmed());
+    const int secondSpeaker = speakerSecond.trimmed().isEmpty()
+                                  ? seg.speaker
+                                  : editedTranscript->internSpeaker(speakerSecond.trimmed());
+
+    // Original segment keeps the first part, new "second" segment goes after it
+    seg.speaker = firstSpeaker;
+    newSeg.speaker = secondSpeaker;
+    editedTranscript->segments.insert(index + 1, newSeg);
+
+    // Speaker first, so replay interns new speakers in the same order
+    if (firstSpeaker != oldSpeaker)
+        record(speakerOperation(seg.id, editedTranscript->speakerIDOf(firstSpeaker)),
+               speakerOperation(seg.id, editedTranscript->speakerIDOf(oldSpeaker)));
+    record(splitOperation(seg.id, splitPosition, newSeg.id, editedTranscript->speakerIDOf(secondSpeaker)),
+           joinOperation(seg.id, newSeg.id));
+
+    recordChange(index, 1, 2);
     markEdited();
     return index + 1;
 }
@@ -132,20 +264,25 @@ bool TranscriptEditor::mergeWithNext(int index) {
 
     saveSnapshot();
 
-    Segment& current = editedTranscript.segments[index];
-    const Segment& next = editedTranscript.segments[nextIndex];
+    Segment& current = editedTranscript->segments[index];
+    const Segment& next = editedTranscript->segments[nextIndex];
+    const int oldLength = current.textLength();
 
     // Append text with a newline separator if needed
-    QString mergedText = current.text;
-    if (!mergedText.isEmpty() && !mergedText.endsWith("\n"))
-        mergedText.append('\n');
-    mergedText.append(next.text);
-
-    current.text = mergedText;
+    current.appendSegmentText(next);
     // Speaker remains the same as the original current segment;
     // if needed, this behavior can be customized later.
 
-    editedTranscript.segments.removeAt(nextIndex);
+    // A Join concatenates exactly, so the separator is a splice of its own
+    const int joinPosition = current.textLength() - next.textLength();
+    if (joinPosition > oldLength)
+        record(spliceOperation(current.id, oldLength, 0, current.textMid(oldLength, joinPosition - oldLength)),
+               spliceOperation(current.id, oldLength, joinPosition - oldLength, QString()));
+    record(joinOperation(current.id, next.id),
+           splitOperation(current.id, joinPosition, next.id, editedTranscript->speakerIDOf(next)));
+
+    editedTranscript->segments.removeAt(nextIndex);
+    recordChange(index, 2, 1);
     markEdited();
     return true;
 }
@@ -156,19 +293,49 @@ bool TranscriptEditor::deleteSegment(int index) {
         return false;
 
     saveSnapshot();
-    editedTranscript.segments.removeAt(index);
+    const Segment& seg = editedTranscript->segments.at(index);
+    record(makeOperation(Operation::Kind::Remove, seg.id),
+           insertOperation(index, seg.id, editedTranscript->speakerIDOf(seg), seg.text()));
+    editedTranscript->segments.removeAt(index);
+    recordChange(index, 1, 0);
     markEdited();
     return true;
 }
 
 bool TranscriptEditor::insertSegment(int index, const Segment& segment) {
 
-    if (index < 0 || index > editedTranscript.segments.size())
+    if (index < 0 || index > editedTranscript->segments.size())
+        return false;
+    if (segment.speaker >= editedTranscript->speakers.size())
+        return false;
+
+    saveSnapshot();
+    // Always a new ID: segment may be a copy of one already in the transcript
+    Segment inserted = segment;
+    editedTranscript->assignSegmentID(inserted);
+    editedTranscript->segments.insert(index, inserted);
+    record(insertOperation(index, inserted.id, editedTranscript->speakerIDOf(inserted), inserted.text()),
+           makeOperation(Operation::Kind::Remove, inserted.id));
+    recordChange(index, 0, 1);
+    markEdited();
+    return true;
+}
+
+bool TranscriptEditor::insertSegment(int index, const QString& speakerID, const QString& text) {
+
+    if (index < 0 || index > editedTranscript->segments.size())
         return false;
 
     saveSnapshot();
-    editedTranscript.segments.insert(index, segment);
-    ensureSpeakerExists(segment.speakerID);
+    const int speaker = speakerID.trimmed().isEmpty()
+                            ? -1
+                            : editedTranscript->internSpeaker(speakerID.trimmed());
+    Segment inserted(speaker, text);
+    editedTranscript->assignSegmentID(inserted);
+    editedTranscript->segments.insert(index, inserted);
+    record(insertOperation(index, inserted.id, editedTranscript->speakerIDOf(inserted), text),
+           makeOperation(Operation::Kind::Remove, inserted.id));
+    recordChange(index, 0, 1);
     markEdited();
     return true;
 }
@@ -177,19 +344,25 @@ bool TranscriptEditor::moveSegment(int fromIndex, int toIndex) {
 
     if (!isValidSegmentIndex(fromIndex))
         return false;
-    if (toIndex < 0 || toIndex >= editedTranscript.segments.size())
+    if (toIndex < 0 || toIndex >= editedTranscript->segments.size())
         return false;
     if (fromIndex == toIndex)
         return true;
 
     saveSnapshot();
 
-    Segment seg = editedTranscript.segments.takeAt(fromIndex);
+    Segment seg = editedTranscript->segments.takeAt(fromIndex);
     // If we removed an element before the target index, the target shifts by -1
     if (fromIndex < toIndex)
         --toIndex;
 
-    editedTranscript.segments.insert(toIndex, seg);
+    editedTranscript->segments.insert(toIndex, seg);
+    record(moveOperation(seg.id, toIndex), moveOperation(seg.id, fromIndex));
+
+    // Everything between the old and new position shifts by one
+    const int first = qMin(fromIndex, toIndex);
+    const int span = qMax(fromIndex, toIndex) - first + 1;
+    recordChange(first, span, span);
     markEdited();
     return true;
 }
@@ -202,7 +375,19 @@ bool TranscriptEditor::swapSegments(int indexA, int indexB) {
         return true;
 
     saveSnapshot();
-    editedTranscript.segments.swapItemsAt(indexA, indexB);
+
+    // As two moves: the later segment to the front, then the earlier one to the back
+    const int first = qMin(indexA, indexB);
+    const int last = qMax(indexA, indexB);
+    const quint64 firstID = editedTranscript->segments.at(first).id;
+    const quint64 lastID = editedTranscript->segments.at(last).id;
+    record(moveOperation(lastID, first), moveOperation(lastID, last));
+    record(moveOperation(firstID, last), moveOperation(firstID, first + 1));
+
+    editedTranscript->segments.swapItemsAt(indexA, indexB);
+
+    const int span = last - first + 1;
+    recordChange(first, span, span);
     markEdited();
     return true;
 }
@@ -215,7 +400,10 @@ bool TranscriptEditor::removeSegment(int index) {
 void TranscriptEditor::setSegments(const QVector<Segment>& newSegments) {
 
     saveSnapshot();
-    editedTranscript.segments = newSegments;
+    editedTranscript->segments = SegmentList(newSegments);
+    editedTranscript->ensureSegmentIDs();
+    record(resetOperation(TranscriptVersion(*editedTranscript)), resetOperation(undoStack.last()));
+    recordFullChange();
     markEdited();
 }
 
@@ -229,8 +417,11 @@ bool TranscriptEditor::setSegmentSpeaker(int index, const QString& speakerID) {
         return false;
 
     saveSnapshot();
-    editedTranscript.segments[index].speakerID = speakerID.trimmed();
-    ensureSpeakerExists(speakerID.trimmed());
+    Segment& seg = editedTranscript->segments[index];
+    const QString oldSpeakerID = editedTranscript->speakerIDOf(seg);
+    seg.speaker = editedTranscript->internSpeaker(speakerID.trimmed());
+    record(speakerOperation(seg.id, speakerID.trimmed()), speakerOperation(seg.id, oldSpeakerID));
+    recordChange(index, 1, 1);
     markEdited();
     return true;
 }
@@ -248,7 +439,24 @@ bool TranscriptEditor::renameSpeakerGlobal(const QString& oldID, const QString&
         return false;
 
     saveSnapshot();
-    editedTranscript.renameSpeaker(trimmedOld, trimmedNew);
+
+    // Renaming onto an existing speaker merges the two: undo then has to
+    // give the old speaker back to each of its segments
+    QVector<Operation> inverse;
+    if (hasSpeaker(trimmedNew)) {
+        const int oldSpeaker = editedTranscript->findSpeakerIndex(trimmedOld);
+        for (const Segment& seg : editedTranscript->segments) {
+            if (seg.speaker == oldSpeaker)
+                inverse.push_back(speakerOperation(seg.id, trimmedOld));
+        }
+    }
+    else {
+        inverse.push_back(renameOperation(trimmedNew, trimmedOld));
+    }
+
+    editedTranscript->renameSpeaker(trimmedOld, trimmedNew);
+    record(renameOperation(trimmedOld, trimmedNew), inverse);
+    recordFullChange();
     markEdited();
     return true;
 }
@@ -256,12 +464,17 @@ bool TranscriptEditor::renameSpeakerGlobal(const QString& oldID, const QString&
 
 bool TranscriptEditor::hasSpeaker(const QString& speakerID) const {
 
-    return editedTranscript.findSpeakerIndex(speakerID) >= 0;
+    return editedTranscript->findSpeakerIndex(speakerID) >= 0;
 }
 
 void TranscriptEditor::ensureSpeakerExists(const QString& speakerID) {
 
-    editedTranscript.addSpeakerIfMissing(speakerID);
+    if (hasSpeaker(speakerID))
+        return;
+
+    editedTranscript->addSpeakerIfMissing(speakerID);
+    editedTranscript->markModified();
+    ++versionCounter;
 }
 
 
@@ -279,11 +492,18 @@ int TranscriptEditor::replaceInSegment(
         return 0;
 
     saveSnapshot();
-    int count = replaceAllInString(editedTranscript.segments[index].text, from, to, cs);
-    if (count > 0)
+    Segment& seg = editedTranscript->segments[index];
+    QString text = seg.text();
+    QVector<QPair<int, QString>> matches;
+    int count = replaceAllInString(text, from, to, cs, &matches);
+    if (count > 0) {
+        seg.setText(text);
+        recordReplacements(seg.id, to, matches);
+        recordChange(index, 1, 1);
         markEdited();
+    }
     else
-        undoStack.removeLast(); // No effective change -> discard snapshot
+        dropSnapshot(); // No effective change -> discard snapshot
 
     return count;
 }
@@ -299,16 +519,24 @@ int TranscriptEditor::replaceAll(
     saveSnapshot();
     int total = 0;
 
-    for (Segment& seg : editedTranscript.segments) {
-        total += replaceAllInString(seg.text, from, to, cs);
+    for (Segment& seg : editedTranscript->segments) {
+        QString text = seg.text();
+        QVector<QPair<int, QString>> matches;
+        const int count = replaceAllInString(text, from, to, cs, &matches);
+        if (count > 0) {
+            seg.setText(text);
+            recordReplacements(seg.id, to, matches);
+            total += count;
+        }
     }
 
     if (total > 0) {
+        recordFullChange();
         markEdited();
     }
     else {
         // Nothing changed: discard the snapshot we just saved
-        undoStack.removeLast();
+        dropSnapshot();
     }
 
     return total;
@@ -316,14 +544,14 @@ int TranscriptEditor::replaceAll(
 
 void TranscriptEditor::normalizeWhitespaceAll() {
 
-    if (editedTranscript.segments.isEmpty())
+    if (editedTranscript->segments.isEmpty())
         return;
 
     saveSnapshot();
 
     // Simple normalization: trim each segment's text and remove excessive blank lines.
-    for (Segment& seg : editedTranscript.segments) {
-        QString t = seg.text;
+    for (Segment& seg : editedTranscript->segments) {
+        const QString t = seg.text();
 
         // Trim each line
         QStringList lines = t.split(QRegularExpression(QStringLiteral("\\r?\\n")),
@@ -350,9 +578,15 @@ void TranscriptEditor::normalizeWhitespaceAll() {
             }
         }
 
-        seg.text = cleaned.join('\n').trimmed();
+        const QString normalized = cleaned.join('\n').trimmed();
+        if (normalized == t)
+            continue;
+
+        seg.setText(normalized);
+        recordTextChange(seg.id, t, normalized);
     }
 
+    recordFullChange();
     markEdited();
 }
 
@@ -363,6 +597,8 @@ void TranscriptEditor::clearHistory() {
 
     undoStack.clear();
     redoStack.clear();
+    undoSteps.clear();
+    redoSteps.clear();
 }
 
 bool TranscriptEditor::canUndo() const {
@@ -385,14 +621,16 @@ bool TranscriptEditor::undo() {
     debugDumpSegment(0, "before undo");
 #endif
 
-    Snapshot snapshot = undoStack.takeLast();
+    const TranscriptVersion snapshot = undoStack.takeLast();
+    const Step step = undoSteps.takeLast();
     // Save current state to redo before restoring previous
-    Snapshot current;
-    current.speakers = editedTranscript.speakers;
-    current.segments = editedTranscript.segments;
-    redoStack.append(current);
+    redoStack.append(currentVersion());
+    redoSteps.append(step);
 
     restoreSnapshot(snapshot);
+    for (auto it = step.inverse.crbegin(); it != step.inverse.crend(); ++it)
+        pendingChange.operations.push_back(*it);
+    recordFullChange();
     markEdited();
 
 #ifdef QT_DEBUG
@@ -413,14 +651,15 @@ bool TranscriptEditor::redo() {
     debugDumpSegment(0, "before redo");
 #endif
 
-    Snapshot snapshot = redoStack.takeLast();
+    const TranscriptVersion snapshot = redoStack.takeLast();
+    const Step step = redoSteps.takeLast();
     // Save current state to undo before restoring next
-    Snapshot current;
-    current.speakers = editedTranscript.speakers;
-    current.segments = editedTranscript.segments;
-    undoStack.append(current);
+    undoStack.append(currentVersion());
+    undoSteps.append(step);
 
     restoreSnapshot(snapshot);
+    pendingChange.operations += step.forward;
+    recordFullChange();
     markEdited();
 
 #ifdef QT_DEBUG
@@ -432,43 +671,189 @@ bool TranscriptEditor::redo() {
 }
 
 
+// === Change tracking ===
+
+TranscriptEditor::SegmentChange TranscriptEditor::takeLastChange() {
+
+    const SegmentChange change = pendingChange;
+    pendingChange = SegmentChange();
+    return change;
+}
+
+
+// === Versions ===
+
+quint64 TranscriptEditor::versionNumber() const {
+
+    return versionCounter;
+}
+
+TranscriptVersion TranscriptEditor::currentVersion() const {
+
+    if (cachedVersion.isNull() || cachedVersion.number() != versionCounter)
+        cachedVersion = TranscriptVersion(*editedTranscript, versionCounter);
+
+    return cachedVersion;
+}
+
+
+// === Stable segment IDs ===
+
+quint64 TranscriptEditor::segmentIDAt(int index) const {
+
+    if (!isValidSegmentIndex(index))
+        return 0;
+
+    return editedTranscript->segments.at(index).id;
+}
+
+int TranscriptEditor::indexOfSegment(quint64 segmentID) const {
+
+    if (segmentID == 0)
+        return -1;
+
+    const auto& segments = editedTranscript->segments;
+
+    int position = idMap.positionOf(segmentID);
+    if (position >= 0 && position < segments.size() && segments.at(position).id == segmentID)
+        return position;
+
+    // The map only misses edits made to the transcript outside this editor;
+    // resync once in that case.
+    if (position >= 0 || idMap.size() != segments.size()) {
+        idMap.build(segments);
+        position = idMap.positionOf(segmentID);
+    }
+
+    return position;
+}
+
+
 // === Private helpers ===
 
 void TranscriptEditor::saveSnapshot() {
 
-    Snapshot snap;
-    snap.speakers = editedTranscript.speakers;
-    snap.segments = editedTranscript.segments;
-    undoStack.append(snap);
+    undoStack.append(currentVersion());
+    undoSteps.append(Step());
     // new edit invalidates redo history
     redoStack.clear();
+    redoSteps.clear();
 
 #ifdef QT_DEBUG
     debugLogStacks("saveSnapshot");
 #endif
 }
 
-void TranscriptEditor::restoreSnapshot(const Snapshot& snapshot) {
+void TranscriptEditor::dropSnapshot() {
 
-    editedTranscript.speakers = snapshot.speakers;
-    editedTranscript.segments = snapshot.segments;
+    undoStack.removeLast();
+    undoSteps.removeLast();
+}
+
+void TranscriptEditor::record(const Operation& forward, const QVector<Operation>& inverse) {
+
+    pendingChange.operations.push_back(forward);
+
+    Step& step = undoSteps.last();
+    step.forward.push_back(forward);
+    for (auto it = inverse.crbegin(); it != inverse.crend(); ++it)
+        step.inverse.push_back(*it);
+}
+
+void TranscriptEditor::record(const Operation& forward, const Operation& inverse) {
+
+    record(forward, QVector<Operation>{inverse});
+}
+
+void TranscriptEditor::recordTextChange(quint64 segmentID, const QString& oldText, const QString& newText) {
+
+    // One splice covering everything between the common prefix and suffix
+    const int maxCommon = qMin(oldText.size(), newText.size());
+
+    int prefix = 0;
+    while (prefix < maxCommon && oldText.at(prefix) == newText.at(prefix))
+        ++prefix;
+
+    int suffix = 0;
+    while (suffix < maxCommon - prefix
+           && oldText.at(oldText.size() - 1 - suffix) == newText.at(newText.size() - 1 - suffix))
+        ++suffix;
+
+    const int removed = oldText.size() - prefix - suffix;
+    const int inserted = newText.size() - prefix - suffix;
+    if (removed == 0 && inserted == 0)
+        return;
+
+    record(spliceOperation(segmentID, prefix, removed, newText.mid(prefix, inserted)),
+           spliceOperation(segmentID, prefix, inserted, oldText.mid(prefix, removed)));
+}
+
+void TranscriptEditor::recordTrim(quint64 segmentID, const Segment& untrimmed) {
+
+    const int length = untrimmed.textLength();
+    int begin = 0;
+    int end = length;
+    untrimmed.trimmedBounds(begin, end);
+
+    // Trailing whitespace first, so the leading range is still at 0
+    if (end < length)
+        record(spliceOperation(segmentID, end, length - end, QString()),
+               spliceOperation(segmentID, end, 0, untrimmed.textMid(end, length - end)));
+    if (begin > 0)
+        record(spliceOperation(segmentID, 0, begin, QString()),
+               spliceOperation(segmentID, 0, 0, untrimmed.textMid(0, begin)));
+}
+
+void TranscriptEditor::restoreSnapshot(const TranscriptVersion& snapshot) {
+
+    editedTranscript->setSpeakers(snapshot->speakers);
+    editedTranscript->segments = snapshot->segments;
 }
 
 void TranscriptEditor::markEdited() {
 
-    editedTranscript.lastEdited = QDateTime::currentDateTimeUtc();
+    editedTranscript->lastEdited = QDateTime::currentDateTimeUtc();
+    editedTranscript->markModified();
+    ++versionCounter;
+}
+
+void TranscriptEditor::recordChange(int first, int removedCount, int insertedCount) {
+
+    if (!idMap.segmentsReplaced(editedTranscript->segments, first, removedCount, insertedCount))
+        idMap.build(editedTranscript->segments);
+
+    // Two edits without a takeLastChange() in between cannot be described
+    // by a single range, so fall back to a full change.
+    if (!pendingChange.isNone()) {
+        recordFullChange();
+        return;
+    }
+
+    pendingChange.first = first;
+    pendingChange.removedCount = removedCount;
+    pendingChange.insertedCount = insertedCount;
+}
+
+void TranscriptEditor::recordFullChange() {
+
+    idMap.build(editedTranscript->segments);
+
+    pendingChange.first = -1;
+    pendingChange.removedCount = 0;
+    pendingChange.insertedCount = 0;
 }
 
 bool TranscriptEditor::isValidSegmentIndex(int index) const {
 
-    return (index >= 0 && index < editedTranscript.segments.size());
+    return (index >= 0 && index < editedTranscript->segments.size());
 }
 
 int TranscriptEditor::replaceAllInString(
     QString& text,
     const QString& from,
     const QString& to,
-    Qt::CaseSensitivity cs) {
+    Qt::CaseSensitivity cs,
+    QVector<QPair<int, QString>>* outMatches) {
 
     if (from.isEmpty())
         return 0;
@@ -477,6 +862,8 @@ int TranscriptEditor::replaceAllInString(
     int pos = 0;
 
     while ((pos = text.indexOf(from, pos, cs)) != -1) {
+        if (outMatches)
+            outMatches->push_back(qMakePair(pos, text.mid(pos, from.length())));
         text.replace(pos, from.length(), to);
         pos += to.length();
         ++count;
@@ -484,6 +871,15 @@ int TranscriptEditor::replaceAllInString(
     return count;
 }
 
+void TranscriptEditor::recordReplacements(quint64 segmentID,
+                                          const QString& to,
+                                          const QVector<QPair<int, QString>>& matches) {
+
+    for (const auto& match : matches)
+        record(spliceOperation(segmentID, match.first, match.second.size(), to),
+               spliceOperation(segmentID, match.first, to.size(), match.second));
+}
+
 #ifdef QT_DEBUG
 #include <QDebug>
 #endif
@@ -494,7 +890,7 @@ void TranscriptEditor::debugLogStacks(const char* context) const {
     qDebug() << "[TranscriptEditor]" << context
              << "undo:" << undoStack.size()
              << "redo:" << redoStack.size()
-             << "segments:" << editedTranscript.segments.size();
+             << "segments:" << editedTranscript->segments.size();
 
 }
 #endif
@@ -505,18 +901,18 @@ void TranscriptEditor::debugLogStacks(const char* context) const {
 
 #ifdef QT_DEBUG
 void TranscriptEditor::debugDumpSegment(int index, const char* context) const {
-    if (index < 0 || index >= editedTranscript.segments.size()) {
+    if (index < 0 || index >= editedTranscript->segments.size()) {
         qDebug() << "[TranscriptEditor]" << context
                  << "segment" << index << "is out of range.";
         return;
     }
 
-    const Segment& seg = editedTranscript.segments.at(index);
+    const Segment& seg = editedTranscript->segments.at(index);
     qDebug().noquote()
         << "[TranscriptEditor]" << context
         << "segment" << index
-        << "| speaker:" << seg.speakerID
-        << "| text:\n" << seg.text << "\n";
+        << "| speaker:" << editedTranscript->speakerIDOf(seg)
+        << "| text:\n" << seg.text() << "\n";
 }
 #endif
 
@@ -2,7 +2,10 @@
 #define MODEL_SERVICE_TRANSCRIPT_EDITOR_H
 
 #include "Model/Data/Transcript.h"
+#include "Model/Data/SegmentIdMap.h"
+#include "Model/Data/TranscriptVersion.h"
 
+#include <QPair>
 #include <QString>
 #include <QVector>
 
@@ -17,7 +20,8 @@ namespace Service {
  *  - Segment-level editing (insert, delete, move, merge, split, change text)
  *  - Speaker-level editing (change segment speaker, rename speaker globally)
  *  - Text operations (find/replace, normalize whitespace)
- *  - Basic undo/redo for editing actions (snapshot-based)
+ *  - Basic undo/redo for editing actions (snapshots are TranscriptVersions)
+ *  - Mapping stable segment IDs to current indices
  *
  * This class operates on an existing Transcript instance and does not perform
  * any file I/O. Persistence is handled by TranscriptManager / TranscriptExporter.
@@ -35,10 +39,27 @@ public:
     /** @brief Returns a mutable reference to the underlying transcript. */
     Model::Data::Transcript& transcript();
 
+    /**
+     * @brief Points the editor at transcript, keeping the undo/redo history.
+     *
+     * For when the edited transcript was moved to another address in the
+     * same state (e.g. by its owning container). Undo snapshots do not refer
+     * to the old object, so they stay valid.
+     */
+    void rebind(Model::Data::Transcript& transcript);
+
 
     /** @brief Changes the text of the segment at the given index. */
     bool setSegmentText(int index, const QString& newText);
 
+    /**
+     * @brief Replaces charsRemoved characters at position with insertedText.
+     *
+     * Incremental alternative to setSegmentText() for typing in long
+     * segments: piece-backed texts are edited without copying the rest.
+     */
+    bool spliceSegmentText(int index, int position, int charsRemoved, const QString& insertedText);
+
     /** @brief Appends extra text to the segment at the given index. */
     bool appendToSegment(int index, const QString& extraText);
 
@@ -75,9 +96,16 @@ public:
     /** @brief Deletes the segment at the given index. */
     bool deleteSegment(int index);
 
-    /** @brief Inserts a new segment at the given index. */
+    /**
+     * @brief Inserts a new segment at the given index.
+     *
+     * The segment's speaker handle must belong to this transcript (or be -1).
+     */
     bool insertSegment(int index, const Model::Data::Segment& segment);
 
+    /** @brief Inserts a new segment for speakerID, adding the speaker if missing. */
+    bool insertSegment(int index, const QString& speakerID, const QString& text);
+
     /**
      * @brief Moves a segment from one index to another.
      *
@@ -91,7 +119,13 @@ public:
     /** @brief Removes the segment at the given index (alias for deleteSegment). */
     bool removeSegment(int index);
 
-    /** @brief Replaces all segments with a new vector of segments. */
+    /**
+     * @brief Replaces all segments with a new vector of segments.
+     *
+     * Segments without an ID get one; existing IDs are kept.
+     *
+     * Speaker handles of newSegments must belong to this transcript.
+     */
     void setSegments(const QVector<Model::Data::Segment>& newSegments);
 
     // === Speaker-level editing ===
@@ -102,7 +136,7 @@ public:
     /**
      * @brief Renames a speaker globally across the transcript.
      *
-     * This updates both the speaker list and all segments using that speaker ID.
+     * Only the speaker entry changes; segments keep their speaker handle.
      */
     bool renameSpeakerGlobal(const QString& oldID, const QString& newID);
 
@@ -157,34 +191,173 @@ public:
     /** @brief Redoes the last undone operation, if possible. */
     bool redo();
 
+    // === Change tracking ===
+
+    /**
+     * @brief One primitive edit, addressing segments by their stable ID.
+     *
+     * Every editing function describes its effect as operations that, applied
+     * in order to the previous state, give the current one; undo and redo are
+     * described by the inverse and the original operations of the step. Their
+     * size is that of the edit, which is what the EditLog records.
+     */
+    struct Operation {
+
+        enum class Kind : quint8 {
+            Splice = 1,     // segmentID: replace length characters at position with text
+            Split,          // segmentID: text from position on becomes segment otherID (speakerID) after it
+            Join,           // segmentID: append the text of the next segment otherID and remove that one
+            Insert,         // new segment segmentID (speakerID, text) at index position
+            Remove,         // remove segment segmentID
+            Move,           // move segmentID to index position, counted after taking it out
+            SetSpeaker,     // segmentID gets speaker speakerID (empty for none)
+            RenameSpeaker,  // speaker oldSpeakerID becomes speakerID (see Transcript::renameSpeaker())
+            Reset           // speakers and segments are replaced by those of state
+        };
+
+        Kind kind = Kind::Splice;
+        quint64 segmentID = 0;
+        quint64 otherID = 0;
+        int position = 0;
+        int length = 0;
+        QString text;
+        QString speakerID;
+        QString oldSpeakerID;
+        Model::Data::TranscriptVersion state;
+    };
+
+    /**
+     * @brief Describes which segments the last successful edit touched.
+     *
+     * Segments [first, first + removedCount) of the previous state were replaced
+     * by segments [first, first + insertedCount) of the current state. A change
+     * with first == -1 means the whole transcript has to be treated as modified.
+     *
+     * operations turn the previous state into the current one (see Operation).
+     */
+    struct SegmentChange {
+        int first = 0;
+        int removedCount = 0;
+        int insertedCount = 0;
+        QVector<Operation> operations;
+
+        /** @brief Returns true if no segment was touched. */
+        bool isNone() const { return first >= 0 && removedCount == 0 && insertedCount == 0; }
+
+        /** @brief Returns true if every segment must be considered changed. */
+        bool isFullReset() const { return first < 0; }
+    };
+
+    /**
+     * @brief Returns the change recorded since the last call and clears it.
+     *
+     * Used by the Controller to invalidate only the affected parts of
+     * search caches and indexes after an edit.
+     */
+    SegmentChange takeLastChange();
+
+    // === Versions ===
+
+    /** @brief Returns a number that changes with every modification of the transcript. */
+    quint64 versionNumber() const;
+
+    /**
+     * @brief Returns the current state as an immutable TranscriptVersion.
+     *
+     * O(1), and the same version object is returned until the next edit.
+     * Safe to hand to other threads (searches, saves).
+     */
+    Model::Data::TranscriptVersion currentVersion() const;
+
+    // === Stable segment IDs ===
+
+    /** @brief Returns the ID of the segment at index, or 0 if index is invalid. */
+    quint64 segmentIDAt(int index) const;
+
+    /**
+     * @brief Returns the current index of the segment with the given ID.
+     *
+     * O(log n) through an order-statistics map kept up to date by every
+     * edit. Returns -1 if no segment has that ID (e.g. it was deleted).
+     */
+    int indexOfSegment(quint64 segmentID) const;
+
 
 private:
 
-    struct Snapshot {
-        QVector<Model::Data::Speaker> speakers;
-        QVector<Model::Data::Segment> segments;
+    /** @brief Operations of one undo step, in both directions. */
+    struct Step {
+        QVector<Operation> forward;
+        QVector<Operation> inverse;     // Reversed: the last one applies first
     };
 
-    QVector<Snapshot> undoStack;
-    QVector<Snapshot> redoStack;
+    // Undo/redo history: each entry shares all unchanged data with its neighbours
+    QVector<Model::Data::TranscriptVersion> undoStack;
+    QVector<Model::Data::TranscriptVersion> redoStack;
+
+    // Parallel to undoStack / redoStack
+    QVector<Step> undoSteps;
+    QVector<Step> redoSteps;
+
+    quint64 versionCounter = 1;
+    mutable Model::Data::TranscriptVersion cachedVersion;
+
+    SegmentChange pendingChange;
+
+    // Segment ID <-> index, updated in recordChange()/recordFullChange()
+    mutable Model::Data::SegmentIdMap idMap;
 
     /** @brief Saves the current speakers/segments to the undo stack. */
     void saveSnapshot();
 
-    /** @brief Restores the transcript from a given snapshot. */
-    void restoreSnapshot(const Snapshot& snapshot);
+    /** @brief Discards the snapshot of an edit that turned out to change nothing. */
+    void dropSnapshot();
+
+    /**
+     * @brief Adds an operation of the current edit, and the operations undoing it.
+     *
+     * Call in the order the operations apply; inverse ones are put in front.
+     */
+    void record(const Operation& forward, const QVector<Operation>& inverse);
+    void record(const Operation& forward, const Operation& inverse);
+
+    /** @brief Records the splice turning oldText of a segment into newText, if they differ. */
+    void recordTextChange(quint64 segmentID, const QString& oldText, const QString& newText);
+
+    /** @brief Records the splices trim() makes to untrimmed, which has ID segmentID. */
+    void recordTrim(quint64 segmentID, const Model::Data::Segment& untrimmed);
 
-    /** @brief Marks the transcript as edited by updating lastEdited. */
+    /** @brief Restores the transcript's speakers and segments from a given version. */
+    void restoreSnapshot(const Model::Data::TranscriptVersion& snapshot);
+
+    /** @brief Marks the transcript as edited by updating lastEdited and the version number. */
     void markEdited();
 
+    /** @brief Merges a replaced segment range into the pending change. */
+    void recordChange(int first, int removedCount, int insertedCount);
+
+    /** @brief Marks the whole transcript as changed. */
+    void recordFullChange();
+
     /** @brief Checks whether a segment index is valid. */
     bool isValidSegmentIndex(int index) const;
 
-    /** @brief Helper to perform a string replacement inside one QString. */
+    /**
+     * @brief Helper to perform a string replacement inside one QString.
+     *
+     * If outMatches is given, it receives the position (in the text as
+     * replaced so far) and the replaced text of each match.
+     */
     static int replaceAllInString(QString& text,
                                   const QString& from,
                                   const QString& to,
-                                  Qt::CaseSensitivity cs);
+                                  Qt::CaseSensitivity cs,
+                                  QVector<QPair<int, QString>>* outMatches = nullptr);
+
+    /** @brief Records one splice per match of replaceAllInString() in segment segmentID. */
+    void recordReplacements(quint64 segmentID,
+                            const QString& to,
+                            const QVector<QPair<int, QString>>& matches);
 
 #ifdef QT_DEBUG
     /** @brief Logs current undo/redo sizes (debug only). */
@@ -200,7 +373,7 @@ private:
 #endif
 
 
-    Model::Data::Transcript& editedTranscript;
+    Model::Data::Transcript* editedTranscript;
 
 };
 
@@ -1,81 +1,61 @@
 #include "TranscriptExporter.h"
+#include "ContentHash.h"
+#include "Utf8StreamWriter.h"
 
 #include <QDir>
 #include <QFile>
 #include <QFileInfo>
+#include <QHash>
+#include <QMutex>
+#include <QSaveFile>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QDateTime>
+#include <QVector>
 
 namespace Model {
 namespace Service {
 
 using namespace Model::Data;
 
-bool TranscriptExporter::exportEditableTranscript(Model::Data::Transcript& transcript,
-                                                  QString* errorMessage) const {
-    if (transcript.folderPath.isEmpty()) {
-        if (errorMessage)
-            *errorMessage = QStringLiteral("Transcript folderPath is empty; cannot export editable transcript.");
-        return false;
-    }
+namespace {
 
-    QDir folder(transcript.folderPath);
-    if (!folder.exists()) {
-        if (errorMessage)
-            *errorMessage = QStringLiteral("Transcript folder does not exist: %1").arg(transcript.folderPath);
-        return false;
-    }
+/** @brief Hash of a file's content as last read or written, with the stat data it was valid for. */
+struct KnownFile {
+    quint64 hash = 0;
+    qint64 size = -1;
+    QDateTime modified;
+};
 
-    QString editablePath = transcript.editablePath;
+// Shared by every exporter and the writer thread
+QMutex knownFilesMutex;
+QHash<QString, KnownFile> knownFiles;
 
-    // If no editablePath yet, default to editable.txt inside the folder
-    if (editablePath.isEmpty()) {
-        editablePath = folder.filePath(QStringLiteral("editable.txt"));
-    }
-    else {
-        QFileInfo info(editablePath);
-        if (!info.isAbsolute())
-            editablePath = folder.filePath(editablePath);
-    }
+}
+
+bool TranscriptExporter::exportEditableTranscript(Model::Data::Transcript& transcript,
+                                                  QString* errorMessage) const {
+    QString editablePath;
+    if (!resolveEditablePath(transcript, editablePath, errorMessage))
+        return false;
 
-    const QString text = buildTranscriptText(transcript);
-    if (!writeTextFile(editablePath, text, errorMessage))
+    bool written = false;
+    if (!writeFragments(editablePath, collectFragments(transcript), errorMessage, &written))
         return false;
 
-    // Update lastEdited timestamp to now (save moment)
-    transcript.lastEdited = QDateTime::currentDateTimeUtc();
+    // Update lastEdited timestamp to now (save moment), unless nothing changed
+    if (written)
+        transcript.lastEdited = QDateTime::currentDateTimeUtc();
     return true;
 }
 
 bool TranscriptExporter::exportReferenceTranscript(Model::Data::Transcript& transcript,
                                                    QString* errorMessage) const {
-    if (transcript.folderPath.isEmpty()) {
-        if (errorMessage)
-            *errorMessage = QStringLiteral("Transcript folderPath is empty; cannot export reference transcript.");
-        return false;
-    }
-
-    if (transcript.referencePath.isEmpty()) {
-        if (errorMessage)
-            *errorMessage = QStringLiteral("Transcript referencePath is empty; nothing to export.");
-        return false;
-    }
-
-    QDir folder(transcript.folderPath);
-    if (!folder.exists()) {
-        if (errorMessage)
-            *errorMessage = QStringLiteral("Transcript folder does not exist: %1").arg(transcript.folderPath);
+    QString refPath;
+    if (!resolveReferencePath(transcript, refPath, errorMessage))
         return false;
-    }
-
-    QString refPath = transcript.referencePath;
-    QFileInfo refInfo(refPath);
-    if (!refInfo.isAbsolute())
-        refPath = folder.filePath(refPath);
 
-    const QString text = buildTranscriptText(transcript);
-    if (!writeTextFile(refPath, text, errorMessage))
+    if (!writeFragments(refPath, collectFragments(transcript), errorMessage))
         return false;
 
     // Reference export does not necessarily mean content was edited now,
@@ -92,8 +72,7 @@ bool TranscriptExporter::exportToTextFile(const Model::Data::Transcript& transcr
         return false;
     }
 
-    const QString text = buildTranscriptText(transcript);
-    return writeTextFile(absolutePath, text, errorMessage);
+    return writeFragments(absolutePath, collectFragments(transcript), errorMessage);
 }
 
 bool TranscriptExporter::exportMetadata(Model::Data::Transcript& transcript,
@@ -122,63 +101,193 @@ bool TranscriptExporter::exportMetadata(Model::Data::Transcript& transcript,
 bool TranscriptExporter::exportAll(Model::Data::Transcript& transcript,
                                    bool exportReference,
                                    QString* errorMessage) const {
+    SavePlan plan;
+    if (!prepareSave(transcript, exportReference, plan, errorMessage))
+        return false;
+
+    QDateTime lastEdited;
+    if (!writeSave(plan, errorMessage, &lastEdited))
+        return false;
+
+    transcript.lastEdited = lastEdited;
+    transcript.markSaved(plan.generation);
+    return true;
+}
+
+
+bool TranscriptExporter::prepareSave(const Model::Data::Transcript& transcript,
+                                     bool exportReference,
+                                     SavePlan& outPlan,
+                                     QString* errorMessage) const {
+    SavePlan plan;
+    plan.transcriptID = transcript.id;
+    plan.generation = transcript.generation();
+
+    if (!resolveEditablePath(transcript, plan.editablePath, errorMessage))
+        return false;
+
+    if (exportReference && !resolveReferencePath(transcript, plan.referencePath, errorMessage))
+        return false;
+
+    plan.folderPath = QDir(transcript.folderPath).absolutePath();
+    plan.fragments = collectFragments(transcript);
+
+    // writeSave() sets meta's lastEdited, depending on whether the text changed
+    plan.savedAt = QDateTime::currentDateTimeUtc();
+    plan.previousEdited = transcript.lastEdited;
+    plan.meta = buildMetaJson(transcript);
+
+    outPlan = plan;
+    return true;
+}
+
+bool TranscriptExporter::writeSave(const SavePlan& plan, QString* errorMessage, QDateTime* outLastEdited) {
+
     // 1) Editable text
-    if (!exportEditableTranscript(transcript, errorMessage))
+    bool textWritten = false;
+    if (!writeFragments(plan.editablePath, plan.fragments, errorMessage, &textWritten))
         return false;
 
     // 2) Optional reference text
-    if (exportReference) {
-        if (!exportReferenceTranscript(transcript, errorMessage))
+    if (!plan.referencePath.isEmpty()) {
+        if (!writeFragments(plan.referencePath, plan.fragments, errorMessage))
             return false;
     }
 
-    // 3) Metadata
-    if (!exportMetadata(transcript, errorMessage))
+    // 3) Metadata: an unchanged text keeps its lastEdited, so meta.json is
+    //    usually unchanged too and skipped as well
+    const QDateTime lastEdited = (textWritten || !plan.previousEdited.isValid())
+                                     ? plan.savedAt
+                                     : plan.previousEdited;
+
+    QJsonObject meta = plan.meta;
+    meta.insert(QStringLiteral("lastEdited"), lastEdited.toString(Qt::ISODate));
+
+    if (!writeMetaFile(plan.folderPath, meta, errorMessage))
         return false;
 
+    if (outLastEdited)
+        *outLastEdited = lastEdited;
     return true;
 }
 
 
-QString TranscriptExporter::buildTranscriptText(const Model::Data::Transcript& transcript) const {
+QVector<QString> TranscriptExporter::collectFragments(const Model::Data::Transcript& transcript) {
 
     // Build something close to the original format:
     // Each segment begins with "Speaker: first line of text"
     // and continuation lines follow, then a blank line between segments.
 
-    QStringList lines;
+    // Mostly cached: only edited segments are serialized again
+    QVector<QString> fragments;
+    fragments.reserve(transcript.segments.size());
+
     for (const Segment& seg : transcript.segments) {
+        const QString& fragment = segmentFragment(seg, transcript.speakerIDOf(seg));
+        if (!fragment.isEmpty())
+            fragments.push_back(fragment);
+    }
 
-        const QString speaker = seg.speakerID.isEmpty()
-                                    ? QStringLiteral("UNKNOWN")
-                                    : seg.speakerID;
+    if (fragments.isEmpty()) {
+        fragments.push_back(QStringLiteral("\n"));
+        return fragments;
+    }
 
-        QString segText = seg.text;
-        segText = segText.trimmed();
+    // Drop the separator after the last segment, keep its final newline.
+    // Only this element is detached; the cached fragment is left as it is.
+    fragments.last().chop(1);
+    return fragments;
+}
 
-        if (segText.isEmpty())
-            continue;
+bool TranscriptExporter::resolveEditablePath(const Model::Data::Transcript& transcript,
+                                             QString& outPath,
+                                             QString* errorMessage) {
+    if (transcript.folderPath.isEmpty()) {
+        if (errorMessage)
+            *errorMessage = QStringLiteral("Transcript folderPath is empty; cannot export editable transcript.");
+        return false;
+    }
 
-        QStringList segLines = segText.split(QLatin1Char('\n'), Qt::KeepEmptyParts);
+    QDir folder(transcript.folderPath);
+    if (!folder.exists()) {
+        if (errorMessage)
+            *errorMessage = QStringLiteral("Transcript folder does not exist: %1").arg(transcript.folderPath);
+        return false;
+    }
 
-        if (segLines.isEmpty())
-            continue;
+    QString editablePath = transcript.editablePath;
 
-        // First line is prefixed with "Speaker: "
-        lines << QStringLiteral("%1: %2").arg(speaker, segLines.takeFirst());
+    // If no editablePath yet, default to editable.txt inside the folder
+    if (editablePath.isEmpty()) {
+        editablePath = folder.filePath(QStringLiteral("editable.txt"));
+    }
+    else {
+        QFileInfo info(editablePath);
+        if (!info.isAbsolute())
+            editablePath = folder.filePath(editablePath);
+    }
 
-        // Remaining lines are appended as-is
-        for (const QString& l : segLines) lines << l;
+    outPath = editablePath;
+    return true;
+}
 
-        // Blank line between segments for readability
-        lines << QString();
+bool TranscriptExporter::resolveReferencePath(const Model::Data::Transcript& transcript,
+                                              QString& outPath,
+                                              QString* errorMessage) {
+    if (transcript.folderPath.isEmpty()) {
+        if (errorMessage)
+            *errorMessage = QStringLiteral("Transcript folderPath is empty; cannot export reference transcript.");
+        return false;
+    }
+
+    if (transcript.referencePath.isEmpty()) {
+        if (errorMessage)
+            *errorMessage = QStringLiteral("Transcript referencePath is empty; nothing to export.");
+        return false;
+    }
+
+    QDir folder(transcript.folderPath);
+    if (!folder.exists()) {
+        if (errorMessage)
+            *errorMessage = QStringLiteral("Transcript folder does not exist: %1").arg(transcript.folderPath);
+        return false;
     }
 
-    // Remove trailing empty lines
-    while (!lines.isEmpty() && lines.last().trimmed().isEmpty())
-        lines.removeLast();
+    QString refPath = transcript.referencePath;
+    QFileInfo refInfo(refPath);
+    if (!refInfo.isAbsolute())
+        refPath = folder.filePath(refPath);
 
-    return lines.join(QLatin1Char('\n')) + QLatin1Char('\n');
+    outPath = refPath;
+    return true;
+}
+
+const QString& TranscriptExporter::segmentFragment(const Segment& segment, const QString& speakerID) {
+
+    // Null key = no cached fragment (invalidated by every edit of the segment)
+    if (!segment.exportSpeakerID.isNull() && segment.exportSpeakerID == speakerID)
+        return segment.exportText;
+
+    const QStringView segText = QStringView(segment.text()).trimmed();
+
+    QString fragment;
+    if (!segText.isEmpty()) {
+        const QString& label = speakerID.isEmpty() ? QStringLiteral("UNKNOWN") : speakerID;
+
+        fragment.reserve(label.size() + segText.size() + 4);
+
+        // First line is prefixed with "Speaker: ", the others follow as-is
+        fragment += label;
+        fragment += QLatin1String(": ");
+        fragment += segText;
+
+        // Blank line between segments for readability
+        fragment += QLatin1String("\n\n");
+    }
+
+    segment.exportText = fragment;
+    segment.exportSpeakerID = speakerID.isNull() ? QStringLiteral("") : speakerID;
+    return segment.exportText;
 }
 
 QJsonObject TranscriptExporter::buildMetaJson(const Model::Data::Transcript& transcript) const {
@@ -217,9 +326,29 @@ QJsonObject TranscriptExporter::buildMetaJson(const Model::Data::Transcript& tra
     return meta;
 }
 
-bool TranscriptExporter::writeTextFile(const QString& absolutePath, const QString& text, QString* errorMessage) const {
+bool TranscriptExporter::writeFragments(const QString& absolutePath,
+                                        const QVector<QString>& fragments,
+                                        QString* errorMessage,
+                                        bool* outWritten) {
+    if (outWritten)
+        *outWritten = false;
+
+    // First pass: hash the UTF-8 output through the writer's buffer, never as a whole
+    ContentHash hasher;
+    {
+        Utf8StreamWriter hashing(nullptr, &hasher);
+        for (const QString& fragment : fragments)
+            hashing.write(fragment);
+        hashing.flush();
+    }
+    const quint64 hash = hasher.result();
 
-    QFile f(absolutePath);
+    // Same content already on disk: leave the file (and its mtime) alone
+    if (fileHasHash(absolutePath, hash))
+        return true;
+
+    // Written to a temporary file, synced and renamed over the target by commit()
+    QSaveFile f(absolutePath);
 
     if (!f.open(QIODevice::WriteOnly | QIODevice::Text)) {
 
@@ -228,39 +357,98 @@ bool TranscriptExporter::writeTextFile(const QString& absolutePath, const QStrin
         return false;
     }
 
-    const QByteArray utf8 = text.toUtf8();
+    // Second pass: same encoding, streamed to the file in BufferSize pieces
+    Utf8StreamWriter out(&f);
+    for (const QString& fragment : fragments) {
+        if (!out.write(fragment))
+            break;
+    }
 
-    if (f.write(utf8) != utf8.size()) {
+    if (!out.flush()) {
 
         if (errorMessage)
             *errorMessage = QStringLiteral("Failed to write full contents to file: %1").arg(absolutePath);
+        f.cancelWriting();
         return false;
     }
 
-    f.close();
+    if (!f.commit()) {
+
+        if (errorMessage)
+            *errorMessage = QStringLiteral("Cannot replace file: %1").arg(absolutePath);
+        return false;
+    }
 
+    rememberFileHash(absolutePath, hash);
+
+    if (outWritten)
+        *outWritten = true;
     return true;
 }
 
-bool TranscriptExporter::writeMetaFile(const QString& folderPath, const QJsonObject& meta, QString* errorMessage) const {
+bool TranscriptExporter::writeMetaFile(const QString& folderPath, const QJsonObject& meta, QString* errorMessage) {
 
     QDir folder(folderPath);
     const QString metaPath = folder.filePath(QStringLiteral("meta.json"));
 
-    QFile f(metaPath);
+    const QByteArray json = QJsonDocument(meta).toJson(QJsonDocument::Indented);
 
-    if (!f.open(QIODevice::WriteOnly | QIODevice::Text)) {
+    // Small file: one fragment, same hashing and atomic replace as the text
+    return writeFragments(metaPath, { QString::fromUtf8(json) }, errorMessage);
+}
 
-        if (errorMessage)
-            *errorMessage = QStringLiteral("Cannot write meta.json: %1").arg(metaPath);
+bool TranscriptExporter::fileHasHash(const QString& absolutePath, quint64 hash) {
+
+    const QFileInfo info(absolutePath);
+    if (!info.exists())
         return false;
+
+    {
+        QMutexLocker lock(&knownFilesMutex);
+        const auto it = knownFiles.constFind(absolutePath);
+
+        // Trust the cached hash only while the file looks untouched since
+        if (it != knownFiles.constEnd()
+            && it->size == info.size()
+            && it->modified == info.lastModified())
+            return it->hash == hash;
     }
 
-    QJsonDocument doc(meta);
-    f.write(doc.toJson(QJsonDocument::Indented));
-    f.close();
+    // Unknown or modified elsewhere: hash what is on disk, in chunks.
+    // Text mode, so the bytes compare equal to what writeFragments() hashes.
+    QFile f(absolutePath);
+    if (!f.open(QIODevice::ReadOnly | QIODevice::Text))
+        return false;
 
-    return true;
+    ContentHash hasher;
+    while (!f.atEnd()) {
+        const QByteArray chunk = f.read(HashChunkSize);
+        if (chunk.isEmpty())
+            return false;
+        hasher.addData(chunk);
+    }
+
+    KnownFile known;
+    known.hash = hasher.result();
+    known.size = info.size();
+    known.modified = info.lastModified();
+
+    QMutexLocker lock(&knownFilesMutex);
+    knownFiles.insert(absolutePath, known);
+    return known.hash == hash;
+}
+
+void TranscriptExporter::rememberFileHash(const QString& absolutePath, quint64 hash) {
+
+    const QFileInfo info(absolutePath);
+
+    KnownFile known;
+    known.hash = hash;
+    known.size = info.size();
+    known.modified = info.lastModified();
+
+    QMutexLocker lock(&knownFilesMutex);
+    knownFiles.insert(absolutePath, known);
 }
 
 QString TranscriptExporter::toRelativePath(const QString& folderPath, const QString& absoluteOrRelativePath) {
@@ -3,8 +3,10 @@
 
 #include "Model/Data/Transcript.h"
 
+#include <QDateTime>
 #include <QString>
 #include <QJsonObject>
+#include <QVector>
 
 namespace Model {
 namespace Service {
@@ -21,12 +23,46 @@ namespace Service {
  * This class does not manage multiple transcripts or UI; it works on a single
  * Transcript at a time and assumes TranscriptManager / Controller decide when
  * to call it.
+ *
+ * The serialized text of each segment is cached in the segment itself
+ * (Segment::exportText) until it is edited, so re-saving a transcript only
+ * re-serializes the segments that changed.
+ *
+ * Files are written through QSaveFile (temporary file, flushed to disk, then
+ * renamed over the target), so a crash mid-save leaves the previous file
+ * intact. Before writing, the output is hashed (XXH64) and compared with
+ * the hash of the file on disk, cached from the last read or write;
+ * identical content is not rewritten and keeps its mtime. Both passes
+ * encode the segment fragments through a fixed-size Utf8StreamWriter
+ * buffer, so the UTF-8 text never exists as a whole in memory.
+ *
+ * Saves can be split into prepareSave(), which reads the transcript and
+ * must run on the thread that edits it, and writeSave(), which only
+ * touches the plan and can run on any thread.
  */
 
 class TranscriptExporter {
 
 public:
 
+    /**
+     * @brief Immutable description of one save, produced by prepareSave().
+     *
+     * Holds implicitly shared copies only, so it can be handed to another
+     * thread while the transcript keeps being edited.
+     */
+    struct SavePlan {
+        QString transcriptID;
+        QString editablePath;        // Absolute
+        QString referencePath;       // Absolute; empty if the reference is not written
+        QString folderPath;          // Absolute; meta.json goes here
+        QVector<QString> fragments;  // Serialized segments, in order
+        QJsonObject meta;
+        QDateTime savedAt;           // New lastEdited value if the text changed
+        QDateTime previousEdited;    // Transcript's lastEdited when planned; kept otherwise
+        quint64 generation = 0;      // Transcript::generation() captured by the plan
+    };
+
     /** @brief Default constructor. */
     TranscriptExporter() = default;
 
@@ -73,19 +109,83 @@ public:
                    bool exportReference = false,
                    QString* errorMessage = nullptr) const;
 
+
+    /**
+     * @brief Captures what exportAll() would write, without touching the disk.
+     *
+     * Validates the folder and paths and collects the segment fragments.
+     * The transcript itself is not modified; once writeSave() succeeds, set
+     * its lastEdited to the value writeSave() reports and call
+     * markSaved(outPlan.generation).
+     */
+    bool prepareSave(const Model::Data::Transcript& transcript,
+                     bool exportReference,
+                     SavePlan& outPlan,
+                     QString* errorMessage = nullptr) const;
+
+    /**
+     * @brief Writes the files described by plan (editable, reference, meta.json).
+     *
+     * Files whose content is unchanged are skipped. outLastEdited receives the
+     * lastEdited value written to meta.json: plan.savedAt if the text changed,
+     * plan.previousEdited otherwise. Thread-safe: reads nothing but plan and
+     * the shared file hash cache.
+     */
+    static bool writeSave(const SavePlan& plan,
+                          QString* errorMessage = nullptr,
+                          QDateTime* outLastEdited = nullptr);
+
 private:
 
-    /** @brief Builds a .txt representation of the transcript from segments. */
-    QString buildTranscriptText(const Model::Data::Transcript& transcript) const;
+    /** @brief Bytes read at a time when hashing a file on disk. */
+    static constexpr qint64 HashChunkSize = 64 * 1024;
+
+    /**
+     * @brief Builds the .txt representation of the transcript from segments.
+     *
+     * Returned as pieces (mostly the cached segment fragments) whose
+     * concatenation is the file text.
+     */
+    static QVector<QString> collectFragments(const Model::Data::Transcript& transcript);
+
+    /** @brief Resolves the absolute editable.txt path of transcript. */
+    static bool resolveEditablePath(const Model::Data::Transcript& transcript,
+                                    QString& outPath,
+                                    QString* errorMessage);
+
+    /** @brief Resolves the absolute reference path of transcript. */
+    static bool resolveReferencePath(const Model::Data::Transcript& transcript,
+                                     QString& outPath,
+                                     QString* errorMessage);
+
+    /**
+     * @brief Returns the serialized form of segment ("Speaker: text\n\n").
+     *
+     * Cached in the segment for speakerID; empty if the text is blank.
+     */
+    static const QString& segmentFragment(const Model::Data::Segment& segment, const QString& speakerID);
 
     /** @brief Builds a JSON object representing meta.json for the transcript. */
     QJsonObject buildMetaJson(const Model::Data::Transcript& transcript) const;
 
-    /** @brief Writes UTF-8 text to a file on disk. */
-    bool writeTextFile(const QString& absolutePath, const QString& text, QString* errorMessage) const;
+    /**
+     * @brief Atomically writes the concatenation of fragments as UTF-8, unless unchanged.
+     *
+     * outWritten is set to false if the file already held this content.
+     */
+    static bool writeFragments(const QString& absolutePath,
+                               const QVector<QString>& fragments,
+                               QString* errorMessage,
+                               bool* outWritten = nullptr);
+
+    /** @brief Atomically writes meta.json to the transcript's folder, unless unchanged. */
+    static bool writeMetaFile(const QString& folderPath, const QJsonObject& meta, QString* errorMessage);
+
+    /** @brief Returns true if the file at absolutePath has content hash (hashing it if not cached). */
+    static bool fileHasHash(const QString& absolutePath, quint64 hash);
 
-    /** @brief Writes meta.json to the transcript's folder. */
-    bool writeMetaFile(const QString& folderPath, const QJsonObject& meta, QString* errorMessage) const;
+    /** @brief Caches hash as the content of the file just written to absolutePath. */
+    static void rememberFileHash(const QString& absolutePath, quint64 hash);
 
     /** @brief Returns path relative to folderPath, or empty string if path is empty. */
     static QString toRelativePath(const QString& folderPath, const QString& absoluteOrRelativePath);
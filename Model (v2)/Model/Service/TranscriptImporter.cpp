@@ -29,6 +29,25 @@ bool TranscriptImporter::importFromFolder(
     Transcript& outTranscript,
     QString* errorMessage) const {
 
+    return readFolder(folderPath, speakerNames, true, outTranscript, errorMessage);
+}
+
+bool TranscriptImporter::loadFromFolder(
+    const QString& folderPath,
+    const QStringList& speakerNames,
+    Transcript& outTranscript,
+    QString* errorMessage) const {
+
+    return readFolder(folderPath, speakerNames, false, outTranscript, errorMessage);
+}
+
+bool TranscriptImporter::readFolder(
+    const QString& folderPath,
+    const QStringList& speakerNames,
+    bool updateMetadata,
+    Transcript& outTranscript,
+    QString* errorMessage) const {
+
     if (speakerNames.isEmpty()) {
         if (errorMessage)
             *errorMessage = QStringLiteral("No speaker names provided.");
@@ -67,10 +86,15 @@ bool TranscriptImporter::importFromFolder(
                                   ? QString()
                                   : dir.filePath(audioFileName);
 
-    // --- Load reference text and parse ---
+    // --- Load text and parse ---
+
+    // The editable text holds the saved edits; the reference is the original
+    const QString textPath = outTranscript.editablePath.isEmpty()
+                                 ? outTranscript.referencePath
+                                 : outTranscript.editablePath;
 
     QString rawText;
-    if (!loadTextFile(outTranscript.referencePath, rawText, errorMessage)) {
+    if (!loadTextFile(textPath, rawText, errorMessage)) {
         return false;
     }
 
@@ -78,7 +102,7 @@ bool TranscriptImporter::importFromFolder(
     if (!parser.parse(rawText, outTranscript, speakerNames)) {
         if (errorMessage)
             *errorMessage = QStringLiteral("Failed to parse transcript text in: %1")
-                                .arg(outTranscript.referencePath);
+                                .arg(textPath);
         return false;
     }
 
@@ -115,6 +139,14 @@ bool TranscriptImporter::importFromFolder(
                                   Qt::ISODate);
     }
 
+    if (!updateMetadata) {
+        // Read-only load: keep what meta.json says
+        outTranscript.lastEdited =
+            QDateTime::fromString(meta.value(QStringLiteral("lastEdited")).toString(), Qt::ISODate);
+        outTranscript.id = meta.value(QStringLiteral("id")).toString();
+        return true;
+    }
+
     // Always update lastEdited to now on import
     meta.insert(QStringLiteral("lastEdited"), nowUtc.toString(Qt::ISODate));
     outTranscript.lastEdited = nowUtc;
@@ -146,7 +178,8 @@ QString TranscriptImporter::findReferenceTextFile(const QDir& dir) const {
 
     // Strategy:
     // 1. Look for a file named "transcript.txt"
-    // 2. Otherwise, take the first *.txt in alphabetical order
+    // 2. Otherwise, take the first *.txt in alphabetical order that is not
+    //    an editable file (editable.txt / edit.txt hold the saved edits)
 
     QStringList txtFiles = dir.entryList(QStringList() << "*.txt",
                                          QDir::Files | QDir::Readable,
@@ -163,6 +196,14 @@ QString TranscriptImporter::findReferenceTextFile(const QDir& dir) const {
         }
     }
 
+    for (const QString& f : txtFiles) {
+        if (f.compare(QStringLiteral("editable.txt"), Qt::CaseInsensitive) != 0 &&
+            f.compare(QStringLiteral("edit.txt"), Qt::CaseInsensitive) != 0) {
+            return f;
+        }
+    }
+
+    // Only an editable file: it is the reference as well
     return txtFiles.first();
 }
 
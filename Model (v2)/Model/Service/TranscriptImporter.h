@@ -42,9 +42,27 @@ public:
                           Model::Data::Transcript& outTranscript,
                           QString* errorMessage = nullptr) const;
 
+    /**
+     * @brief Loads a transcript folder like importFromFolder(), without writing anything.
+     *
+     * meta.json is only read: lastEdited and dateImported keep their stored
+     * values. For folders that were imported before (e.g. reloading one).
+     */
+    bool loadFromFolder(const QString& folderPath,
+                        const QStringList& speakerNames,
+                        Model::Data::Transcript& outTranscript,
+                        QString* errorMessage = nullptr) const;
+
 
 private:
 
+    /** @brief Shared implementation; writes meta.json only with updateMetadata. */
+    bool readFolder(const QString& folderPath,
+                    const QStringList& speakerNames,
+                    bool updateMetadata,
+                    Model::Data::Transcript& outTranscript,
+                    QString* errorMessage) const;
+
     /** @brief Finds the reference text file (e.g. transcript.txt / ref.txt) in the folder. */
     QString findReferenceTextFile(const QDir& dir) const;
     /** @brief Finds an editable text file distinct from the reference (e.g. editable.txt). */
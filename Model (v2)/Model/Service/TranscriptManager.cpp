@@ -1,11 +1,20 @@
 #include "TranscriptManager.h"
+#include "ContentHash.h"
+#include "EditLog.h"
+#include "TranscriptBundle.h"
+#include "TranscriptExporter.h"
 
+#include <QDateTime>
 #include <QDir>
 #include <QFileInfo>
 #include <QFile>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
+#include <QSet>
+#include <QStandardPaths>
+
+#include <algorithm>
 
 namespace Model {
 namespace Service {
@@ -31,7 +40,7 @@ QString TranscriptManager::rootDirectory() const {
 
 bool TranscriptManager::loadAllFromRoot(QString* errorMessage)
 {
-    transcriptList.clear();
+    clear();
 
     if (rootDir.isEmpty()) {
         if (errorMessage)
@@ -50,60 +59,39 @@ bool TranscriptManager::loadAllFromRoot(QString* errorMessage)
     bool anyLoaded = false;
 
     for (const QString& subName : subDirs) {
-        QDir subDir(root.filePath(subName));
-        QString metaPath = subDir.filePath(QStringLiteral("meta.json"));
-
-        QFileInfo metaInfo(metaPath);
-        if (!metaInfo.exists())
-            continue; // Not a transcript folder (no meta.json), skip.
-
-        // Load meta.json to get speaker list
-        QFile metaFile(metaPath);
-        if (!metaFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
-            // If one folder fails, record the first error but keep trying others
-            if (errorMessage && errorMessage->isEmpty())
-                *errorMessage = QStringLiteral("Cannot open meta.json: %1").arg(metaPath);
-            continue;
-        }
+        const QString folderPath = QDir(root.filePath(subName)).absolutePath();
 
-        const QByteArray rawMeta = metaFile.readAll();
-        QJsonParseError parseErr;
-        QJsonDocument doc = QJsonDocument::fromJson(rawMeta, &parseErr);
-        if (parseErr.error != QJsonParseError::NoError || !doc.isObject()) {
+        // If one folder fails, record the first error but keep trying others
+        Transcript transcript;
+        QString localError;
+        if (!readTranscriptFolder(folderPath, true, transcript, &localError)) {
             if (errorMessage && errorMessage->isEmpty())
-                *errorMessage = QStringLiteral("Error parsing meta.json at %1: %2")
-                                    .arg(metaPath, parseErr.errorString());
+                *errorMessage = localError;
             continue;
         }
 
-        QJsonObject metaObj = doc.object();
-        QJsonArray speakersArray = metaObj.value(QStringLiteral("speakers")).toArray();
-        if (speakersArray.isEmpty()) {
-            // If no speakers in meta, we skip this transcript
-            continue;
-        }
+        appendTranscript(transcript);
+        sourceFingerprints.insert(folderPath, fingerprintOf(folderPath));
+        anyLoaded = true;
+    }
 
-        QStringList speakerNames;
-        for (const QJsonValue& v : speakersArray) {
-            if (v.isString())
-                speakerNames << v.toString().trimmed();
-        }
+    // Single-file bundles next to the transcript folders
+    const QStringList bundleFiles = root.entryList({ QStringLiteral("*.%1").arg(QLatin1String(TranscriptBundle::Suffix)) },
+                                                   QDir::Files | QDir::Readable, QDir::Name);
 
-        if (speakerNames.isEmpty())
-            continue;
+    for (const QString& fileName : bundleFiles) {
+        const QString bundlePath = root.absoluteFilePath(fileName);
 
-        // Use TranscriptImporter to fully import and parse this transcript
         Transcript transcript;
         QString localError;
-        if (!importer.importFromFolder(subDir.absolutePath(), speakerNames,
-                                         transcript, &localError)) {
+        if (!readBundle(bundlePath, transcript, &localError)) {
             if (errorMessage && errorMessage->isEmpty())
-                *errorMessage = QStringLiteral("Failed to import %1: %2")
-                                    .arg(subDir.absolutePath(), localError);
+                *errorMessage = localError;
             continue;
         }
 
-        transcriptList.push_back(transcript);
+        appendTranscript(transcript);
+        sourceFingerprints.insert(bundlePath, fingerprintOf(bundlePath));
         anyLoaded = true;
     }
 
@@ -112,6 +100,9 @@ bool TranscriptManager::loadAllFromRoot(QString* errorMessage)
         *errorMessage = QStringLiteral("No transcripts found in root directory: %1").arg(rootDir);
     }
 
+#ifdef QT_DEBUG
+    Q_ASSERT_X(checkIndexes(), "TranscriptManager", "lookup indexes out of sync");
+#endif
     return true;
 }
 
@@ -127,19 +118,360 @@ bool TranscriptManager::importTranscriptFromFolder(
         return false;
     }
 
-    transcriptList.push_back(transcript);
+    if (db.isOpen() && !db.storeTranscript(transcript, errorMessage))
+        return false;
+
+    const int index = appendTranscript(transcript);
+    refreshFingerprint(index);
+#ifdef QT_DEBUG
+    Q_ASSERT_X(checkIndexes(), "TranscriptManager", "lookup indexes out of sync");
+#endif
     if (outIndex) {
-        *outIndex = transcriptList.size() - 1;
+        *outIndex = index;
+    }
+    return true;
+}
+
+bool TranscriptManager::importTranscriptFromBundle(const QString& bundlePath,
+                                                   int* outIndex,
+                                                   QString* errorMessage) {
+    Transcript transcript;
+    if (!readBundle(bundlePath, transcript, errorMessage))
+        return false;
+
+    const int index = appendTranscript(transcript);
+    refreshFingerprint(index);
+#ifdef QT_DEBUG
+    Q_ASSERT_X(checkIndexes(), "TranscriptManager", "lookup indexes out of sync");
+#endif
+    if (outIndex)
+        *outIndex = index;
+    return true;
+}
+
+bool TranscriptManager::saveBundle(int index,
+                                   const QString& bundlePath,
+                                   bool includeAudio,
+                                   QString* errorMessage) const {
+    const Transcript* t = transcriptAt(index);
+    if (!t) {
+        if (errorMessage)
+            *errorMessage = QStringLiteral("Invalid transcript index: %1").arg(index);
+        return false;
+    }
+
+    TranscriptBundle::Plan plan;
+    if (!TranscriptBundle::prepare(*t, bundlePath, includeAudio, plan, errorMessage))
+        return false;
+
+    return TranscriptBundle::write(plan, errorMessage);
+}
+
+QString TranscriptManager::bundleAudioPath(const QString& transcriptID, const QString& audioFileName) {
+
+    // IDs may contain path separators (e.g. a bundle's own path as fallback ID)
+    const QString safeID = QString::number(qHash(transcriptID), 16);
+
+    QDir cache(QStandardPaths::writableLocation(QStandardPaths::CacheLocation));
+    return cache.filePath(QStringLiteral("bundle-audio/%1-%2").arg(safeID, audioFileName));
+}
+
+bool TranscriptManager::exportTranscriptToFolder(int index,
+                                                 const QString& folderPath,
+                                                 QString* errorMessage) const {
+    const Transcript* source = transcriptAt(index);
+    if (!source) {
+        if (errorMessage)
+            *errorMessage = QStringLiteral("Invalid transcript index: %1").arg(index);
+        return false;
+    }
+
+    QDir folder(folderPath);
+    if (!folder.mkpath(QStringLiteral("."))) {
+        if (errorMessage)
+            *errorMessage = QStringLiteral("Cannot create folder: %1").arg(folderPath);
+        return false;
+    }
+
+    // The copy shares the segment texts; only its paths point to the new folder
+    Transcript transcript = *source;
+    transcript.folderPath = folder.absolutePath();
+    transcript.editablePath.clear();
+    transcript.referencePath = folder.filePath(QStringLiteral("transcript.txt"));
+    transcript.bundlePath.clear();
+
+    if (!source->audioPath.isEmpty() && QFileInfo::exists(source->audioPath)) {
+        const QString audioCopy = folder.filePath(QFileInfo(source->audioPath).fileName());
+        if (QFileInfo(audioCopy) != QFileInfo(source->audioPath)) {
+            QFile::remove(audioCopy);
+            if (!QFile::copy(source->audioPath, audioCopy)) {
+                if (errorMessage)
+                    *errorMessage = QStringLiteral("Cannot copy audio to %1").arg(audioCopy);
+                return false;
+            }
+        }
+        transcript.audioPath = audioCopy;
+    }
+
+    TranscriptExporter exporter;
+    return exporter.exportAll(transcript, true, errorMessage);
+}
+
+
+// === Database storage ===
+
+bool TranscriptManager::openDatabase(const QString& path, QString* errorMessage) {
+
+    closeDatabase();
+
+    if (!db.open(path, errorMessage))
+        return false;
+
+    for (int i = 0; i < transcriptList.size(); ++i) {
+        const Transcript& t = transcriptList[i];
+        if (t.isBundle() || db.contains(t.id))
+            continue;
+
+        QString localError;
+        const bool ok = ensureResident(i, &localError) && db.storeTranscript(t, &localError);
+        if (!ok && errorMessage && errorMessage->isEmpty())
+            *errorMessage = localError;
     }
+
     return true;
 }
 
+void TranscriptManager::closeDatabase() {
 
+    if (!db.isOpen())
+        return;
+
+    db.flush();
+    db.close();
+}
+
+bool TranscriptManager::hasDatabase() const {
+
+    return db.isOpen();
+}
+
+TranscriptDatabase& TranscriptManager::database() {
+
+    return db;
+}
+
+const TranscriptDatabase& TranscriptManager::database() const {
+
+    return db;
+}
+
+bool TranscriptManager::loadAllFromDatabase(QString* errorMessage) {
+
+    if (!db.isOpen()) {
+        if (errorMessage)
+            *errorMessage = QStringLiteral("No transcript database is open.");
+        return false;
+    }
+
+    QString listError;
+    const QStringList ids = db.transcriptIDs(&listError);
+    if (!listError.isEmpty()) {
+        if (errorMessage)
+            *errorMessage = listError;
+        return false;
+    }
+
+    // Like a reload from folders, this drops edits that were not saved
+    db.discardPendingChanges();
+    clear();
+
+    for (const QString& id : ids) {
+        Transcript transcript;
+        QString localError;
+        if (!db.loadTranscript(id, transcript, &localError)) {
+            // Record the first error but keep loading the others
+            if (errorMessage && errorMessage->isEmpty())
+                *errorMessage = localError;
+            continue;
+        }
+
+        appendTranscript(transcript);
+    }
+
+#ifdef QT_DEBUG
+    Q_ASSERT_X(checkIndexes(), "TranscriptManager", "lookup indexes out of sync");
+#endif
+    return true;
+}
+
+
+
+
+bool TranscriptManager::rescanRoot(RootChanges& outChanges, QString* errorMessage) {
+
+    outChanges = RootChanges();
+
+    // The database, not the folders, holds the transcripts then
+    if (db.isOpen())
+        return true;
+
+    QDir root(rootDir);
+    if (rootDir.isEmpty() || !root.exists()) {
+        if (errorMessage)
+            *errorMessage = QStringLiteral("Root directory does not exist: %1").arg(rootDir);
+        return false;
+    }
+
+    // What the root holds now
+    QHash<QString, quint64> current;
+
+    for (const QString& subName : root.entryList(QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name)) {
+        const QString folderPath = QDir(root.filePath(subName)).absolutePath();
+        if (QFileInfo::exists(QDir(folderPath).filePath(QStringLiteral("meta.json"))))
+            current.insert(folderPath, fingerprintOf(folderPath));
+    }
+
+    const QStringList bundleFiles = root.entryList({ QStringLiteral("*.%1").arg(QLatin1String(TranscriptBundle::Suffix)) },
+                                                   QDir::Files | QDir::Readable, QDir::Name);
+    for (const QString& fileName : bundleFiles) {
+        const QString bundlePath = root.absoluteFilePath(fileName);
+        current.insert(bundlePath, fingerprintOf(bundlePath));
+    }
+
+    // Compare with what is loaded from it
+    const QString rootPath = root.absolutePath();
+    QSet<QString> known;
+    QVector<int> toRemove;
+    QVector<int> toReload;
+
+    for (int i = 0; i < transcriptList.size(); ++i) {
+        const QString source = sourcePath(i);
+        if (source.isEmpty() || QFileInfo(source).absolutePath() != rootPath)
+            continue;
+
+        known.insert(source);
+
+        // A source that is gone fingerprints as 0
+        const bool gone = !current.contains(source);
+        const quint64 fingerprint = current.value(source);
+
+        if (sourceFingerprints.contains(source) && sourceFingerprints.value(source) == fingerprint)
+            continue;
+
+        if (transcriptList[i].isDirty()) {
+            // Reported once; the next save overwrites the change on disk
+            outChanges.conflicts << transcriptList[i].title;
+            sourceFingerprints.insert(source, fingerprint);
+            continue;
+        }
+
+        if (gone)
+            toRemove.push_back(i);
+        else
+            toReload.push_back(i);
+    }
+
+    // 1) Removals, from the back so the indices still to remove stay valid
+    for (int k = toRemove.size() - 1; k >= 0; --k) {
+        const int index = toRemove[k];
+        sourceFingerprints.remove(sourcePath(index));
+        outChanges.removedIDs << transcriptList[index].id;
+        outChanges.removed << index;
+        removeTranscriptAt(index);
+
+        for (int& r : toReload) {
+            if (r > index)
+                --r;
+        }
+    }
+
+    // 2) Reloads, in place. Read-only: writing meta.json would itself be a
+    //    change and trigger the next rescan
+    for (int index : toReload) {
+        const QString source = sourcePath(index);
+
+        Transcript transcript;
+        QString localError;
+        const bool ok = transcriptList[index].isBundle()
+                            ? readBundle(source, transcript, &localError)
+                            : readTranscriptFolder(source, false, transcript, &localError);
+        if (!ok) {
+            // E.g. still being written; the next rescan tries again
+            if (errorMessage && errorMessage->isEmpty())
+                *errorMessage = localError;
+            continue;
+        }
+
+        transcript.lastPlaybackPositionMs = transcriptList[index].lastPlaybackPositionMs;
+        transcriptList[index] = transcript;
+        evicted[index] = false;
+        lastUsed[index] = ++useClock;
+        compacted[index] = false;
+        sourceFingerprints.insert(source, fingerprintOf(source));
+        outChanges.reloaded << index;
+    }
+
+    if (!toReload.isEmpty())
+        rebuildIDIndex();
+
+    // 3) New folders and bundles, in name order
+    QStringList added = QStringList(current.keyBegin(), current.keyEnd());
+    added.sort();
+
+    for (const QString& source : added) {
+        if (known.contains(source))
+            continue;
+
+        Transcript transcript;
+        QString localError;
+        const bool ok = TranscriptBundle::isBundlePath(source)
+                            ? readBundle(source, transcript, &localError)
+                            : readTranscriptFolder(source, true, transcript, &localError);
+        if (!ok) {
+            if (errorMessage && errorMessage->isEmpty())
+                *errorMessage = localError;
+            continue;
+        }
+
+        // Taken after the import, which completes meta.json like loadAllFromRoot()
+        outChanges.added << appendTranscript(transcript);
+        sourceFingerprints.insert(source, fingerprintOf(source));
+    }
+
+#ifdef QT_DEBUG
+    Q_ASSERT_X(checkIndexes(), "TranscriptManager", "lookup indexes out of sync");
+#endif
+    return true;
+}
+
+void TranscriptManager::refreshFingerprint(int index) {
+
+    const QString source = sourcePath(index);
+    if (!source.isEmpty())
+        sourceFingerprints.insert(source, fingerprintOf(source));
+}
+
+QString TranscriptManager::sourcePath(int index) const {
+
+    const Transcript* t = transcriptAt(index);
+    if (!t)
+        return QString();
+
+    if (t->isBundle())
+        return t->bundlePath;
+
+    return t->folderPath.isEmpty() ? QString() : QDir(t->folderPath).absolutePath();
+}
 
 
 void TranscriptManager::clear() {
 
     transcriptList.clear();
+    indexByID.clear();
+    evicted.clear();
+    lastUsed.clear();
+    compacted.clear();
+    sourceFingerprints.clear();
 }
 
 int TranscriptManager::transcriptCount() const {
@@ -164,17 +496,368 @@ Transcript* TranscriptManager::transcriptAt(int index) {
 
     if (index < 0 || index >= transcriptList.size())
         return nullptr;
+
+    // The caller may expand or edit it
+    compacted[index] = false;
     return &transcriptList[index];
 }
 
 
 int TranscriptManager::indexOfTranscriptByID(const QString& id) const {
 
+    return indexByID.value(id, -1);
+}
+
+
+void TranscriptManager::setCompactStorage(bool enabled) {
+
+    compactInactiveText = enabled;
+    if (!enabled) {
+        for (Transcript& t : transcriptList)
+            t.expandText();
+        compacted.fill(false);
+    }
+}
+
+bool TranscriptManager::compactStorage() const {
+
+    return compactInactiveText;
+}
+
+void TranscriptManager::compactInactive(int activeIndex) {
+
+    if (!compactInactiveText)
+        return;
+
+    for (int i = 0; i < transcriptList.size(); ++i) {
+        if (i == activeIndex || compacted[i])
+            continue;
+
+        transcriptList[i].compactText();
+        compacted[i] = true;
+    }
+
+    // Expanded by the editor
+    if (activeIndex >= 0 && activeIndex < compacted.size())
+        compacted[activeIndex] = false;
+}
+
+void TranscriptManager::markTextDecoded(int index) {
+
+    if (index >= 0 && index < compacted.size())
+        compacted[index] = false;
+}
+
+qsizetype TranscriptManager::textMemoryBytes() const {
+
+    qsizetype bytes = 0;
+    for (const Transcript& t : transcriptList)
+        bytes += t.textMemoryBytes();
+    return bytes;
+}
+
+
+// === Memory budget ===
+
+void TranscriptManager::setMemoryBudget(qsizetype bytes) {
+
+    budgetBytes = qMax<qsizetype>(0, bytes);
+}
+
+qsizetype TranscriptManager::memoryBudget() const {
+
+    return budgetBytes;
+}
+
+void TranscriptManager::enforceMemoryBudget(int activeIndex) {
+
+    if (budgetBytes <= 0)
+        return;
+
+    qsizetype total = residentBytes();
+    if (total <= budgetBytes)
+        return;
+
+    // Least recently used first
+    QVector<int> candidates;
+    for (int i = 0; i < transcriptList.size(); ++i) {
+        if (i != activeIndex && !evicted[i] && !transcriptList[i].isDirty())
+            candidates.push_back(i);
+    }
+    std::sort(candidates.begin(), candidates.end(),
+              [this](int a, int b) { return lastUsed[a] < lastUsed[b]; });
+
+    for (int i : candidates) {
+        if (total <= budgetBytes)
+            break;
+
+        const Transcript& t = transcriptList[i];
+        total -= residentBytes(i);
+
+        // Only what is needed to list, load and save it again
+        Transcript stub;
+        stub.id = t.id;
+        stub.title = t.title;
+        stub.folderPath = t.folderPath;
+        stub.referencePath = t.referencePath;
+        stub.editablePath = t.editablePath;
+        stub.audioPath = t.audioPath;
+        stub.bundlePath = t.bundlePath;
+        stub.setSpeakers(t.speakers);
+        stub.dateImported = t.dateImported;
+        stub.lastEdited = t.lastEdited;
+        stub.lastPlaybackPositionMs = t.lastPlaybackPositionMs;
+
+        transcriptList[i] = stub;
+        evicted[i] = true;
+        total += residentBytes(i);
+    }
+}
+
+bool TranscriptManager::isResident(int index) const {
+
+    return index >= 0 && index < transcriptList.size() && !evicted[index];
+}
+
+bool TranscriptManager::ensureResident(int index, QString* errorMessage) {
+
+    if (index < 0 || index >= transcriptList.size()) {
+        if (errorMessage)
+            *errorMessage = QStringLiteral("Invalid transcript index: %1").arg(index);
+        return false;
+    }
+
+    lastUsed[index] = ++useClock;
+
+    if (!evicted[index])
+        return true;
+
+    Transcript transcript;
+    if (!reload(transcriptList[index], transcript, errorMessage))
+        return false;
+
+    // Runtime state that no file holds
+    transcript.lastPlaybackPositionMs = transcriptList[index].lastPlaybackPositionMs;
+
+    transcriptList[index] = transcript;
+    evicted[index] = false;
+
+    if (compactInactiveText)
+        transcriptList[index].compactText();
+    compacted[index] = compactInactiveText;
+    return true;
+}
+
+qsizetype TranscriptManager::residentBytes(int index) const {
+
+    const Transcript* t = transcriptAt(index);
+    if (!t)
+        return 0;
+
+    qsizetype bytes = qsizetype(sizeof(Transcript))
+                      + t->speakers.size() * qsizetype(sizeof(Model::Data::Speaker));
+
+    if (!evicted[index])
+        bytes += t->segments.size() * qsizetype(sizeof(Model::Data::Segment)) + t->textMemoryBytes();
+    return bytes;
+}
+
+qsizetype TranscriptManager::residentBytes() const {
+
+    qsizetype bytes = 0;
+    for (int i = 0; i < transcriptList.size(); ++i)
+        bytes += residentBytes(i);
+    return bytes;
+}
+
+#ifdef QT_DEBUG
+bool TranscriptManager::checkIndexes() const {
+
+    QHash<QString, int> expected;
+    for (int i = 0; i < transcriptList.size(); ++i) {
+        if (!transcriptList[i].checkSpeakerIndex())
+            return false;
+        if (!expected.contains(transcriptList[i].id))
+            expected.insert(transcriptList[i].id, i);
+    }
+    return expected == indexByID;
+}
+#endif
+
+
+// === Private helpers ===
+
+int TranscriptManager::appendTranscript(const Transcript& transcript) {
+
+    transcriptList.push_back(transcript);
+    evicted.push_back(false);
+    lastUsed.push_back(++useClock);
+    compacted.push_back(false);
+    const int index = transcriptList.size() - 1;
+
+    if (!indexByID.contains(transcript.id))
+        indexByID.insert(transcript.id, index);
+
+    return index;
+}
+
+void TranscriptManager::removeTranscriptAt(int index) {
+
+    transcriptList.removeAt(index);
+    evicted.removeAt(index);
+    lastUsed.removeAt(index);
+    compacted.removeAt(index);
+    rebuildIDIndex();
+}
+
+void TranscriptManager::rebuildIDIndex() {
+
+    indexByID.clear();
     for (int i = 0; i < transcriptList.size(); ++i) {
-        if (transcriptList[i].id == id)
-            return i;
+        if (!indexByID.contains(transcriptList[i].id))
+            indexByID.insert(transcriptList[i].id, i);
+    }
+}
+
+bool TranscriptManager::readTranscriptFolder(const QString& folderPath,
+                                             bool updateMetadata,
+                                             Transcript& outTranscript,
+                                             QString* errorMessage) {
+    const QString metaPath = QDir(folderPath).filePath(QStringLiteral("meta.json"));
+
+    if (!QFileInfo::exists(metaPath))
+        return false; // Not a transcript folder (no meta.json), skip.
+
+    // Load meta.json to get speaker list
+    QFile metaFile(metaPath);
+    if (!metaFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        if (errorMessage)
+            *errorMessage = QStringLiteral("Cannot open meta.json: %1").arg(metaPath);
+        return false;
     }
-    return -1;
+
+    const QByteArray rawMeta = metaFile.readAll();
+    QJsonParseError parseErr;
+    QJsonDocument doc = QJsonDocument::fromJson(rawMeta, &parseErr);
+    if (parseErr.error != QJsonParseError::NoError || !doc.isObject()) {
+        if (errorMessage)
+            *errorMessage = QStringLiteral("Error parsing meta.json at %1: %2")
+                                .arg(metaPath, parseErr.errorString());
+        return false;
+    }
+
+    QJsonObject metaObj = doc.object();
+    QJsonArray speakersArray = metaObj.value(QStringLiteral("speakers")).toArray();
+
+    QStringList speakerNames;
+    for (const QJsonValue& v : speakersArray) {
+        if (v.isString())
+            speakerNames << v.toString().trimmed();
+    }
+
+    // If no speakers in meta, we skip this transcript
+    if (speakerNames.isEmpty())
+        return false;
+
+    // Use TranscriptImporter to fully import and parse this transcript
+    QString localError;
+    const bool ok = updateMetadata
+                        ? importer.importFromFolder(folderPath, speakerNames, outTranscript, &localError)
+                        : importer.loadFromFolder(folderPath, speakerNames, outTranscript, &localError);
+    if (!ok) {
+        if (errorMessage)
+            *errorMessage = QStringLiteral("Failed to import %1: %2").arg(folderPath, localError);
+        return false;
+    }
+
+    return true;
+}
+
+quint64 TranscriptManager::fingerprintOf(const QString& path) {
+
+    const QFileInfo info(path);
+    ContentHash hash;
+
+    auto addFile = [&hash](const QFileInfo& file) {
+        const qint64 stamp[2] = { file.size(), file.lastModified().toMSecsSinceEpoch() };
+        hash.addData(file.fileName().toUtf8());
+        hash.addData(reinterpret_cast<const char*>(stamp), sizeof(stamp));
+    };
+
+    if (!info.isDir()) {
+        if (info.exists())
+            addFile(info);
+        return hash.result();
+    }
+
+    // Hidden files (the edit log) change on every edit and are not content
+    const QFileInfoList files = QDir(path).entryInfoList(QDir::Files, QDir::Name);
+    for (const QFileInfo& file : files) {
+        if (!file.fileName().startsWith(QLatin1Char('.')))
+            addFile(file);
+    }
+
+    return hash.result();
+}
+
+bool TranscriptManager::reload(const Transcript& evictedTranscript,
+                               Transcript& outTranscript,
+                               QString* errorMessage) {
+    if (evictedTranscript.isBundle())
+        return readBundle(evictedTranscript.bundlePath, outTranscript, errorMessage);
+
+    if (db.isOpen() && db.contains(evictedTranscript.id))
+        return db.loadTranscript(evictedTranscript.id, outTranscript, errorMessage);
+
+    Transcript transcript;
+    // Read-only: selecting a transcript must not touch its files or lastEdited
+    if (!readTranscriptFolder(evictedTranscript.folderPath, false, transcript, errorMessage)) {
+        if (errorMessage && errorMessage->isEmpty())
+            *errorMessage = QStringLiteral("Not a transcript folder any more: %1").arg(evictedTranscript.folderPath);
+        return false;
+    }
+
+    // Saved edits may still be in the log, past the last compaction
+    EditLog::ReplayResult result;
+    if (!EditLog::replay(transcript, &result, errorMessage))
+        return false;
+
+    if (result.uncommitted > 0)
+        transcript.markModified();
+
+    outTranscript = transcript;
+    return true;
+}
+
+bool TranscriptManager::readBundle(const QString& bundlePath,
+                                   Transcript& outTranscript,
+                                   QString* errorMessage) const {
+    TranscriptBundle bundle;
+    if (!bundle.open(bundlePath, errorMessage))
+        return false;
+
+    Transcript transcript;
+    if (!bundle.readTranscript(transcript, errorMessage))
+        return false;
+
+    if (bundle.hasAudio()) {
+        const QString audioPath = bundleAudioPath(transcript.id, bundle.audioFileName());
+
+        // Extracted once; a bundle rewritten since gets a fresh copy
+        const QFileInfo audioInfo(audioPath);
+        const bool upToDate = audioInfo.exists()
+                              && audioInfo.lastModified() >= QFileInfo(bundlePath).lastModified();
+
+        QString audioError;
+        if (upToDate
+            || (QDir().mkpath(audioInfo.absolutePath()) && bundle.extractAudio(audioPath, &audioError)))
+            transcript.audioPath = audioPath;
+        else if (errorMessage)
+            *errorMessage = audioError;   // Text is still usable without audio
+    }
+
+    outTranscript = transcript;
+    return true;
 }
 
 
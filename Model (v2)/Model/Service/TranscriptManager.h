@@ -2,8 +2,10 @@
 #define MODEL_SERVICE_TRANSCRIPT_MANAGER_H
 
 #include "Model/Data/Transcript.h"
+#include "Model/Service/TranscriptDatabase.h"
 #include "Model/Service/TranscriptImporter.h"
 
+#include <QHash>
 #include <QString>
 #include <QStringList>
 #include <QVector>
@@ -20,6 +22,10 @@ namespace Service {
  *  - Know the root directory that contains transcript folders
  *  - Load transcripts from the root directory (via meta.json + TranscriptImporter)
  *  - Import new transcripts from arbitrary folders
+ *  - Load and save single-file bundles (see TranscriptBundle)
+ *  - Optionally keep the corpus in a SQLite database (see TranscriptDatabase)
+ *  - Keep the parsed transcripts within a memory budget (see enforceMemoryBudget())
+ *  - Pick up transcripts added, removed or changed in the root directory (see rescanRoot())
  *
  * It does NOT perform editing, searching, or audio playback. Those are handled by
  * other Model::Service classes and the Controller layer.
@@ -29,6 +35,17 @@ class TranscriptManager {
 
 public:
 
+    /** @brief What rescanRoot() changed, in the order it was applied. */
+    struct RootChanges {
+        QVector<int> removed;       // Former indices, descending
+        QVector<int> reloaded;      // Indices after the removals
+        QVector<int> added;         // Indices of the appended transcripts
+        QStringList removedIDs;     // IDs of the removed transcripts
+        QStringList conflicts;      // Titles changed or deleted on disk while they have unsaved edits
+
+        bool isEmpty() const { return removed.isEmpty() && reloaded.isEmpty() && added.isEmpty(); }
+    };
+
     /** @brief Constructs a manager with an optional root directory. */
     explicit TranscriptManager(const QString& dir = QString());
 
@@ -45,7 +62,8 @@ public:
      *
      * The manager scans each subfolder of the root directory that contains a
      * meta.json with a "speakers" array, then uses TranscriptImporter to fully
-     * import and parse the transcript.
+     * import and parse the transcript. Bundle files (*.tbundle) in the root
+     * directory are loaded as well.
      */
     bool loadAllFromRoot(QString* errorMessage = nullptr);
 
@@ -64,6 +82,92 @@ public:
                                     QString* errorMessage = nullptr);
 
 
+    /**
+     * @brief Loads a single-file bundle and adds it to the collection.
+     *
+     * Bundled audio is extracted once to the application cache, where the
+     * media player can open it (see bundleAudioPath()).
+     */
+    bool importTranscriptFromBundle(const QString& bundlePath,
+                                    int* outIndex = nullptr,
+                                    QString* errorMessage = nullptr);
+
+    /**
+     * @brief Writes the transcript at index to a bundle file.
+     *
+     * Works for folder and bundle transcripts alike; the transcript itself
+     * is not changed. With includeAudio, its audio file is stored too.
+     */
+    bool saveBundle(int index,
+                    const QString& bundlePath,
+                    bool includeAudio,
+                    QString* errorMessage = nullptr) const;
+
+    /** @brief Returns where the audio of a bundled transcript is extracted to. */
+    static QString bundleAudioPath(const QString& transcriptID, const QString& audioFileName);
+
+    /**
+     * @brief Writes the transcript at index as a transcript folder.
+     *
+     * Creates folderPath if needed and writes editable.txt, transcript.txt and
+     * meta.json, plus a copy of the audio file. The result can be imported
+     * again with importTranscriptFromFolder(). The transcript itself is not
+     * changed.
+     */
+    bool exportTranscriptToFolder(int index,
+                                  const QString& folderPath,
+                                  QString* errorMessage = nullptr) const;
+
+
+    // === Database storage ===
+
+    /**
+     * @brief Switches to the SQLite database at path (created if missing).
+     *
+     * Loaded transcripts the database does not hold yet are stored into it;
+     * for the others, the stored version is kept. Call loadAllFromDatabase()
+     * afterwards. While a database is open, it is where transcripts are
+     * saved, and folder imports are stored into it. Bundles stay files.
+     */
+    bool openDatabase(const QString& path, QString* errorMessage = nullptr);
+
+    /** @brief Flushes and closes the database; transcripts stay loaded. */
+    void closeDatabase();
+
+    /** @brief Returns true if a database is open. */
+    bool hasDatabase() const;
+
+    /** @brief Returns the database (closed unless openDatabase() succeeded). */
+    TranscriptDatabase& database();
+    const TranscriptDatabase& database() const;
+
+    /** @brief Replaces the loaded transcripts with those stored in the database. */
+    bool loadAllFromDatabase(QString* errorMessage = nullptr);
+
+
+    /**
+     * @brief Applies the changes made in the root directory since it was loaded.
+     *
+     * Compares a fingerprint (names, sizes and modification times of the
+     * files) of every transcript folder and bundle in the root directory
+     * with the one taken when it was loaded. Transcripts whose source is
+     * gone are removed, changed ones are loaded again, and new ones are
+     * appended; all others stay as they are, at their relative order.
+     *
+     * A transcript with unsaved edits is never removed or reloaded: it is
+     * listed in RootChanges::conflicts instead, once per change. Transcripts
+     * imported from outside the root directory are left alone. Does nothing
+     * while a database is open.
+     */
+    bool rescanRoot(RootChanges& outChanges, QString* errorMessage = nullptr);
+
+    /** @brief Records the current files of the transcript at index as its loaded state (e.g. after a save). */
+    void refreshFingerprint(int index);
+
+    /** @brief Returns the folder or bundle file the transcript at index was loaded from. */
+    QString sourcePath(int index) const;
+
+
     /** @brief Clears all loaded transcripts from memory. */
     void clear();
 
@@ -81,14 +185,138 @@ public:
     Model::Data::Transcript* transcriptAt(int index);
 
 
-    /** @brief Finds the index of a transcript by its ID, or -1 if not found. */
+    /** @brief Finds the index of a transcript by its ID, or -1 if not found (O(1)). */
     int indexOfTranscriptByID(const QString& id) const;
 
+
+    /** @brief Enables or disables compact text storage for inactive transcripts (default: on). */
+    void setCompactStorage(bool enabled);
+
+    /** @brief Returns true if inactive transcripts are kept in compact storage. */
+    bool compactStorage() const;
+
+    /**
+     * @brief Compacts the text of every transcript except the one at activeIndex.
+     *
+     * The active transcript is left as it is: it is the one being shown and
+     * edited, which works on QString text. Transcripts already compacted and
+     * not handed out for modification since are skipped. Does nothing if
+     * compact storage is disabled.
+     */
+    void compactInactive(int activeIndex);
+
+    /**
+     * @brief Records that the text of the transcript at index was read.
+     *
+     * Reading a compact segment leaves a decoded copy behind; the next
+     * compactInactive() drops it again.
+     */
+    void markTextDecoded(int index);
+
+    /** @brief Returns the approximate heap size of all loaded segment texts. */
+    qsizetype textMemoryBytes() const;
+
+
+    // === Memory budget ===
+
+    /** @brief Default for setMemoryBudget(). */
+    static constexpr qsizetype DefaultMemoryBudget = 256 * 1024 * 1024;
+
+    /** @brief Sets how many bytes the resident transcripts may use (0: no limit). */
+    void setMemoryBudget(qsizetype bytes);
+
+    /** @brief Returns the memory budget in bytes (0: no limit). */
+    qsizetype memoryBudget() const;
+
+    /**
+     * @brief Evicts least recently used transcripts until the budget is met.
+     *
+     * An evicted transcript keeps its metadata (ID, title, paths, speakers)
+     * but drops its segments; ensureResident() loads it again. The
+     * transcript at activeIndex and transcripts with unsaved edits are
+     * pinned: they are never evicted, even if the budget stays exceeded.
+     */
+    void enforceMemoryBudget(int activeIndex);
+
+    /** @brief Returns false if the transcript at index was evicted. */
+    bool isResident(int index) const;
+
+    /**
+     * @brief Makes the transcript at index resident and marks it as used.
+     *
+     * An evicted transcript is loaded again from where it came from: its
+     * bundle, the database, or its folder (text file plus edit log).
+     */
+    bool ensureResident(int index, QString* errorMessage = nullptr);
+
+    /** @brief Returns the approximate memory held by the transcript at index. */
+    qsizetype residentBytes(int index) const;
+
+    /** @brief Returns the approximate memory held by all resident transcripts. */
+    qsizetype residentBytes() const;
+
+#ifdef QT_DEBUG
+    /**
+     * @brief Returns true if all lookup indexes match their vectors (debug only).
+     *
+     * Checks the transcript ID index and the speaker index of every transcript.
+     */
+    bool checkIndexes() const;
+#endif
+
 private:
 
+    /** @brief Appends a transcript and indexes its ID. Returns its index. */
+    int appendTranscript(const Model::Data::Transcript& transcript);
+
+    /** @brief Removes the transcript at index and re-indexes the ones after it. */
+    void removeTranscriptAt(int index);
+
+    /** @brief Rebuilds indexByID from transcriptList (first entry wins on duplicates). */
+    void rebuildIDIndex();
+
+    /**
+     * @brief Reads the transcript folder at folderPath (meta.json speakers + TranscriptImporter).
+     *
+     * Returns false with an empty errorMessage if the folder is not a
+     * transcript folder (no meta.json or no speakers in it). Without
+     * updateMetadata, nothing is written (see TranscriptImporter::loadFromFolder()).
+     */
+    bool readTranscriptFolder(const QString& folderPath,
+                              bool updateMetadata,
+                              Model::Data::Transcript& outTranscript,
+                              QString* errorMessage);
+
+    /** @brief Returns a hash of the names, sizes and modification times of the files at path. */
+    static quint64 fingerprintOf(const QString& path);
+
+    /** @brief Loads the segments of an evicted transcript again (see ensureResident()). */
+    bool reload(const Model::Data::Transcript& evicted,
+                Model::Data::Transcript& outTranscript,
+                QString* errorMessage);
+
+    /** @brief Reads the bundle at bundlePath, extracting its audio if needed. */
+    bool readBundle(const QString& bundlePath,
+                    Model::Data::Transcript& outTranscript,
+                    QString* errorMessage) const;
+
     QString rootDir;
     QVector<Model::Data::Transcript> transcriptList;
+    QHash<QString, int> indexByID;   // Transcript ID -> index in transcriptList
     TranscriptImporter importer;
+    TranscriptDatabase db;
+    bool compactInactiveText = true;
+
+    // Parallel to transcriptList
+    QVector<bool> evicted;
+    QVector<quint64> lastUsed;     // useClock value of the last use
+    QVector<bool> compacted;       // Compact, with no decoded copy or edit since
+
+    quint64 useClock = 0;
+    qsizetype budgetBytes = DefaultMemoryBudget;
+
+    // Source path (see sourcePath()) -> fingerprintOf() when last loaded or saved
+    QHash<QString, quint64> sourceFingerprints;
 
 };
 
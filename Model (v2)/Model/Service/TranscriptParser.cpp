@@ -16,22 +16,24 @@ bool TranscriptParser::parse(const QString& rawText,
                              const QStringList& knownSpeakers) const
 {
     outTranscript.segments.clear();
-    outTranscript.speakers.clear();
+    outTranscript.setSpeakers({});
 
     if (knownSpeakers.isEmpty())
         return false;
 
-    QVector<Segment> parsedSegments = parseSegments(rawText, knownSpeakers);
-    if (parsedSegments.isEmpty())
-        return false;
-
-    // Register speakers in the transcript
+    // Register speakers first so their handles follow knownSpeakers order
     for (const QString& sp : knownSpeakers)
         outTranscript.addSpeakerIfMissing(sp);
 
+    QVector<Segment> parsedSegments = parseSegments(rawText, knownSpeakers, outTranscript);
+    if (parsedSegments.isEmpty()) {
+        outTranscript.setSpeakers({});
+        return false;
+    }
+
     // Add segments
-    for (const Segment& s : parsedSegments)
-        outTranscript.addSegment(s);
+    for (Segment& s : parsedSegments)
+        outTranscript.addSegment(std::move(s));
 
     // Optional cleanup: merge consecutive segments that have the same speaker
     outTranscript.mergeAdjacentSameSpeaker();
@@ -147,7 +149,8 @@ TranscriptParser::splitInlineLabels(const QString& text,
 
 
 QVector<Segment> TranscriptParser::parseSegments(const QString& rawText,
-                                                 const QStringList& knownSpeakers) const {
+                                                 const QStringList& knownSpeakers,
+                                                 Transcript& outTranscript) const {
 
     QVector<Segment> segments;
 
@@ -159,7 +162,7 @@ QVector<Segment> TranscriptParser::parseSegments(const QString& rawText,
     auto flushSegment = [&](QVector<Segment>& list) {
         QString norm = normalizeText(currentText);
         if (!currentSpeaker.isEmpty() && !norm.isEmpty()) {
-            list.append(Segment(currentSpeaker, norm));
+            list.append(Segment(outTranscript.internSpeaker(currentSpeaker), norm));
         }
         currentText.clear();
     };
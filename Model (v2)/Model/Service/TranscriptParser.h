@@ -71,9 +71,12 @@ private:
      *  - Walks line by line
      *  - Handles speaker lines and continuation lines
      *  - Uses splitInlineLabels() to handle multiple speakers in a single line
+     *
+     * Speaker handles of the returned segments are interned in outTranscript.
      */
     QVector<Model::Data::Segment> parseSegments(const QString& rawText,
-                                                const QStringList& knownSpeakers) const;
+                                                const QStringList& knownSpeakers,
+                                                Model::Data::Transcript& outTranscript) const;
 
 
     /**
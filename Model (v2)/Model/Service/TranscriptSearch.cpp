@@ -5,6 +5,7 @@ namespace Service {
 
 using Model::Data::Transcript;
 using Model::Data::Segment;
+using Model::Data::SegmentStore;
 
 TranscriptSearch::TranscriptSearch(const Transcript& transcript)
     : searchTranscript(transcript)
@@ -15,6 +16,32 @@ const Transcript& TranscriptSearch::transcript() const {
     return searchTranscript;
 }
 
+void TranscriptSearch::setAccentInsensitive(bool enabled) {
+
+    searchAccentInsensitive = enabled;
+}
+
+bool TranscriptSearch::isAccentInsensitive() const {
+
+    return searchAccentInsensitive;
+}
+
+void TranscriptSearch::setSegmentStore(const SegmentStore* store) {
+
+    searchStore = store;
+}
+
+const QString& TranscriptSearch::shadowText(const Segment& segment,
+                                            TextFolding::Options options) {
+
+    const int key = static_cast<int>(options);
+    if (segment.foldedOptions != key) {
+        segment.foldedText = TextFolding::fold(segment.text(), options);
+        segment.foldedOptions = key;
+    }
+    return segment.foldedText;
+}
+
 QVector<int> TranscriptSearch::findSegmentsContaining(const QString& pattern,
                                                       Qt::CaseSensitivity cs) const {
 
@@ -23,10 +50,20 @@ QVector<int> TranscriptSearch::findSegmentsContaining(const QString& pattern,
     if (pattern.isEmpty())
         return result;
 
+    const TextMatcher matcher(pattern, cs, searchAccentInsensitive);
+
+    // Contiguous arena scan when available
+    if (const SegmentStore* store = storeFor(matcher)) {
+        for (int i = 0; i < store->size(); ++i) {
+            if (matcher.matches(store->textAt(i)))
+                result.push_back(i);
+        }
+        return result;
+    }
+
     const auto& segments = searchTranscript.segments;
     for (int i = 0; i < segments.size(); ++i) {
-        const QString& text = segments[i].text;
-        if (text.contains(pattern, cs)) {
+        if (matcher.matches(segments[i])) {
             result.push_back(i);
         }
     }
@@ -49,9 +86,10 @@ int TranscriptSearch::findNext(const QString& pattern,
     if (ind < 0)
         ind = 0;
 
+    const TextMatcher matcher(pattern, cs, searchAccentInsensitive);
+
     for (int i = ind; i < segments.size(); ++i) {
-        const QString& text = segments[i].text;
-        if (text.contains(pattern, cs)) {
+        if (matcher.matches(segments[i])) {
             return i;
         }
     }
@@ -66,9 +104,13 @@ QVector<int> TranscriptSearch::findBySpeaker(const QString& speakerID) const {
     if (speakerID.isEmpty())
         return result;
 
+    const int handle = searchTranscript.findSpeakerIndex(speakerID);
+    if (handle < 0)
+        return result;
+
     const auto& segments = searchTranscript.segments;
     for (int i = 0; i < segments.size(); ++i) {
-        if (segments[i].speakerID == speakerID) {
+        if (segments[i].speaker == handle) {
             result.push_back(i);
         }
     }
@@ -84,16 +126,21 @@ QVector<int> TranscriptSearch::findBySpeakerAndText(const QString& speakerID,
 
     const bool filterBySpeaker = !speakerID.isEmpty();
     const bool filterByText    = !pattern.isEmpty();
+    const TextMatcher matcher(pattern, cs, searchAccentInsensitive);
+
+    const int handle = searchTranscript.findSpeakerIndex(speakerID);
+    if (filterBySpeaker && handle < 0)
+        return result;
 
     const auto& segments = searchTranscript.segments;
     for (int i = 0; i < segments.size(); ++i) {
         const Segment& seg = segments[i];
 
-        if (filterBySpeaker && seg.speakerID != speakerID)
+        if (filterBySpeaker && seg.speaker != handle)
             continue;
 
         if (filterByText) {
-            if (!seg.text.contains(pattern, cs))
+            if (!matcher.matches(seg))
                 continue;
         }
 
@@ -110,19 +157,32 @@ QVector<int> TranscriptSearch::findBySpeakersAndText(const QStringList& speakerI
 
     QVector<int> result;
 
-    const bool filterBySpeakers = !speakerIDs.isEmpty();
+    const SpeakerFilter speakerFilter(searchTranscript, speakerIDs);
+    const bool filterBySpeakers = !speakerFilter.isEmpty();
     const bool filterByText = !pattern.isEmpty();
+    const TextMatcher matcher(pattern, cs, searchAccentInsensitive);
+
+    if (const SegmentStore* store = storeFor(matcher)) {
+        for (int i = 0; i < store->size(); ++i) {
+            if (filterBySpeakers && !speakerFilter.accepts(store->speakerAt(i)))
+                continue;
+            if (filterByText && !matcher.matches(store->textAt(i)))
+                continue;
+            result.push_back(i);
+        }
+        return result;
+    }
 
     const auto& segments = searchTranscript.segments;
     for (int i = 0; i < segments.size(); ++i) {
         const Segment& seg = segments[i];
 
-        if (filterBySpeakers && !speakerIDs.contains(seg.speakerID)) {
+        if (filterBySpeakers && !speakerFilter.accepts(seg)) {
             continue;
         }
 
         if (filterByText) {
-            if (!seg.text.contains(pattern, cs))
+            if (!matcher.matches(seg))
                 continue;
         }
 
@@ -132,5 +192,247 @@ QVector<int> TranscriptSearch::findBySpeakersAndText(const QStringList& speakerI
     return result;
 }
 
+TranscriptSearch::MatchIterator TranscriptSearch::matches(const QString& pattern,
+                                                          const QStringList& speakerIDs,
+                                                          Qt::CaseSensitivity cs,
+                                                          bool wrapAround) const {
+
+    return MatchIterator(searchTranscript,
+                         TextMatcher(pattern, cs, searchAccentInsensitive),
+                         SpeakerFilter(searchTranscript, speakerIDs),
+                         wrapAround);
+}
+
+
+const SegmentStore* TranscriptSearch::storeFor(const TextMatcher& matcher) const {
+
+    if (!searchStore || !searchStore->isInSyncWith(searchTranscript))
+        return nullptr;
+    return matcher.supportsViews() ? searchStore : nullptr;
+}
+
+
+// === SpeakerFilter ===
+
+TranscriptSearch::SpeakerFilter::SpeakerFilter(const Transcript& transcript,
+                                               const QStringList& speakerIDs)
+    : active(!speakerIDs.isEmpty()),
+    speakerMask(transcript.speakers.size())
+{
+    for (const QString& id : speakerIDs) {
+        const int handle = transcript.findSpeakerIndex(id);
+        if (handle >= 0)
+            speakerMask.setBit(handle);
+    }
+}
+
+bool TranscriptSearch::SpeakerFilter::isEmpty() const {
+
+    return !active;
+}
+
+bool TranscriptSearch::SpeakerFilter::accepts(int speakerHandle) const {
+
+    if (!active)
+        return true;
+    return speakerHandle >= 0 && speakerHandle < speakerMask.size()
+           && speakerMask.testBit(speakerHandle);
+}
+
+bool TranscriptSearch::SpeakerFilter::accepts(const Segment& segment) const {
+
+    return accepts(segment.speaker);
+}
+
+
+// === TextMatcher ===
+
+TranscriptSearch::TextMatcher::TextMatcher(const QString& pattern,
+                                           Qt::CaseSensitivity cs,
+                                           bool accentInsensitive,
+                                           bool useShadowCache)
+    : rawPattern(pattern),
+    caseSensitivity(cs),
+    foldOptions(TextFolding::optionsFor(cs, accentInsensitive)),
+    useCache(useShadowCache)
+{
+    foldedPattern = TextFolding::fold(rawPattern, foldOptions);
+
+    patternIsLatin1 = true;
+    patternIsAscii = true;
+    for (const QChar c : rawPattern) {
+        if (c.unicode() > 0x7f)
+            patternIsAscii = false;
+        if (c.unicode() > 0xff)
+            patternIsLatin1 = false;
+    }
+
+    if (patternIsLatin1)
+        latin1Pattern = rawPattern.toLatin1();
+    utf8Pattern = rawPattern.toUtf8();
+}
+
+bool TranscriptSearch::TextMatcher::isEmpty() const {
+
+    return rawPattern.isEmpty();
+}
+
+bool TranscriptSearch::TextMatcher::matches(const Segment& segment) const {
+
+    if (rawPattern.isEmpty())
+        return true;
+
+    bool compactMatch = false;
+    if (segment.storage() != Segment::Storage::Utf16 && matchesCompact(segment, compactMatch))
+        return compactMatch;
+
+    if (!foldOptions)
+        return segment.text().contains(rawPattern, Qt::CaseSensitive);
+
+    if (useCache)
+        return shadowText(segment, foldOptions).contains(foldedPattern, Qt::CaseSensitive);
+
+    // No shared cache: plain case folding is cheaper through Qt directly
+    if (foldOptions == TextFolding::Options(TextFolding::CaseFold))
+        return segment.text().contains(rawPattern, caseSensitivity);
+
+    return TextFolding::fold(segment.text(), foldOptions).contains(foldedPattern, Qt::CaseSensitive);
+}
+
+bool TranscriptSearch::TextMatcher::matchesCompact(const Segment& segment, bool& outMatches) const {
+
+    const QByteArray& bytes = segment.compactBytes();
+
+    if (segment.storage() == Segment::Storage::Latin1) {
+        if (!foldOptions) {
+            outMatches = patternIsLatin1
+                         && QLatin1String(bytes).contains(QLatin1String(latin1Pattern), Qt::CaseSensitive);
+            return true;
+        }
+
+        // Latin-1 characters never case-fold onto ASCII ones, so an ASCII
+        // pattern compares exactly
+        if (foldOptions == TextFolding::Options(TextFolding::CaseFold) && patternIsAscii) {
+            outMatches = QLatin1String(bytes).contains(QLatin1String(latin1Pattern), Qt::CaseInsensitive);
+            return true;
+        }
+
+        return false;
+    }
+
+    // UTF-8 substrings line up with UTF-16 ones, but only without folding
+    if (!foldOptions) {
+        outMatches = bytes.contains(utf8Pattern);
+        return true;
+    }
+
+    return false;
+}
+
+bool TranscriptSearch::TextMatcher::supportsViews() const {
+
+    return !foldOptions || foldOptions == TextFolding::Options(TextFolding::CaseFold);
+}
+
+bool TranscriptSearch::TextMatcher::matches(QStringView text) const {
+
+    if (rawPattern.isEmpty())
+        return true;
+
+    if (supportsViews())
+        return text.contains(rawPattern, caseSensitivity);
+
+    return TextFolding::fold(text.toString(), foldOptions).contains(foldedPattern, Qt::CaseSensitive);
+}
+
+
+// === MatchIterator ===
+
+TranscriptSearch::MatchIterator::MatchIterator(const Transcript& transcript,
+                                               const TextMatcher& matcher,
+                                               const SpeakerFilter& speakerFilter,
+                                               bool wrapAround)
+    : iterTranscript(transcript),
+    iterMatcher(matcher),
+    iterFilter(speakerFilter),
+    iterWrapAround(wrapAround),
+    iterPosition(-1)
+{}
+
+void TranscriptSearch::MatchIterator::seek(int index) {
+
+    iterPosition = index;
+}
+
+int TranscriptSearch::MatchIterator::position() const {
+
+    return iterPosition;
+}
+
+int TranscriptSearch::MatchIterator::next() {
+
+    const int count = iterTranscript.segments.size();
+    if (count == 0)
+        return -1;
+
+    const int start = qBound(-1, iterPosition, count - 1);
+
+    for (int i = start + 1; i < count; ++i) {
+        if (matchesAt(i)) {
+            iterPosition = i;
+            return i;
+        }
+    }
+
+    if (iterWrapAround) {
+        // Include the start itself so a single match is found again
+        for (int i = 0; i <= start; ++i) {
+            if (matchesAt(i)) {
+                iterPosition = i;
+                return i;
+            }
+        }
+    }
+
+    return -1;
+}
+
+int TranscriptSearch::MatchIterator::previous() {
+
+    const int count = iterTranscript.segments.size();
+    if (count == 0)
+        return -1;
+
+    const int start = qBound(0, iterPosition, count);
+
+    for (int i = start - 1; i >= 0; --i) {
+        if (matchesAt(i)) {
+            iterPosition = i;
+            return i;
+        }
+    }
+
+    if (iterWrapAround) {
+        for (int i = count - 1; i >= start; --i) {
+            if (matchesAt(i)) {
+                iterPosition = i;
+                return i;
+            }
+        }
+    }
+
+    return -1;
+}
+
+bool TranscriptSearch::MatchIterator::matchesAt(int index) const {
+
+    const Segment& seg = iterTranscript.segments[index];
+
+    if (!iterFilter.accepts(seg))
+        return false;
+
+    return iterMatcher.matches(seg);
+}
+
 }
 }
@@ -2,9 +2,14 @@
 #define MODEL_SERVICE_TRANSCRIPT_SEARCH_H
 
 #include "Model/Data/Transcript.h"
+#include "Model/Data/SegmentStore.h"
+#include "Model/Service/TextFolding.h"
 
+#include <QBitArray>
+#include <QByteArray>
 #include <QString>
 #include <QStringList>
+#include <QStringView>
 #include <QVector>
 
 namespace Model {
@@ -22,12 +27,179 @@ class TranscriptSearch {
 
 public:
 
+    /**
+     * @brief Speaker filter precomputed once per query.
+     *
+     * Speaker IDs are resolved to handles once, so checking a segment is a
+     * single bit test on Segment::speaker. An empty filter accepts every
+     * speaker. The filter must be rebuilt when speakers are added or removed.
+     */
+    class SpeakerFilter {
+
+    public:
+
+        /** @brief Constructs an empty filter that accepts every speaker. */
+        SpeakerFilter() = default;
+
+        /**
+         * @brief Constructs a filter accepting only the given speaker IDs.
+         *
+         * IDs unknown to transcript are ignored; if none is known, the
+         * filter rejects every segment.
+         */
+        SpeakerFilter(const Model::Data::Transcript& transcript, const QStringList& speakerIDs);
+
+        /** @brief Returns true if the filter accepts every speaker. */
+        bool isEmpty() const;
+
+        /** @brief Returns true if segments with the given speaker handle pass the filter. */
+        bool accepts(int speakerHandle) const;
+
+        /** @brief Returns true if the segment passes the filter. */
+        bool accepts(const Model::Data::Segment& segment) const;
+
+    private:
+
+        bool active = false;
+        QBitArray speakerMask;
+    };
+
+    /**
+     * @brief Substring matcher with the pattern folded once per query.
+     *
+     * For insensitive queries the segment side uses the folded shadow text
+     * cached in each Segment, so matching becomes a plain case-sensitive scan.
+     * With useShadowCache = false the segment text is folded on the fly and
+     * segments are never written to (safe for background threads).
+     *
+     * Compact segments (see Segment::compact()) are searched on their bytes
+     * when the query allows it, so they are neither decoded nor folded.
+     */
+    class TextMatcher {
+
+    public:
+
+        TextMatcher(const QString& pattern,
+                    Qt::CaseSensitivity cs,
+                    bool accentInsensitive = false,
+                    bool useShadowCache = true);
+
+        /** @brief Returns true if the pattern is empty (matches everything). */
+        bool isEmpty() const;
+
+        /** @brief Returns true if the segment text contains the pattern. */
+        bool matches(const Model::Data::Segment& segment) const;
+
+        /**
+         * @brief Returns true if matches(QStringView) needs no folding pass.
+         *
+         * True for case-sensitive and plain case-insensitive queries; accent
+         * folding is better served by the per-segment shadow cache.
+         */
+        bool supportsViews() const;
+
+        /** @brief Returns true if text contains the pattern (see supportsViews()). */
+        bool matches(QStringView text) const;
+
+    private:
+
+        /**
+         * @brief Matches a compact segment on its bytes.
+         *
+         * @return false if the query needs the decoded text; otherwise true
+         *         with the result in outMatches.
+         */
+        bool matchesCompact(const Model::Data::Segment& segment, bool& outMatches) const;
+
+        QString rawPattern;
+        QString foldedPattern;
+        Qt::CaseSensitivity caseSensitivity;
+        TextFolding::Options foldOptions;
+        bool useCache;
+
+        // Byte forms of rawPattern for compact segments
+        QByteArray latin1Pattern;
+        QByteArray utf8Pattern;
+        bool patternIsLatin1 = false;
+        bool patternIsAscii = false;
+    };
+
+    /**
+     * @brief Lazy cursor over matching segments.
+     *
+     * next() and previous() scan from the current position and stop at the
+     * first hit, so stepping through results costs the distance to the next
+     * match instead of a full scan. With wrapAround enabled, the scan continues
+     * from the other end of the transcript.
+     */
+    class MatchIterator {
+
+    public:
+
+        MatchIterator(const Model::Data::Transcript& transcript,
+                      const TextMatcher& matcher,
+                      const SpeakerFilter& speakerFilter,
+                      bool wrapAround);
+
+        /** @brief Moves the cursor to index without checking it (-1 = before the first segment). */
+        void seek(int index);
+
+        /** @brief Returns the index the cursor is at. */
+        int position() const;
+
+        /** @brief Advances to the next match and returns its index, or -1 if none. */
+        int next();
+
+        /** @brief Steps back to the previous match and returns its index, or -1 if none. */
+        int previous();
+
+    private:
+
+        /** @brief Returns true if the segment at index passes speaker and text checks. */
+        bool matchesAt(int index) const;
+
+        const Model::Data::Transcript& iterTranscript;
+        TextMatcher iterMatcher;
+        SpeakerFilter iterFilter;
+        bool iterWrapAround;
+        int iterPosition = -1;
+    };
+
     /** @brief Constructs a search helper bound to a given Transcript. */
     explicit TranscriptSearch(const Model::Data::Transcript& transcript);
 
     /** @brief Returns the bound transcript. */
     const Model::Data::Transcript& transcript() const;
 
+    /**
+     * @brief Enables accent-insensitive matching ("cafe" finds "café").
+     *
+     * Applies to every text query of this helper, on top of the per-call
+     * case sensitivity. Disabled by default.
+     */
+    void setAccentInsensitive(bool enabled);
+
+    /** @brief Returns true if accent-insensitive matching is enabled. */
+    bool isAccentInsensitive() const;
+
+    /**
+     * @brief Scans segment texts through store when possible (nullptr disables it).
+     *
+     * Only used while the store is in sync with the bound transcript and the
+     * query needs no accent folding. The caller keeps ownership.
+     */
+    void setSegmentStore(const Model::Data::SegmentStore* store);
+
+    /**
+     * @brief Returns the folded shadow text of a segment for the given options.
+     *
+     * Built on first use and cached in the segment until its text changes
+     * (see Segment::invalidateCaches()). Must only be called on the thread
+     * that owns the transcript.
+     */
+    static const QString& shadowText(const Model::Data::Segment& segment,
+                                     TextFolding::Options options);
+
     /**
      * @brief Finds all segments whose text contains the given pattern.
      *
@@ -49,7 +221,7 @@ public:
     /**
      * @brief Finds all segments spoken by the given speaker.
      *
-     * speakerID should match the Segment::speakerID exactly.
+     * speakerID should match a Speaker::id exactly.
      */
     QVector<int> findBySpeaker(const QString& speakerID) const;
 
@@ -74,9 +246,24 @@ public:
                                        const QString& pattern,
                                        Qt::CaseSensitivity cs = Qt::CaseInsensitive) const;
 
+    /**
+     * @brief Creates a lazy match cursor positioned before the first segment.
+     *
+     * An empty pattern matches every segment that passes the speaker filter.
+     */
+    MatchIterator matches(const QString& pattern,
+                          const QStringList& speakerIDs,
+                          Qt::CaseSensitivity cs = Qt::CaseInsensitive,
+                          bool wrapAround = false) const;
+
 private:
 
+    /** @brief Returns the store to scan for matcher, or nullptr to use segments. */
+    const Model::Data::SegmentStore* storeFor(const TextMatcher& matcher) const;
+
     const Model::Data::Transcript& searchTranscript;
+    const Model::Data::SegmentStore* searchStore = nullptr;
+    bool searchAccentInsensitive = false;
 };
 
 }
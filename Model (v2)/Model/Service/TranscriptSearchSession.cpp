@@ -0,0 +1,226 @@
+#include "TranscriptSearchSession.h"
+
+namespace Model {
+namespace Service {
+
+using Model::Data::Transcript;
+using Model::Data::Segment;
+
+TranscriptSearchSession::TranscriptSearchSession(int maxCachedQueries)
+    : maxCached(qMax(1, maxCachedQueries))
+{}
+
+QVector<int> TranscriptSearchSession::search(const Transcript& transcript,
+                                             const QString& pattern,
+                                             const QStringList& speakerFilter,
+                                             Qt::CaseSensitivity cs,
+                                             bool accentInsensitive) {
+
+    if (pattern.isEmpty())
+        return {};
+
+    if (boundTranscript != &transcript
+        || boundCaseSensitivity != cs
+        || boundAccentInsensitive != accentInsensitive
+        || boundSpeakerFilter != speakerFilter) {
+        reset();
+        boundTranscript = &transcript;
+        boundSpeakerFilter = speakerFilter;
+        boundSpeakerSet = TranscriptSearch::SpeakerFilter(transcript, speakerFilter);
+        boundSpeakerCount = transcript.speakers.size();
+        boundCaseSensitivity = cs;
+        boundAccentInsensitive = accentInsensitive;
+    }
+    else {
+        refreshSpeakerFilter(transcript);
+    }
+
+    // Containment between patterns is only meaningful in folded form
+    const QString foldedPattern =
+        TextFolding::fold(pattern, TextFolding::optionsFor(cs, accentInsensitive));
+
+    // 1) Same pattern as before (e.g. user deleted a character back to it)
+    const int exact = findExact(foldedPattern);
+    if (exact >= 0) {
+        CachedQuery hit = cachedQueries.takeAt(exact);
+        cachedQueries.append(hit);
+        return hit.matches;
+    }
+
+    QVector<int> matches;
+    QVector<int> candidates;
+    bool haveCandidates = false;
+
+    // 2) Pattern extends a cached one: only its matches can still match
+    const int ancestor = findAncestor(foldedPattern);
+    if (ancestor >= 0) {
+        candidates = cachedQueries[ancestor].matches;
+        haveCandidates = true;
+    }
+    // 3) Otherwise let the trigram index narrow down the scan
+    else if (trigramIndex && trigramIndex->isBuilt()) {
+        haveCandidates = trigramIndex->candidatesForLiteral(pattern, candidates);
+    }
+
+    if (haveCandidates) {
+        const auto& segments = transcript.segments;
+        const TranscriptSearch::TextMatcher matcher = matcherFor(pattern);
+        matches.reserve(candidates.size());
+
+        for (int ind : candidates) {
+            if (segmentMatches(segments[ind], matcher))
+                matches.push_back(ind);
+        }
+    }
+    // 4) Nothing reusable: full scan
+    else {
+        TranscriptSearch fullSearch(transcript);
+        fullSearch.setAccentInsensitive(accentInsensitive);
+        fullSearch.setSegmentStore(segmentStore);
+        matches = speakerFilter.isEmpty()
+                      ? fullSearch.findSegmentsContaining(pattern, cs)
+                      : fullSearch.findBySpeakersAndText(speakerFilter, pattern, cs);
+    }
+
+    remember(pattern, foldedPattern, matches);
+    return matches;
+}
+
+void TranscriptSearchSession::segmentsReplaced(const Transcript& transcript,
+                                               int first,
+                                               int removedCount,
+                                               int insertedCount) {
+
+    if (cachedQueries.isEmpty())
+        return;
+
+    if (boundTranscript != &transcript || first < 0) {
+        reset();
+        return;
+    }
+
+    // The edit may have introduced a speaker named in the filter
+    refreshSpeakerFilter(transcript);
+
+    const int removedEnd = first + removedCount;
+    const int delta = insertedCount - removedCount;
+    const auto& segments = transcript.segments;
+
+    for (CachedQuery& query : cachedQueries) {
+
+        const TranscriptSearch::TextMatcher matcher = matcherFor(query.pattern);
+
+        QVector<int> patched;
+        patched.reserve(query.matches.size() + insertedCount);
+
+        int i = 0;
+        const int count = query.matches.size();
+
+        // Untouched head
+        while (i < count && query.matches[i] < first)
+            patched.push_back(query.matches[i++]);
+
+        // Re-check only the replacement segments
+        for (int ind = first; ind < first + insertedCount; ++ind) {
+            if (segmentMatches(segments[ind], matcher))
+                patched.push_back(ind);
+        }
+
+        // Skip removed matches, shift the tail
+        while (i < count && query.matches[i] < removedEnd)
+            ++i;
+        while (i < count)
+            patched.push_back(query.matches[i++] + delta);
+
+        query.matches = patched;
+    }
+}
+
+void TranscriptSearchSession::setTrigramIndex(const TrigramIndex* index) {
+
+    trigramIndex = index;
+}
+
+void TranscriptSearchSession::setSegmentStore(const Model::Data::SegmentStore* store) {
+
+    segmentStore = store;
+}
+
+void TranscriptSearchSession::reset() {
+
+    cachedQueries.clear();
+    boundTranscript = nullptr;
+    boundSpeakerFilter.clear();
+    boundSpeakerSet = TranscriptSearch::SpeakerFilter();
+    boundSpeakerCount = 0;
+    boundCaseSensitivity = Qt::CaseInsensitive;
+    boundAccentInsensitive = false;
+}
+
+int TranscriptSearchSession::cachedQueryCount() const {
+
+    return cachedQueries.size();
+}
+
+
+// === Private helpers ===
+
+void TranscriptSearchSession::refreshSpeakerFilter(const Transcript& transcript) {
+
+    if (boundSpeakerCount == transcript.speakers.size())
+        return;
+
+    boundSpeakerSet = TranscriptSearch::SpeakerFilter(transcript, boundSpeakerFilter);
+    boundSpeakerCount = transcript.speakers.size();
+}
+
+TranscriptSearch::TextMatcher TranscriptSearchSession::matcherFor(const QString& pattern) const {
+
+    return TranscriptSearch::TextMatcher(pattern, boundCaseSensitivity, boundAccentInsensitive);
+}
+
+bool TranscriptSearchSession::segmentMatches(const Segment& segment,
+                                             const TranscriptSearch::TextMatcher& matcher) const {
+
+    if (!boundSpeakerSet.accepts(segment))
+        return false;
+
+    return matcher.matches(segment);
+}
+
+int TranscriptSearchSession::findExact(const QString& foldedPattern) const {
+
+    for (int i = cachedQueries.size() - 1; i >= 0; --i) {
+        if (cachedQueries[i].foldedPattern == foldedPattern)
+            return i;
+    }
+    return -1;
+}
+
+int TranscriptSearchSession::findAncestor(const QString& foldedPattern) const {
+
+    // Any cached pattern contained in the new one is a valid ancestor;
+    // pick the one with the fewest matches to re-check.
+    int best = -1;
+    for (int i = 0; i < cachedQueries.size(); ++i) {
+        const CachedQuery& query = cachedQueries[i];
+        if (!foldedPattern.contains(query.foldedPattern, Qt::CaseSensitive))
+            continue;
+        if (best < 0 || query.matches.size() < cachedQueries[best].matches.size())
+            best = i;
+    }
+    return best;
+}
+
+void TranscriptSearchSession::remember(const QString& pattern,
+                                       const QString& foldedPattern,
+                                       const QVector<int>& matches) {
+
+    while (cachedQueries.size() >= maxCached)
+        cachedQueries.removeFirst();
+
+    cachedQueries.append({ pattern, foldedPattern, matches });
+}
+
+}
+}
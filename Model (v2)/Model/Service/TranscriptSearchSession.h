@@ -0,0 +1,125 @@
+#ifndef MODEL_SERVICE_TRANSCRIPT_SEARCH_SESSION_H
+#define MODEL_SERVICE_TRANSCRIPT_SEARCH_SESSION_H
+
+#include "Model/Data/Transcript.h"
+#include "Model/Service/TranscriptSearch.h"
+#include "Model/Service/TrigramIndex.h"
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+namespace Model {
+namespace Service {
+
+/**
+ * @brief Stateful search-as-you-type helper that reuses previous result sets.
+ *
+ * Keeps a small cache of recent queries for one transcript. When the new
+ * pattern contains a cached pattern (e.g. "tran" -> "trans"), only the
+ * segments matched by that cached query are re-checked. When the pattern
+ * shrinks back to a cached one, its results are returned directly.
+ *
+ * Edits do not drop the cache: segmentsReplaced() patches every cached result
+ * set for the replaced range only.
+ */
+
+class TranscriptSearchSession {
+
+public:
+
+    /** @brief Constructs a session keeping at most maxCachedQueries result sets. */
+    explicit TranscriptSearchSession(int maxCachedQueries = 32);
+
+    /**
+     * @brief Finds all segments matching pattern and speakerFilter.
+     *
+     * Same semantics as TranscriptSearch::findBySpeakersAndText(), but served
+     * from the cache whenever possible. Changing the transcript, the speaker
+     * filter, the case sensitivity or accent sensitivity starts a fresh cache.
+     */
+    QVector<int> search(const Model::Data::Transcript& transcript,
+                        const QString& pattern,
+                        const QStringList& speakerFilter,
+                        Qt::CaseSensitivity cs = Qt::CaseInsensitive,
+                        bool accentInsensitive = false);
+
+    /**
+     * @brief Patches cached results after an edit.
+     *
+     * Segments [first, first + removedCount) were replaced by
+     * [first, first + insertedCount) in the current state of transcript.
+     * Only the inserted segments are re-checked; the others are shifted.
+     */
+    void segmentsReplaced(const Model::Data::Transcript& transcript,
+                          int first,
+                          int removedCount,
+                          int insertedCount);
+
+    /**
+     * @brief Uses index to narrow down full scans (nullptr disables it).
+     *
+     * The caller keeps ownership and must keep the index in sync with the
+     * searched transcript.
+     */
+    void setTrigramIndex(const TrigramIndex* index);
+
+    /**
+     * @brief Lets full scans read texts from store (nullptr disables it).
+     *
+     * Same ownership rules as setTrigramIndex().
+     */
+    void setSegmentStore(const Model::Data::SegmentStore* store);
+
+    /** @brief Drops every cached result set. */
+    void reset();
+
+    /** @brief Returns the number of cached queries. */
+    int cachedQueryCount() const;
+
+private:
+
+    struct CachedQuery {
+        QString pattern;
+        QString foldedPattern;
+        QVector<int> matches;
+    };
+
+    /** @brief Rebuilds the speaker filter if speakers were added or removed. */
+    void refreshSpeakerFilter(const Model::Data::Transcript& transcript);
+
+    /** @brief Returns a matcher for pattern using the bound search settings. */
+    TranscriptSearch::TextMatcher matcherFor(const QString& pattern) const;
+
+    /** @brief Returns true if the segment passes the speaker filter and the matcher. */
+    bool segmentMatches(const Model::Data::Segment& segment,
+                        const TranscriptSearch::TextMatcher& matcher) const;
+
+    /** @brief Returns the index of the cached query with the same folded pattern, or -1. */
+    int findExact(const QString& foldedPattern) const;
+
+    /** @brief Returns the index of the narrowest cached query contained in foldedPattern, or -1. */
+    int findAncestor(const QString& foldedPattern) const;
+
+    /** @brief Adds a result set, evicting the least recently used entry if needed. */
+    void remember(const QString& pattern, const QString& foldedPattern, const QVector<int>& matches);
+
+    const Model::Data::Transcript* boundTranscript = nullptr;
+    QStringList boundSpeakerFilter;
+    TranscriptSearch::SpeakerFilter boundSpeakerSet;
+    int boundSpeakerCount = 0;
+    Qt::CaseSensitivity boundCaseSensitivity = Qt::CaseInsensitive;
+    bool boundAccentInsensitive = false;
+
+    const TrigramIndex* trigramIndex = nullptr;
+    const Model::Data::SegmentStore* segmentStore = nullptr;
+
+    // Least recently used first
+    QVector<CachedQuery> cachedQueries;
+    int maxCached = 32;
+};
+
+}
+}
+
+#endif // MODEL_SERVICE_TRANSCRIPT_SEARCH_SESSION_H
@@ -0,0 +1,371 @@
+#include "TrigramIndex.h"
+#include "Model/Service/TextFolding.h"
+
+#include <algorithm>
+
+namespace Model {
+namespace Service {
+
+using Model::Data::Transcript;
+using Model::Data::Segment;
+
+namespace {
+
+// Folding used for both indexed text and queries; the widest one keeps
+// candidates a superset of the matches for every search option.
+const TextFolding::Options IndexFolding =
+    TextFolding::CaseFold | TextFolding::StripAccents | TextFolding::CompatibilityNormalize;
+
+quint64 trigramKey(QChar a, QChar b, QChar c) {
+
+    return (quint64(a.unicode()) << 32) | (quint64(b.unicode()) << 16) | quint64(c.unicode());
+}
+
+}
+
+void TrigramIndex::build(const Transcript& transcript) {
+
+    clear();
+
+    const auto& segments = transcript.segments;
+    slotAtPosition.reserve(segments.size());
+    slotTrigrams.reserve(segments.size());
+
+    for (const Segment& seg : segments)
+        slotAtPosition.push_back(addSlot(seg.text()));
+
+    built = true;
+    positionsDirty = true;
+}
+
+void TrigramIndex::clear() {
+
+    built = false;
+    slotAtPosition.clear();
+    slotTrigrams.clear();
+    freeSlots.clear();
+    postings.clear();
+    pendingSlots.clear();
+    positionOfSlot.clear();
+    positionsDirty = true;
+}
+
+bool TrigramIndex::isBuilt() const {
+
+    return built;
+}
+
+void TrigramIndex::segmentsReplaced(const Transcript& transcript,
+                                    int first,
+                                    int removedCount,
+                                    int insertedCount) {
+
+    if (!built)
+        return;
+
+    const auto& segments = transcript.segments;
+
+    if (first < 0 || first + removedCount > slotAtPosition.size()) {
+        build(transcript);
+        return;
+    }
+
+    for (int pos = first; pos < first + removedCount; ++pos)
+        removeSlot(slotAtPosition[pos]);
+    slotAtPosition.remove(first, removedCount);
+
+    slotAtPosition.insert(first, insertedCount, -1);
+    for (int k = 0; k < insertedCount; ++k) {
+        const Segment& seg = segments[first + k];
+
+        // Re-folding a long text on every keystroke would cost its whole length
+        if (seg.isPieceBacked()) {
+            const int slot = addSlot(QString());
+            pendingSlots.insert(slot);
+            slotAtPosition[first + k] = slot;
+        }
+        else {
+            slotAtPosition[first + k] = addSlot(seg.text());
+        }
+    }
+
+    // Guard against a change range that does not match the transcript
+    if (slotAtPosition.size() != segments.size())
+        build(transcript);
+}
+
+void TrigramIndex::refresh(const Transcript& transcript) {
+
+    if (!built || pendingSlots.isEmpty())
+        return;
+
+    const auto& segments = transcript.segments;
+    if (slotAtPosition.size() != segments.size()) {
+        build(transcript);
+        return;
+    }
+
+    refreshPositions();
+
+    for (int slot : std::as_const(pendingSlots)) {
+        slotTrigrams[slot] = trigramsOf(segments[positionOfSlot[slot]].text());
+        for (quint64 key : slotTrigrams[slot])
+            postings[key].insert(slot);
+    }
+    pendingSlots.clear();
+}
+
+bool TrigramIndex::candidatesForLiteral(const QString& pattern, QVector<int>& outCandidates) const {
+
+    return candidatesForTrigrams(trigramsOf(pattern), outCandidates);
+}
+
+bool TrigramIndex::candidatesForRegex(const QString& regexPattern, QVector<int>& outCandidates) const {
+
+    QVector<quint64> required;
+    for (const QString& literal : requiredLiterals(regexPattern))
+        required += trigramsOf(literal);
+
+    std::sort(required.begin(), required.end());
+    required.erase(std::unique(required.begin(), required.end()), required.end());
+
+    return candidatesForTrigrams(required, outCandidates);
+}
+
+QStringList TrigramIndex::requiredLiterals(const QString& regexPattern) {
+
+    const int n = regexPattern.size();
+
+    // An alternation anywhere makes every literal optional
+    for (int i = 0; i < n; ++i) {
+        if (regexPattern.at(i) == QLatin1Char('\\'))
+            ++i;
+        else if (regexPattern.at(i) == QLatin1Char('|'))
+            return {};
+    }
+
+    QStringList literals;
+    QString run;
+    int depth = 0;
+
+    auto endRun = [&]() {
+        if (run.size() >= 3)
+            literals << run;
+        run.clear();
+    };
+
+    auto skipQuantifierSuffix = [&](int& i) {
+        // Lazy ("*?") and possessive ("*+") modifiers
+        if (i + 1 < n && (regexPattern.at(i + 1) == QLatin1Char('?')
+                          || regexPattern.at(i + 1) == QLatin1Char('+')))
+            ++i;
+    };
+
+    for (int i = 0; i < n; ++i) {
+        const QChar c = regexPattern.at(i);
+
+        if (c == QLatin1Char('\\')) {
+            if (i + 1 >= n)
+                break;
+            const QChar escaped = regexPattern.at(++i);
+            // "\." is a literal dot; "\w", "\b", "\d"... are classes or assertions.
+            // Any other letter or digit starts a longer escape ("\x41", "\012", "\p{L}",
+            // "\Q...\E") whose text is not tracked here, so fall back to a full scan
+            if (escaped.isLetterOrNumber()) {
+                if (!QStringLiteral("dDwWsShHvVbBAzZGRXK").contains(escaped))
+                    return {};
+                endRun();
+            } else if (depth == 0) {
+                run.append(escaped);
+            } else {
+                endRun();
+            }
+            continue;
+        }
+
+        if (c == QLatin1Char('[')) {
+            endRun();
+            int j = i + 1;
+            if (j < n && regexPattern.at(j) == QLatin1Char('^'))
+                ++j;
+            if (j < n && regexPattern.at(j) == QLatin1Char(']'))
+                ++j;
+            while (j < n && regexPattern.at(j) != QLatin1Char(']')) {
+                if (regexPattern.at(j) == QLatin1Char('\\'))
+                    ++j;
+                ++j;
+            }
+            i = j;
+            continue;
+        }
+
+        if (c == QLatin1Char('(')) {
+            endRun();
+            ++depth;
+            continue;
+        }
+
+        if (c == QLatin1Char(')')) {
+            endRun();
+            depth = qMax(0, depth - 1);
+            continue;
+        }
+
+        if (c == QLatin1Char('*') || c == QLatin1Char('?') || c == QLatin1Char('{')) {
+            // The preceding character may be absent
+            if (!run.isEmpty())
+                run.chop(1);
+            endRun();
+            if (c == QLatin1Char('{')) {
+                while (i < n && regexPattern.at(i) != QLatin1Char('}'))
+                    ++i;
+            }
+            skipQuantifierSuffix(i);
+            continue;
+        }
+
+        if (c == QLatin1Char('+')) {
+            // The preceding character is required, but what follows is not adjacent to it
+            endRun();
+            skipQuantifierSuffix(i);
+            continue;
+        }
+
+        if (c == QLatin1Char('.') || c == QLatin1Char('^') || c == QLatin1Char('$')) {
+            endRun();
+            continue;
+        }
+
+        // Group contents may be optional or repeated; ignore them
+        if (depth > 0)
+            continue;
+
+        run.append(c);
+    }
+
+    endRun();
+    return literals;
+}
+
+
+// === Private helpers ===
+
+QVector<quint64> TrigramIndex::trigramsOf(const QString& text) {
+
+    QVector<quint64> keys;
+
+    const QString folded = TextFolding::fold(text, IndexFolding);
+    if (folded.size() < 3)
+        return keys;
+
+    keys.reserve(folded.size() - 2);
+    for (int i = 0; i + 2 < folded.size(); ++i)
+        keys.push_back(trigramKey(folded.at(i), folded.at(i + 1), folded.at(i + 2)));
+
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    return keys;
+}
+
+bool TrigramIndex::candidatesForTrigrams(const QVector<quint64>& required,
+                                         QVector<int>& outCandidates) const {
+
+    outCandidates.clear();
+
+    if (!built || required.isEmpty())
+        return false;
+
+    refreshPositions();
+
+    // Unknown content: may match
+    for (int slot : pendingSlots) {
+        const int pos = positionOfSlot[slot];
+        if (pos >= 0)
+            outCandidates.push_back(pos);
+    }
+
+    // Start from the rarest trigram, then check the others per slot
+    const QSet<int>* smallest = nullptr;
+    for (quint64 key : required) {
+        auto it = postings.constFind(key);
+        if (it == postings.constEnd()) {
+            // No indexed segment holds this trigram
+            std::sort(outCandidates.begin(), outCandidates.end());
+            return true;
+        }
+        if (!smallest || it.value().size() < smallest->size())
+            smallest = &it.value();
+    }
+
+    for (int slot : *smallest) {
+        const QVector<quint64>& present = slotTrigrams[slot];
+
+        bool hasAll = true;
+        for (quint64 key : required) {
+            if (!std::binary_search(present.begin(), present.end(), key)) {
+                hasAll = false;
+                break;
+            }
+        }
+
+        if (hasAll) {
+            const int pos = positionOfSlot[slot];
+            if (pos >= 0)
+                outCandidates.push_back(pos);
+        }
+    }
+
+    std::sort(outCandidates.begin(), outCandidates.end());
+    return true;
+}
+
+int TrigramIndex::addSlot(const QString& text) {
+
+    int slot = -1;
+    if (freeSlots.isEmpty()) {
+        slot = slotTrigrams.size();
+        slotTrigrams.push_back(QVector<quint64>());
+    }
+    else {
+        slot = freeSlots.takeLast();
+    }
+
+    slotTrigrams[slot] = trigramsOf(text);
+    for (quint64 key : slotTrigrams[slot])
+        postings[key].insert(slot);
+
+    positionsDirty = true;
+    return slot;
+}
+
+void TrigramIndex::removeSlot(int slot) {
+
+    for (quint64 key : slotTrigrams[slot]) {
+        auto it = postings.find(key);
+        if (it == postings.end())
+            continue;
+        it.value().remove(slot);
+        if (it.value().isEmpty())
+            postings.erase(it);
+    }
+
+    slotTrigrams[slot].clear();
+    pendingSlots.remove(slot);
+    freeSlots.push_back(slot);
+    positionsDirty = true;
+}
+
+void TrigramIndex::refreshPositions() const {
+
+    if (!positionsDirty)
+        return;
+
+    positionOfSlot.fill(-1, slotTrigrams.size());
+    for (int pos = 0; pos < slotAtPosition.size(); ++pos)
+        positionOfSlot[slotAtPosition[pos]] = pos;
+
+    positionsDirty = false;
+}
+
+}
+}
@@ -0,0 +1,118 @@
+#ifndef MODEL_SERVICE_TRIGRAM_INDEX_H
+#define MODEL_SERVICE_TRIGRAM_INDEX_H
+
+#include "Model/Data/Transcript.h"
+
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+namespace Model {
+namespace Service {
+
+/**
+ * @brief Trigram index over the segments of one transcript.
+ *
+ * Maps every three-character sequence of the folded segment text (case
+ * folded, accents stripped, NFKC) to the segments containing it. A literal or
+ * regex query is turned into a set of required trigrams, and only segments
+ * holding all of them need to be checked by the real matcher.
+ *
+ * The index is a pure pre-filter: candidates are a superset of the matches.
+ * It is kept up to date incrementally through segmentsReplaced(). Edited
+ * piece-backed segments are not re-indexed on every keystroke: they stay
+ * pending (always candidates) until refresh().
+ */
+
+class TrigramIndex {
+
+public:
+
+    /** @brief Constructs an empty, unbuilt index. */
+    TrigramIndex() = default;
+
+    /** @brief Indexes every segment of transcript, replacing previous content. */
+    void build(const Model::Data::Transcript& transcript);
+
+    /** @brief Drops all indexed data. */
+    void clear();
+
+    /** @brief Returns true if build() has been called since the last clear(). */
+    bool isBuilt() const;
+
+    /**
+     * @brief Re-indexes a replaced segment range.
+     *
+     * Segments [first, first + removedCount) were replaced by
+     * [first, first + insertedCount) in the current state of transcript.
+     */
+    void segmentsReplaced(const Model::Data::Transcript& transcript,
+                          int first,
+                          int removedCount,
+                          int insertedCount);
+
+    /** @brief Indexes the segments left pending by segmentsReplaced(). */
+    void refresh(const Model::Data::Transcript& transcript);
+
+    /**
+     * @brief Computes candidate segments for a literal substring query.
+     *
+     * @return false if the pattern is too short to be narrowed down (the
+     *         caller must scan everything); otherwise true with the sorted
+     *         candidate indices in outCandidates.
+     */
+    bool candidatesForLiteral(const QString& pattern, QVector<int>& outCandidates) const;
+
+    /**
+     * @brief Computes candidate segments for a regular expression.
+     *
+     * Same contract as candidatesForLiteral(), using the literals that every
+     * match of the expression must contain (see requiredLiterals()).
+     */
+    bool candidatesForRegex(const QString& regexPattern, QVector<int>& outCandidates) const;
+
+    /**
+     * @brief Extracts literal runs that every match of regexPattern contains.
+     *
+     * Conservative: alternations, groups, classes and optional characters end
+     * a run or are skipped. Returns an empty list if nothing can be required.
+     */
+    static QStringList requiredLiterals(const QString& regexPattern);
+
+private:
+
+    /** @brief Returns the sorted, unique trigram keys of text after folding. */
+    static QVector<quint64> trigramsOf(const QString& text);
+
+    /** @brief Returns candidates for a set of required trigram keys (see candidatesForLiteral()). */
+    bool candidatesForTrigrams(const QVector<quint64>& required, QVector<int>& outCandidates) const;
+
+    /** @brief Indexes text into a fresh slot and returns it. */
+    int addSlot(const QString& text);
+
+    /** @brief Removes a slot's trigrams from the postings and frees it. */
+    void removeSlot(int slot);
+
+    /** @brief Rebuilds positionOfSlot after structural edits. */
+    void refreshPositions() const;
+
+    bool built = false;
+
+    // Segments are indexed by "slot" so that inserts/removes only touch the
+    // position <-> slot mapping instead of every posting list.
+    QVector<int> slotAtPosition;
+    QVector<QVector<quint64>> slotTrigrams;
+    QVector<int> freeSlots;
+    QHash<quint64, QSet<int>> postings;
+    QSet<int> pendingSlots;   // Not indexed yet; candidates for every query
+
+    mutable QVector<int> positionOfSlot;
+    mutable bool positionsDirty = true;
+};
+
+}
+}
+
+#endif // MODEL_SERVICE_TRIGRAM_INDEX_H
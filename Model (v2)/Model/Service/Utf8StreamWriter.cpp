@@ -0,0 +1,60 @@
+#include "Utf8StreamWriter.h"
+
+namespace Model {
+namespace Service {
+
+Utf8StreamWriter::Utf8StreamWriter(QIODevice* device, ContentHash* hasher)
+    : device(device),
+    hasher(hasher),
+    // Stateless: nothing is carried over from one write() to the next
+    encoder(QStringConverter::Utf8, QStringConverter::Flag::Stateless),
+    buffer(BufferSize, Qt::Uninitialized)
+{}
+
+bool Utf8StreamWriter::write(QStringView text) {
+
+    while (!text.isEmpty() && !failed) {
+
+        // UTF-8 takes at most 3 bytes per UTF-16 code unit
+        qsizetype take = qMin(text.size(), (BufferSize - used) / 3);
+
+        // Keep surrogate pairs in one piece, or each half would become U+FFFD
+        if (take > 0 && take < text.size() && text.at(take - 1).isHighSurrogate())
+            --take;
+
+        if (take == 0) {
+            flush();
+            continue;
+        }
+
+        char* end = encoder.appendToBuffer(buffer.data() + used, text.first(take));
+        used = end - buffer.data();
+        text = text.sliced(take);
+    }
+
+    return !failed;
+}
+
+bool Utf8StreamWriter::flush() {
+
+    if (used == 0 || failed)
+        return !failed;
+
+    if (hasher)
+        hasher->addData(buffer.constData(), used);
+
+    if (device && device->write(buffer.constData(), used) != used)
+        failed = true;
+
+    total += used;
+    used = 0;
+    return !failed;
+}
+
+qint64 Utf8StreamWriter::bytesWritten() const {
+
+    return total;
+}
+
+}
+}
@@ -0,0 +1,67 @@
+#ifndef MODEL_SERVICE_UTF8_STREAM_WRITER_H
+#define MODEL_SERVICE_UTF8_STREAM_WRITER_H
+
+#include "ContentHash.h"
+
+#include <QByteArray>
+#include <QIODevice>
+#include <QStringEncoder>
+#include <QStringView>
+
+namespace Model {
+namespace Service {
+
+/**
+ * @brief Encodes text to UTF-8 through a fixed-size buffer.
+ *
+ * Text passed to write() is encoded straight into the buffer, which is
+ * handed to the device (and/or a ContentHash) whenever it is full and on
+ * flush(). Extra memory stays at BufferSize however much is written,
+ * instead of a temporary QByteArray per string.
+ *
+ * Each write() is encoded on its own, like QString::toUtf8(), so the output
+ * is byte-for-byte the concatenation of the toUtf8() of every piece (even
+ * around unpaired surrogates).
+ */
+
+class Utf8StreamWriter {
+
+public:
+
+    /** @brief Size of the encoding buffer in bytes. */
+    static constexpr qsizetype BufferSize = 64 * 1024;
+
+    /**
+     * @brief Constructs a writer.
+     *
+     * @param device Receives the encoded bytes; may be null (hash only).
+     * @param hasher Receives the encoded bytes as well; may be null.
+     */
+    explicit Utf8StreamWriter(QIODevice* device, ContentHash* hasher = nullptr);
+
+    /** @brief Encodes text; returns false once writing to the device failed. */
+    bool write(QStringView text);
+
+    /** @brief Passes buffered bytes on; returns false if any write failed. Call before closing the device. */
+    bool flush();
+
+    /** @brief Returns the number of bytes passed on so far. */
+    qint64 bytesWritten() const;
+
+private:
+
+    QIODevice* device = nullptr;
+    ContentHash* hasher = nullptr;
+
+    QStringEncoder encoder;
+    QByteArray buffer;
+    qsizetype used = 0;
+
+    qint64 total = 0;
+    bool failed = false;
+};
+
+}
+}
+
+#endif // MODEL_SERVICE_UTF8_STREAM_WRITER_H
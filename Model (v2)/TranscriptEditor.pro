@@ -1,21 +1,36 @@
 QT += core gui widgets
-greaterThan(QT_MAJOR_VERSION, 4): QT += widgets multimedia multimediawidgets
+greaterThan(QT_MAJOR_VERSION, 4): QT += widgets multimedia multimediawidgets sql
 
 CONFIG += c++17
 CONFIG += gui
 
 HEADERS += \
     Controller/AppController.h \
+    Controller/SaveWorker.h \
+    Controller/SearchWorker.h \
+    Model/Data/PieceTable.h \
     Model/Data/Segment.h \
+    Model/Data/SegmentIdMap.h \
+    Model/Data/SegmentList.h \
+    Model/Data/SegmentStore.h \
     Model/Data/Speaker.h \
     Model/Data/Transcript.h \
+    Model/Data/TranscriptVersion.h \
     Model/Service/TranscriptEditor.h \
     Model/Service/TranscriptEditorAlt.h \
     Model/Service/TranscriptExporter.h \
     Model/Service/TranscriptImporter.h \
     Model/Service/TranscriptManager.h \
     Model/Service/TranscriptParser.h \
+    Model/Service/ContentHash.h \
+    Model/Service/Utf8StreamWriter.h \
+    Model/Service/TranscriptBundle.h \
+    Model/Service/TranscriptDatabase.h \
+    Model/Service/EditLog.h \
+    Model/Service/TextFolding.h \
+    Model/Service/TrigramIndex.h \
     Model/Service/TranscriptSearch.h \
+    Model/Service/TranscriptSearchSession.h \
     View/AppMainWindow.h \
     View/Widgets/TranscriptEditorWidget.h \
     View/Widgets/TranscriptViewerWidget.h \
@@ -24,16 +39,31 @@ HEADERS += \
 
 SOURCES += \
     Controller/AppController.cpp \
+    Controller/SaveWorker.cpp \
+    Controller/SearchWorker.cpp \
+    Model/Data/PieceTable.cpp \
     Model/Data/Segment.cpp \
+    Model/Data/SegmentIdMap.cpp \
+    Model/Data/SegmentList.cpp \
+    Model/Data/SegmentStore.cpp \
     Model/Data/Speaker.cpp \
     Model/Data/Transcript.cpp \
+    Model/Data/TranscriptVersion.cpp \
     Model/Service/TranscriptEditor.cpp \
     Model/Service/TranscriptEditorAlt.cpp \
     Model/Service/TranscriptExporter.cpp \
     Model/Service/TranscriptImporter.cpp \
     Model/Service/TranscriptManager.cpp \
     Model/Service/TranscriptParser.cpp \
+    Model/Service/ContentHash.cpp \
+    Model/Service/Utf8StreamWriter.cpp \
+    Model/Service/TranscriptBundle.cpp \
+    Model/Service/TranscriptDatabase.cpp \
+    Model/Service/EditLog.cpp \
+    Model/Service/TextFolding.cpp \
+    Model/Service/TrigramIndex.cpp \
     Model/Service/TranscriptSearch.cpp \
+    Model/Service/TranscriptSearchSession.cpp \
     View/AppMainWindow.cpp \
     View/Widgets/TranscriptEditorWidget.cpp \
     View/Widgets/TranscriptViewerWidget.cpp \
@@ -2,6 +2,7 @@
 
 #include "View/Widgets/TranscriptViewerWidget.h"
 #include "View/Widgets/TranscriptEditorWidget.h"
+#include "Model/Service/TranscriptBundle.h"
 
 #include <QHBoxLayout>
 #include <QVBoxLayout>
@@ -64,16 +65,25 @@ void AppMainWindow::setupMenus() {
 
     actionChooseRootDirectory = new QAction(QIcon(":/icons/icons/actionSetRootDirectory.png"), "Choose &Directory", this);
     actionReload = new QAction(QIcon(":/icons/icons/actionReloadAll.png"), "&Reload All", this);
+    actionWatchRoot = new QAction("&Watch Directory", this);
     actionImport = new QAction(QIcon(":/icons/icons/actionImport.png"), "&Import Transcript", this);
     actionSaveCurrent = new QAction(QIcon(":/icons/icons/actionSaveCurrent.png"), "&Save Transcript", this);
     actionSaveAll = new QAction(QIcon(":/icons/icons/actionSaveAll.png"), "Save &All Transcripts", this);
+    actionExportBundle = new QAction("Export as &Bundle...", this);
+    actionExportFolder = new QAction("Export to &Folder...", this);
+    actionOpenDatabase = new QAction("Open Data&base...", this);
     actionExit = new QAction(QIcon(":/icons/icons/actionExit.png"), "E&xit", this);
 
     actionChooseRootDirectory->setToolTip(tr("Select root directory for transcript folders"));
     actionReload->setToolTip(tr("Reload all transcripts from root directory"));
+    actionWatchRoot->setToolTip(tr("Pick up transcripts added, removed or changed in the root directory"));
+    actionWatchRoot->setCheckable(true);
     actionImport->setToolTip(tr("Import new transcript"));
     actionSaveCurrent->setToolTip(tr("Save current transcript to file"));
     actionSaveAll->setToolTip(tr("Save all transcripts to file"));
+    actionExportBundle->setToolTip(tr("Save current transcript, with its audio, as a single bundle file"));
+    actionExportFolder->setToolTip(tr("Write current transcript as a transcript folder"));
+    actionOpenDatabase->setToolTip(tr("Store transcripts in a database file and load them from it"));
     actionExit->setToolTip(tr("Close application"));
 
     actionChooseRootDirectory->setShortcut(QKeySequence(Qt::CTRL | Qt::Key_O));
@@ -81,18 +91,26 @@ void AppMainWindow::setupMenus() {
 
     connect(actionChooseRootDirectory, &QAction::triggered, this, &AppMainWindow::onChooseRootDirectory);
     connect(actionReload, &QAction::triggered, this, &AppMainWindow::onReloadTranscripts);
+    connect(actionWatchRoot, &QAction::toggled, this, &AppMainWindow::onWatchRootToggled);
     connect(actionImport, &QAction::triggered, this, &AppMainWindow::onImportTranscript);
     connect(actionSaveCurrent, &QAction::triggered, this, &AppMainWindow::onSaveCurrent);
     connect(actionSaveAll, &QAction::triggered, this, &AppMainWindow::onSaveAll);
+    connect(actionExportBundle, &QAction::triggered, this, &AppMainWindow::onExportBundle);
+    connect(actionExportFolder, &QAction::triggered, this, &AppMainWindow::onExportFolder);
+    connect(actionOpenDatabase, &QAction::triggered, this, &AppMainWindow::onOpenDatabase);
     connect(actionExit, &QAction::triggered, this, &AppMainWindow::onExitRequested);
 
     fileMenu->addAction(actionChooseRootDirectory);
     fileMenu->addAction(actionReload);
+    fileMenu->addAction(actionWatchRoot);
+    fileMenu->addAction(actionOpenDatabase);
     fileMenu->addSeparator();
     fileMenu->addAction(actionImport);
     fileMenu->addSeparator();
     fileMenu->addAction(actionSaveCurrent);
     fileMenu->addAction(actionSaveAll);
+    fileMenu->addAction(actionExportBundle);
+    fileMenu->addAction(actionExportFolder);
     fileMenu->addSeparator();
 
     // Edit menu actions
@@ -349,6 +367,9 @@ void AppMainWindow::setupStatusBar() {
     statusBar = new QStatusBar(this);
     setStatusBar(statusBar);
 
+    unsavedStatusLabel = new QLabel(this);
+    statusBar->addPermanentWidget(unsavedStatusLabel);
+
     audioStatusLabel = new QLabel(tr("Audio: stopped"), this);
     statusBar->addPermanentWidget(audioStatusLabel);
 }
@@ -364,6 +385,12 @@ void AppMainWindow::connectControllerSignals() {
             this, &AppMainWindow::onErrorOccurred);
     connect(controller, &Controller::AppController::transcriptsReloaded,
             this, &AppMainWindow::onTranscriptsReloaded);
+    connect(controller, &Controller::AppController::transcriptAdded,
+            this, &AppMainWindow::onTranscriptAdded);
+    connect(controller, &Controller::AppController::transcriptRemoved,
+            this, &AppMainWindow::onTranscriptRemoved);
+    connect(controller, &Controller::AppController::transcriptReloaded,
+            this, &AppMainWindow::onTranscriptReloaded);
     connect(controller, &Controller::AppController::currentTranscriptChanged,
             this, &AppMainWindow::onCurrentTranscriptChanged);
     connect(controller, &Controller::AppController::transcriptContentChanged,
@@ -377,6 +404,15 @@ void AppMainWindow::connectControllerSignals() {
     connect(controller, &Controller::AppController::undoRedoAvailabilityChanged,
             this, &AppMainWindow::onUndoRedoAvailabilityChanged);
 
+    // Unsaved transcripts
+    connect(controller, &Controller::AppController::dirtyCountChanged,
+            this, &AppMainWindow::onDirtyCountChanged);
+    onDirtyCountChanged(controller->dirtyTranscriptCount());
+    connect(controller, &Controller::AppController::transcriptsRecovered,
+            this, &AppMainWindow::onTranscriptsRecovered);
+    connect(controller, &Controller::AppController::bundleExported,
+            this, &AppMainWindow::onBundleExported);
+
     // Audio
     connect(controller, &Controller::AppController::audioPositionChanged,
             this, &AppMainWindow::onAudioPositionChanged);
@@ -396,6 +432,8 @@ void AppMainWindow::connectControllerSignals() {
     if (transcriptEditor) {
         connect(controller, &Controller::AppController::currentTranscriptChanged,
                 transcriptEditor, &Widgets::TranscriptEditorWidget::setTranscript);
+        connect(controller, &Controller::AppController::segmentsReplaced,
+                transcriptEditor, &Widgets::TranscriptEditorWidget::onSegmentsReplaced);
         connect(controller, &Controller::AppController::transcriptContentChanged,
                 transcriptEditor, &Widgets::TranscriptEditorWidget::onTranscriptContentChanged);
     }
@@ -442,6 +480,23 @@ void AppMainWindow::onReloadTranscripts() {
     }
 }
 
+void AppMainWindow::onWatchRootToggled(bool checked) {
+
+    if (!controller) {
+        if (statusBar) statusBar->showMessage(tr("Controller not yet initialized!"), 4000);
+        return;
+    }
+
+    controller->setWatchRoot(checked);
+
+    // Catch up with what changed while nothing was watched
+    if (checked) {
+        QString err;
+        if (!controller->rescanRoot(&err) && statusBar)
+            statusBar->showMessage(err, 4000);
+    }
+}
+
 void AppMainWindow::onImportTranscript() {
 
     if (!controller) {
@@ -518,6 +573,92 @@ void AppMainWindow::onSaveAll() {
     controller->requestSaveAll();
 }
 
+void AppMainWindow::onExportBundle() {
+
+    if (!controller) {
+        if (statusBar) statusBar->showMessage(tr("Controller not yet initialized!"), 4000);
+        return;
+    }
+
+    const Model::Data::Transcript* t = controller->currentTranscript();
+    if (!t)
+        return;
+
+    const QString suffix = QLatin1String(Model::Service::TranscriptBundle::Suffix);
+    const QString suggested = QDir(controller->rootDirectory()).filePath(t->title + QLatin1Char('.') + suffix);
+
+    QString path = QFileDialog::getSaveFileName(this,
+                                                tr("Export Transcript Bundle"),
+                                                suggested,
+                                                tr("Transcript bundles (*.%1)").arg(suffix));
+    if (path.isEmpty())
+        return;
+
+    if (!Model::Service::TranscriptBundle::isBundlePath(path))
+        path += QLatin1Char('.') + suffix;
+
+    controller->requestExportBundle(path);
+}
+
+void AppMainWindow::onBundleExported(const QString& bundlePath) {
+
+    if (statusBar)
+        statusBar->showMessage(tr("Bundle written: %1").arg(bundlePath), 4000);
+}
+
+void AppMainWindow::onExportFolder() {
+
+    if (!controller) {
+        if (statusBar) statusBar->showMessage(tr("Controller not yet initialized!"), 4000);
+        return;
+    }
+
+    const Model::Data::Transcript* t = controller->currentTranscript();
+    if (!t)
+        return;
+
+    const QString parent = QFileDialog::getExistingDirectory(
+        this, tr("Select folder to export into"),
+        controller->rootDirectory(), QFileDialog::ShowDirsOnly | QFileDialog::DontResolveSymlinks);
+
+    if (parent.isEmpty())
+        return;
+
+    const QString folder = QDir(parent).filePath(t->title.isEmpty() ? t->id : t->title);
+
+    // Failures are reported through errorOccurred()
+    if (controller->requestExportToFolder(folder) && statusBar)
+        statusBar->showMessage(tr("Transcript folder written: %1").arg(folder), 4000);
+}
+
+void AppMainWindow::onOpenDatabase() {
+
+    if (!controller) {
+        if (statusBar) statusBar->showMessage(tr("Controller not yet initialized!"), 4000);
+        return;
+    }
+
+    const QString suggested = QDir(controller->rootDirectory()).filePath(QStringLiteral("transcripts.sqlite"));
+
+    const QString path = QFileDialog::getSaveFileName(this,
+                                                      tr("Open Transcript Database"),
+                                                      suggested,
+                                                      tr("SQLite databases (*.sqlite *.db)"),
+                                                      nullptr,
+                                                      QFileDialog::DontConfirmOverwrite);
+    if (path.isEmpty())
+        return;
+
+    QString err;
+    if (!controller->openDatabase(path, &err)) {
+        QMessageBox::warning(this, tr("Error opening database"), err);
+        return;
+    }
+
+    if (statusBar)
+        statusBar->showMessage(tr("Transcripts stored in %1").arg(path), 4000);
+}
+
 void AppMainWindow::onExitRequested() {
 
     close();
@@ -557,6 +698,35 @@ void AppMainWindow::onTranscriptsReloaded() {
     syncCurrentIndexSpin();
 }
 
+void AppMainWindow::onTranscriptAdded(int index) {
+
+    if (!controller)
+        return;
+
+    const Model::Data::Transcript* t = controller->transcriptAt(index);
+    auto* item = new QListWidgetItem(t ? t->title : QString());
+    transcriptList->insertItem(index, item);
+    renumberTranscriptItems(index);
+    syncCurrentIndexSpin();
+}
+
+void AppMainWindow::onTranscriptRemoved(int index) {
+
+    delete transcriptList->takeItem(index);
+    renumberTranscriptItems(index);
+    syncCurrentIndexSpin();
+}
+
+void AppMainWindow::onTranscriptReloaded(int index) {
+
+    if (!controller)
+        return;
+
+    const Model::Data::Transcript* t = controller->transcriptAt(index);
+    if (QListWidgetItem* item = transcriptList->item(index); item && t)
+        item->setText(t->title);
+}
+
 void AppMainWindow::onCurrentTranscriptChanged(Model::Data::Transcript* transcript) {
 
     syncCurrentIndexSpin();
@@ -715,6 +885,21 @@ void AppMainWindow::onUndoRedoAvailabilityChanged(bool canUndo, bool canRedo) {
     actionRedo->setEnabled(canRedo);
 }
 
+void AppMainWindow::onDirtyCountChanged(int count) {
+
+    // Save All only writes dirty transcripts, so there is nothing to do at 0
+    actionSaveAll->setEnabled(count > 0);
+
+    if (unsavedStatusLabel)
+        unsavedStatusLabel->setText(count > 0 ? tr("Unsaved: %1").arg(count) : QString());
+}
+
+void AppMainWindow::onTranscriptsRecovered(const QStringList& titles) {
+
+    if (statusBar)
+        statusBar->showMessage(tr("Recovered unsaved edits: %1").arg(titles.join(QStringLiteral(", "))), 8000);
+}
+
 void AppMainWindow::onAudioPositionChanged(qint64 positionMs, qint64 durationMs) {
 
     updateAudioStatus(positionMs, durationMs);
@@ -766,6 +951,13 @@ void AppMainWindow::refreshTranscriptList() {
     }
 }
 
+void AppMainWindow::renumberTranscriptItems(int fromRow) {
+
+    // Items carry their transcript index; rows after an insert or removal moved
+    for (int row = qMax(0, fromRow); row < transcriptList->count(); ++row)
+        transcriptList->item(row)->setData(Qt::UserRole, row);
+}
+
 void AppMainWindow::syncSelectionToController() {
 
     // Placeholder for future use (e.g. syncing list/spinbox to controller)
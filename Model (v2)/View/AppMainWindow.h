@@ -54,9 +54,13 @@ private slots:
     // === File / root directory ===
     void onChooseRootDirectory();
     void onReloadTranscripts();
+    void onWatchRootToggled(bool checked);
     void onImportTranscript();
     void onSaveCurrent();
     void onSaveAll();
+    void onExportBundle();
+    void onExportFolder();
+    void onOpenDatabase();
     void onExitRequested();
 
     // === Selection & updates ===
@@ -64,6 +68,9 @@ private slots:
     void onCurrentIndexSpinChanged(int value);
 
     void onTranscriptsReloaded();
+    void onTranscriptAdded(int index);
+    void onTranscriptRemoved(int index);
+    void onTranscriptReloaded(int index);
     void onCurrentTranscriptChanged(Model::Data::Transcript* transcript);
     void onTranscriptContentChanged(Model::Data::Transcript* transcript);
 
@@ -83,6 +90,9 @@ private slots:
     void onSaveCompleted(Model::Data::Transcript* transcript);
     void onImportCompleted(int newIndex, Model::Data::Transcript* transcript);
     void onUndoRedoAvailabilityChanged(bool canUndo, bool canRedo);
+    void onDirtyCountChanged(int count);
+    void onTranscriptsRecovered(const QStringList& titles);
+    void onBundleExported(const QString& bundlePath);
     void onAudioPositionChanged(qint64 positionMs, qint64 durationMs);
     void onAudioPlaybackStateChanged(QMediaPlayer::PlaybackState state);
 
@@ -117,6 +127,7 @@ private:
 
     // === UI helpers ===
     void refreshTranscriptList();
+    void renumberTranscriptItems(int fromRow);
     void syncSelectionToController();
     void syncCurrentIndexSpin();
     void updateWindowTitleForCurrentTranscript();
@@ -166,9 +177,13 @@ private:
     // Actions
     QAction* actionChooseRootDirectory = nullptr;
     QAction* actionReload = nullptr;
+    QAction* actionWatchRoot = nullptr;
     QAction* actionImport = nullptr;
     QAction* actionSaveCurrent = nullptr;
     QAction* actionSaveAll = nullptr;
+    QAction* actionExportBundle = nullptr;
+    QAction* actionExportFolder = nullptr;
+    QAction* actionOpenDatabase = nullptr;
     QAction* actionExit = nullptr;
 
     QAction* actionUndo = nullptr;
@@ -198,6 +213,7 @@ private:
     // Status bar elements
     QStatusBar* statusBar = nullptr;
     QLabel* audioStatusLabel = nullptr;
+    QLabel* unsavedStatusLabel = nullptr;
     QSlider* audioSlider = nullptr;    
 };
 
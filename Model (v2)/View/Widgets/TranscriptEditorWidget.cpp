@@ -82,14 +82,24 @@ void TranscriptEditorWidget::onTranscriptContentChanged(Transcript* transcript)
     const int modelCount = editorTranscript->segments.size();
     const int rowCount = rows.size();
 
-    // If segment count changed (split, merge, insert, delete),
-    // rebuild the rows.
+    // If segment count changed (split, merge, insert, delete) without
+    // onSegmentsReplaced() patching the rows, rebuild them.
     if (modelCount != rowCount) {
         reloadSpeakerList();
         rebuildView();
         return;
     }
 
+    // Same count but different segments (e.g. undo of a delete + insert)
+    for (int i = 0; i < modelCount; ++i) {
+        const EditableSegmentRowWidget* row = rows.value(i);
+        if (!row || row->segmentID() != editorTranscript->segments.at(i).id) {
+            reloadSpeakerList();
+            rebuildView();
+            return;
+        }
+    }
+
     // Same number of segments: most likely pure text edits or
     // things like replace/rename. Our row widgets already show
     // the user-edited text, so we avoid rebuilding to preserve
@@ -105,7 +115,7 @@ void TranscriptEditorWidget::onTranscriptContentChanged(Transcript* transcript)
         if (it == rows.end() || !it.value())
             continue;
 
-        const QString speakerID = editorTranscript->segments.at(i).speakerID;
+        const QString speakerID = editorTranscript->speakerIDOf(editorTranscript->segments.at(i));
         const QColor c = colorForSpeaker(speakerID);
         it.value()->setSpeakerID(speakerID);
         it.value()->setSpeakerColor(c);
@@ -113,6 +123,88 @@ void TranscriptEditorWidget::onTranscriptContentChanged(Transcript* transcript)
 }
 
 
+void TranscriptEditorWidget::onSegmentsReplaced(Transcript* transcript,
+                                                int first,
+                                                int removedCount,
+                                                int insertedCount) {
+
+    if (transcript != editorTranscript || !editorTranscript || !editorLayout)
+        return;
+
+    const int rowCount = rows.size();
+    const int modelCount = editorTranscript->segments.size();
+
+    // Rows out of step with the change: let onTranscriptContentChanged() rebuild
+    if (first < 0 || first + removedCount > rowCount
+        || rowCount - removedCount + insertedCount != modelCount)
+        return;
+
+    reloadSpeakerList();
+
+    // Same number of rows (text/speaker edits, moves, swaps): only replace the
+    // rows that now show a different segment.
+    if (removedCount == insertedCount) {
+        for (int i = first; i < first + insertedCount; ++i) {
+            EditableSegmentRowWidget* oldRow = rows.value(i);
+            if (oldRow && oldRow->segmentID() == editorTranscript->segments.at(i).id)
+                continue;
+
+            auto* row = createRow(i);
+            if (oldRow) {
+                delete editorLayout->replaceWidget(oldRow, row);
+                oldRow->deleteLater();
+            }
+            else {
+                editorLayout->insertWidget(i, row);
+            }
+            rows.insert(i, row);
+        }
+        updateRowHighlights();
+        return;
+    }
+
+    // Structural change: drop the removed rows...
+    for (int i = first; i < first + removedCount; ++i) {
+        if (EditableSegmentRowWidget* row = rows.take(i)) {
+            editorLayout->removeWidget(row);
+            row->deleteLater();
+        }
+    }
+
+    // ...renumber the rows behind them...
+    const int delta = insertedCount - removedCount;
+    if (delta > 0) {
+        for (int i = rowCount - 1; i >= first + removedCount; --i) {
+            EditableSegmentRowWidget* row = rows.take(i);
+            if (row)
+                row->setSegmentIndex(i + delta);
+            rows.insert(i + delta, row);
+        }
+    }
+    else {
+        for (int i = first + removedCount; i < rowCount; ++i) {
+            EditableSegmentRowWidget* row = rows.take(i);
+            if (row)
+                row->setSegmentIndex(i + delta);
+            rows.insert(i + delta, row);
+        }
+    }
+
+    // ...and create the inserted ones (layout positions match segment indices)
+    for (int i = first; i < first + insertedCount; ++i) {
+        auto* row = createRow(i);
+        editorLayout->insertWidget(i, row);
+        rows.insert(i, row);
+    }
+
+    if (currentSegmentIndex >= first + removedCount)
+        currentSegmentIndex += delta;
+    else if (currentSegmentIndex >= first)
+        currentSegmentIndex = qMin(first, modelCount - 1);
+
+    updateRowHighlights();
+}
+
 void TranscriptEditorWidget::scrollToSegment(int segmentIndex) {
 
     auto it = rows.find(segmentIndex);
@@ -315,33 +407,7 @@ void TranscriptEditorWidget::rebuildView() {
     const int count = editorTranscript->segments.size();
 
     for (int i = 0; i < count; ++i) {
-        const auto& seg = editorTranscript->segments.at(i);
-        const QString speakerID = seg.speakerID;
-
-        auto* row = new EditableSegmentRowWidget(
-            i,
-            speakers,
-            speakerID,
-            seg.text,
-            baseFontPointSize,
-            editorContainer);
-
-        const QColor speakerColor = colorForSpeaker(speakerID);
-        row->setSpeakerColor(speakerColor);
-
-        connect(row, &EditableSegmentRowWidget::textEdited,
-                this, &TranscriptEditorWidget::handleRowTextEdited);
-        connect(row, &EditableSegmentRowWidget::speakerChanged,
-                this, &TranscriptEditorWidget::handleRowSpeakerChanged);
-        connect(row, &EditableSegmentRowWidget::splitRequested,
-                this, &TranscriptEditorWidget::handleRowSplitRequested);
-        connect(row, &EditableSegmentRowWidget::deleteRequested,
-                this, &TranscriptEditorWidget::handleRowDeleteRequested);
-        connect(row, &EditableSegmentRowWidget::insertBelowRequested,
-                this, &TranscriptEditorWidget::handleRowInsertBelowRequested);
-        connect(row, &EditableSegmentRowWidget::rowClicked,
-                this, &TranscriptEditorWidget::handleRowClicked);
-
+        auto* row = createRow(i);
         editorLayout->addWidget(row);
         rows.insert(i, row);
     }
@@ -350,6 +416,51 @@ void TranscriptEditorWidget::rebuildView() {
     updateRowHighlights();
 }
 
+EditableSegmentRowWidget* TranscriptEditorWidget::createRow(int index) {
+
+    const auto& seg = editorTranscript->segments.at(index);
+    const QString speakerID = editorTranscript->speakerIDOf(seg);
+
+    auto* row = new EditableSegmentRowWidget(
+        index,
+        speakers,
+        speakerID,
+        seg.text(),
+        baseFontPointSize,
+        editorContainer);
+
+    row->setSegmentID(seg.id);
+
+    const QColor speakerColor = colorForSpeaker(speakerID);
+    row->setSpeakerColor(speakerColor);
+
+    connect(row, &EditableSegmentRowWidget::textEdited,
+            this, &TranscriptEditorWidget::handleRowTextEdited);
+    connect(row, &EditableSegmentRowWidget::textSpliced,
+            this, &TranscriptEditorWidget::handleRowTextSpliced);
+    connect(row, &EditableSegmentRowWidget::speakerChanged,
+            this, &TranscriptEditorWidget::handleRowSpeakerChanged);
+    connect(row, &EditableSegmentRowWidget::splitRequested,
+            this, &TranscriptEditorWidget::handleRowSplitRequested);
+    connect(row, &EditableSegmentRowWidget::deleteRequested,
+            this, &TranscriptEditorWidget::handleRowDeleteRequested);
+    connect(row, &EditableSegmentRowWidget::insertBelowRequested,
+            this, &TranscriptEditorWidget::handleRowInsertBelowRequested);
+    connect(row, &EditableSegmentRowWidget::rowClicked,
+            this, &TranscriptEditorWidget::handleRowClicked);
+
+    return row;
+}
+
+quint64 TranscriptEditorWidget::segmentIDForRow(int segmentIndex) const {
+
+    const auto it = rows.constFind(segmentIndex);
+    if (it == rows.constEnd() || !it.value())
+        return 0;
+
+    return it.value()->segmentID();
+}
+
 
 // === Row-level slots ===
 
@@ -359,7 +470,20 @@ void TranscriptEditorWidget::handleRowTextEdited(int segmentIndex, const QString
         return;
 
     setCurrentSegmentIndex(segmentIndex, false);
-    controller->requestSetSegmentText(segmentIndex, newText);
+    controller->requestSetSegmentTextByID(segmentIDForRow(segmentIndex), newText);
+}
+
+void TranscriptEditorWidget::handleRowTextSpliced(int segmentIndex,
+                                                  int position,
+                                                  int charsRemoved,
+                                                  const QString& insertedText) {
+
+    if (!controller)
+        return;
+
+    setCurrentSegmentIndex(segmentIndex, false);
+    controller->requestSpliceSegmentTextByID(segmentIDForRow(segmentIndex),
+                                             position, charsRemoved, insertedText);
 }
 
 void TranscriptEditorWidget::handleRowSpeakerChanged(int segmentIndex, const QString& newSpeakerID) {
@@ -368,7 +492,7 @@ void TranscriptEditorWidget::handleRowSpeakerChanged(int segmentIndex, const QSt
         return;
 
     setCurrentSegmentIndex(segmentIndex, false);
-    controller->requestChangeSegmentSpeaker(segmentIndex, newSpeakerID);
+    controller->requestChangeSegmentSpeakerByID(segmentIDForRow(segmentIndex), newSpeakerID);
 
     // Update row color to match new speaker
     auto it = rows.find(segmentIndex);
@@ -426,18 +550,17 @@ void TranscriptEditorWidget::handleRowSplitRequested(int segmentIndex, int curso
 
     setCurrentSegmentIndex(segmentIndex, false);
 
-    // Use a new helper on AppController (see below)
-    controller->requestSplitSegmentWithSpeakers(
-        segmentIndex, cursorPosition, speakerFirst, speakerSecond);
+    // By ID: the modal dialog may have outlived edits that moved this row
+    controller->requestSplitSegmentWithSpeakersByID(
+        segmentIDForRow(segmentIndex), cursorPosition, speakerFirst, speakerSecond);
 }
 
 void TranscriptEditorWidget::handleRowDeleteRequested(int segmentIndex) {
 
     if (!controller)
         return;
-    controller->requestDeleteSegment(segmentIndex);
-    // After deletion, segment indices shift; we'll get a contentChanged signal
-    // and rebuild, so we don't try to manually adjust row indices here.
+    controller->requestDeleteSegmentByID(segmentIDForRow(segmentIndex));
+    // Row indices behind it are renumbered by onSegmentsReplaced().
 }
 
 void TranscriptEditorWidget::handleRowInsertBelowRequested(int segmentIndex)
@@ -471,7 +594,7 @@ void TranscriptEditorWidget::requestMergeCurrentWithNext()
         return; // no "next" to merge
 
     controller->requestMergeWithNext(currentSegmentIndex);
-    // After contentChanged, rebuildView() runs and highlight will remain on the same index.
+    // onSegmentsReplaced() then swaps the two rows for the merged one.
 }
 
 
@@ -57,6 +57,18 @@ public Q_SLOTS:
     /** @brief Rebuild the rows if the given transcript is the one being edited. */
     void onTranscriptContentChanged(Model::Data::Transcript* transcript);
 
+    /**
+     * @brief Patch the rows of a replaced segment range in place.
+     *
+     * Rows whose segment kept its ID are left alone (focus and cursor stay);
+     * only removed/inserted rows are destroyed/created and later rows are
+     * renumbered.
+     */
+    void onSegmentsReplaced(Model::Data::Transcript* transcript,
+                            int first,
+                            int removedCount,
+                            int insertedCount);
+
     /** @brief Scroll to the given segment index. */
     void scrollToSegment(int segmentIndex);
 
@@ -127,6 +139,8 @@ private Q_SLOTS:
 
     /** @brief Handle row text edits and forward them to the AppController. */
     void handleRowTextEdited(int segmentIndex, const QString& newText);
+    /** @brief Handle an incremental text edit of a long segment and forward it to the AppController. */
+    void handleRowTextSpliced(int segmentIndex, int position, int charsRemoved, const QString& insertedText);
     /** @brief Handle row speaker changes and forward them to the AppController. */
     void handleRowSpeakerChanged(int segmentIndex, const QString& newSpeakerID);
     /** @brief Handle a split request coming from a row widget. */
@@ -144,6 +158,10 @@ private:
 
     /** @brief Clear and rebuild all row widgets from the current transcript. */
     void rebuildView();
+    /** @brief Create and connect the row widget for the segment at index (not added to the layout). */
+    Utility::EditableSegmentRowWidget* createRow(int index);
+    /** @brief Returns the stable segment ID shown by the row at segmentIndex, or 0. */
+    quint64 segmentIDForRow(int segmentIndex) const;
     /** @brief Delete all existing row widgets and clear the layout. */
     void clearRows();
     /** @brief Reload the list of available speakers from the controller. */
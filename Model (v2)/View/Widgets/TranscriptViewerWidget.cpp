@@ -167,17 +167,18 @@ void TranscriptViewerWidget::rebuildView() {
     for (int i = 0; i < viewerTranscript->segments.size(); ++i) {
         const Segment& seg = viewerTranscript->segments.at(i);
 
-        // Resolve speaker display name
-        QString speakerText = seg.speakerID;
-        if (!seg.speakerID.isEmpty()) {
-            const Speaker* sp = viewerTranscript->speakerFromID(seg.speakerID);
-            if (sp && !sp->displayName.isEmpty())
-                speakerText = sp->displayName;
+        // Resolve speaker display name (the handle indexes speakers directly)
+        const QString& speakerID = viewerTranscript->speakerIDOf(seg);
+        QString speakerText = speakerID;
+        if (!speakerID.isEmpty()) {
+            const Speaker& sp = viewerTranscript->speakers.at(seg.speaker);
+            if (!sp.displayName.isEmpty())
+                speakerText = sp.displayName;
         }
 
-        const QColor speakerColor = colorForSpeaker(seg.speakerID);
+        const QColor speakerColor = colorForSpeaker(speakerID);
 
-        auto* row = new SegmentRowWidget(i, speakerText, seg.text,
+        auto* row = new SegmentRowWidget(i, speakerText, seg.text(),
             speakerColor, baseFontPointSize, viewerContainer);
 
         connect(row, &SegmentRowWidget::clicked,
@@ -1,10 +1,13 @@
 #include "EditableSegmentRowWidget.h"
+#include "Model/Data/Segment.h"
 
 #include <QHBoxLayout>
 #include <QVBoxLayout>
 #include <QMouseEvent>
 #include <QFont>
 #include <QPalette>
+#include <QTextCursor>
+#include <QTextDocument>
 
 namespace View {
 namespace Widgets {
@@ -74,6 +77,7 @@ EditableSegmentRowWidget::EditableSegmentRowWidget(int segmentIndex,
     // Right: text editor
     textEdit = new QPlainTextEdit(this);
     textEdit->setPlainText(text);
+    lastTextLength = plainTextLength();
     applyBaseFontSize(basePointSize);
     updateMinimumHeightForText();
 
@@ -81,6 +85,8 @@ EditableSegmentRowWidget::EditableSegmentRowWidget(int segmentIndex,
     mainLayout->addWidget(textEdit, 1);
 
     // Connections
+    connect(textEdit->document(), &QTextDocument::contentsChange,
+            this, &EditableSegmentRowWidget::handleContentsChange);
     connect(textEdit, &QPlainTextEdit::textChanged,
             this, &EditableSegmentRowWidget::handleTextChanged);
     connect(speakerCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
@@ -106,6 +112,16 @@ void EditableSegmentRowWidget::setSegmentIndex(int index) {
     rowSegmentIndex = index;
 }
 
+quint64 EditableSegmentRowWidget::segmentID() const {
+
+    return rowSegmentID;
+}
+
+void EditableSegmentRowWidget::setSegmentID(quint64 id) {
+
+    rowSegmentID = id;
+}
+
 QString EditableSegmentRowWidget::speakerID() const {
 
     return speakerCombo ? speakerCombo->currentText() : QString();
@@ -230,12 +246,53 @@ void EditableSegmentRowWidget::mousePressEvent(QMouseEvent* event) {
 
 
 
+void EditableSegmentRowWidget::handleContentsChange(int position, int charsRemoved, int charsAdded) {
+
+    pendingSplicePosition = position;
+    pendingSpliceRemoved = charsRemoved;
+    pendingSpliceAdded = charsAdded;
+    ++pendingSpliceCount;
+}
+
 void EditableSegmentRowWidget::handleTextChanged() {
 
     updateMinimumHeightForText();
+
+    const int previousLength = lastTextLength;
+    const int newLength = plainTextLength();
+    const bool singleSplice = pendingSpliceCount == 1;
+    pendingSpliceCount = 0;
+    lastTextLength = newLength;
+
+    // Long texts: send only the changed range. The document sometimes reports
+    // ranges past the end (e.g. the final block separator); fall back then.
+    if (singleSplice
+        && newLength >= Model::Data::Segment::PieceTableThreshold
+        && pendingSplicePosition >= 0
+        && pendingSplicePosition + pendingSpliceRemoved <= previousLength
+        && pendingSplicePosition + pendingSpliceAdded <= newLength
+        && previousLength - pendingSpliceRemoved + pendingSpliceAdded == newLength) {
+
+        QTextCursor cursor(textEdit->document());
+        cursor.setPosition(pendingSplicePosition);
+        cursor.setPosition(pendingSplicePosition + pendingSpliceAdded, QTextCursor::KeepAnchor);
+
+        QString inserted = cursor.selectedText();
+        inserted.replace(QChar::ParagraphSeparator, QLatin1Char('\n'));
+
+        emit textSpliced(rowSegmentIndex, pendingSplicePosition, pendingSpliceRemoved, inserted);
+        return;
+    }
+
     emit textEdited(rowSegmentIndex, text());
 }
 
+int EditableSegmentRowWidget::plainTextLength() const {
+
+    // characterCount() includes the final paragraph separator
+    return textEdit ? qMax(0, textEdit->document()->characterCount() - 1) : 0;
+}
+
 void EditableSegmentRowWidget::handleSpeakerChanged(int) {
 
     emit speakerChanged(rowSegmentIndex, speakerID());
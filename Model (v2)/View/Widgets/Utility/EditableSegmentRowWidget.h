@@ -59,6 +59,12 @@ public:
     /** @brief Sets the segment index (used after reordering). */
     void setSegmentIndex(int index);
 
+    /** @brief Returns the stable ID of the segment shown by this row (0 if unset). */
+    quint64 segmentID() const;
+
+    /** @brief Sets the stable ID of the segment shown by this row. */
+    void setSegmentID(quint64 id);
+
     /** @brief Returns the current speaker ID/name. */
     QString speakerID() const;
 
@@ -88,6 +94,14 @@ Q_SIGNALS:
     /** @brief Emitted when the text changes. */
     void textEdited(int segmentIndex, const QString& newText);
 
+    /**
+     * @brief Emitted instead of textEdited() for single edits of long texts.
+     *
+     * Describes the change as a splice so the model does not need the full
+     * text on every keystroke.
+     */
+    void textSpliced(int segmentIndex, int position, int charsRemoved, const QString& insertedText);
+
     /** @brief Emitted when the speaker selection changes. */
     void speakerChanged(int segmentIndex, const QString& newSpeakerID);
 
@@ -115,6 +129,7 @@ protected:
 private Q_SLOTS:
 
     void handleTextChanged();
+    void handleContentsChange(int position, int charsRemoved, int charsAdded);
     void handleSpeakerChanged(int index);
     void handleSplitClicked();
     void handleDeleteClicked();
@@ -130,8 +145,19 @@ private:
 
     void updateMinimumHeightForText();
 
+    /** @brief Returns the document's plain text length. */
+    int plainTextLength() const;
+
     int rowSegmentIndex = -1;
+    quint64 rowSegmentID = 0;
     bool rowIsActive = false;
+
+    // Splice reported by the document since the last textChanged()
+    int pendingSplicePosition = 0;
+    int pendingSpliceRemoved = 0;
+    int pendingSpliceAdded = 0;
+    int pendingSpliceCount = 0;
+    int lastTextLength = 0;
     QColor rowSpeakerColor;
 
     QComboBox* speakerCombo = nullptr;